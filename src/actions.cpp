@@ -5,7 +5,10 @@
 */
 
 // System and library includes
+#include <algorithm>
+#include <wx/filefn.h>
 #include <wx/platinfo.h>
+#include <wx/progdlg.h>
 
 // CB includes
 #include <cbdebugger_interfaces.h>
@@ -18,6 +21,7 @@
 #include "frame.h"
 #include "updated_variable.h"
 #include "definitions.h"
+#include "hex_codec.h"
 
 namespace dbg_mi
 {
@@ -437,16 +441,17 @@ namespace dbg_mi
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     GDBGenerateBacktrace::GDBGenerateBacktrace( GDBSwitchToFrameInvoker * switch_to_frame, GDBBacktraceContainer & backtrace,
-                                                GDBCurrentFrame & current_frame, LogPaneLogger * logger) :
+                                                GDBCurrentFrame & current_frame, BacktraceCache & cache, LogPaneLogger * logger) :
         m_switch_to_frame(switch_to_frame),
         m_backtrace(backtrace),
         m_logger(logger),
         m_current_frame(current_frame),
-        m_first_valid(-1),
+        m_cache(cache),
         m_old_active_frame(-1),
-        m_parsed_backtrace(false),
-        m_parsed_args(false),
-        m_parsed_frame_info(false)
+        m_depth(-1),
+        m_pending(0),
+        m_parse_failed(false),
+        m_reading_rest(false)
     {
     }
 
@@ -455,170 +460,301 @@ namespace dbg_mi
         delete m_switch_to_frame;
     }
 
-    void GDBGenerateBacktrace::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    void GDBGenerateBacktrace::ParseFrames(ResultParser const & result, int level, ListedFrames & frames)
     {
-        if (id == m_backtrace_id)
+        ResultValue const * stack = result.GetResultValue().GetTupleValue("stack");
+
+        if (!stack)
+        {
+            m_parse_failed = true;
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("no stack tuple in the output"), LogPaneLogger::LineType::Error);
+            return;
+        }
+
+        int iCount = stack->GetTupleSize();
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                __LINE__,
+                                wxString::Format(_("tuple size %d %s"), iCount, stack->MakeDebugString()),
+                                LogPaneLogger::LineType::Debug
+                               );
+
+        for (int ii = 0; ii < iCount; ++ii)
         {
-            ResultValue const * stack = result.GetResultValue().GetTupleValue("stack");
+            ResultValue const * frame_value = stack->GetTupleValueByIndex(ii);
+            assert(frame_value);
+            Frame frame;
 
-            if (!stack)
+            if (frame.ParseFrame(*frame_value))
             {
-                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("no stack tuple in the output"), LogPaneLogger::LineType::Error);
+                cbStackFrame s;
+
+                if (frame.HasValidSource())
+                {
+                    s.SetFile(frame.GetFilename(), wxString::Format("%d", frame.GetLine()));
+                }
+                else
+                {
+                    s.SetFile(frame.GetFrom(), wxEmptyString);
+                }
+
+                s.SetSymbol(frame.GetFunction());
+                s.SetNumber(level + ii);
+                s.SetAddress(frame.GetAddress());
+                s.MakeValid(frame.HasValidSource());
+
+                ListedFrame listed;
+                listed.frame = cb::shared_ptr<cbStackFrame>(new cbStackFrame(s));
+                listed.key.address = frame.GetAddress();
+                listed.key.function = static_cast<const char *>(frame.GetFunction().utf8_str());
+                frames.push_back(listed);
             }
             else
             {
-                int iCount = stack->GetTupleSize();
+                // The levels of the frames after it are not known any more, nothing is reused
+                m_parse_failed = true;
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("can't parse frame:==>%s<=="), frame_value->MakeDebugString()), LogPaneLogger::LineType::Debug);
+            }
+        }
+    }
+
+    void GDBGenerateBacktrace::ParseArguments(CommandID const & id, ResultParser const & result, ListedFrames & frames)
+    {
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("arguments"), LogPaneLogger::LineType::Debug);
+        FrameArguments arguments;
+
+        if (!arguments.Attach(result.GetResultValue()))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                    __LINE__,
+                                    wxString::Format(_("can't attach to output of command:==>%s<=="), id.ToString()),
+                                    LogPaneLogger::LineType::Error
+                                   );
+        }
+        else
+            if (arguments.GetCount() != static_cast<int>(frames.size()))
+            {
                 m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
                                         __LINE__,
-                                        wxString::Format(_("tuple size %d %s"), iCount, stack->MakeDebugString()),
-                                        LogPaneLogger::LineType::Debug
+                                        _("stack arg count differ from the number of frames"),
+                                        LogPaneLogger::LineType::Warning
                                        );
-                m_backtrace.clear();
+            }
+            else
+            {
+                int size = arguments.GetCount();
 
-                for (int ii = 0; ii < iCount; ++ii)
+                for (int ii = 0; ii < size; ++ii)
                 {
-                    ResultValue const * frame_value = stack->GetTupleValueByIndex(ii);
-                    assert(frame_value);
-                    Frame frame;
+                    wxString args;
 
-                    if (frame.ParseFrame(*frame_value))
+                    if (arguments.GetFrame(ii, args))
                     {
-                        cbStackFrame s;
-
-                        if (frame.HasValidSource())
-                        {
-                            s.SetFile(frame.GetFilename(), wxString::Format("%d", frame.GetLine()));
-                        }
-                        else
-                        {
-                            s.SetFile(frame.GetFrom(), wxEmptyString);
-                        }
-
-                        s.SetSymbol(frame.GetFunction());
-                        s.SetNumber(ii);
-                        s.SetAddress(frame.GetAddress());
-                        s.MakeValid(frame.HasValidSource());
-
-                        if (s.IsValid() && m_first_valid == -1)
-                        {
-                            m_first_valid = ii;
-                        }
-
-                        m_backtrace.push_back(cb::shared_ptr<cbStackFrame>(new cbStackFrame(s)));
+                        frames[ii].frame->SetSymbol(frames[ii].frame->GetSymbol() + "(" + args + ")");
                     }
                     else
                     {
-                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("can't parse frame:==>%s<=="), frame_value->MakeDebugString()), LogPaneLogger::LineType::Debug);
+                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                                __LINE__,
+                                                wxString::Format(_("can't get args for frame %d"), frames[ii].frame->GetNumber()),
+                                                LogPaneLogger::LineType::Error
+                                               );
                     }
                 }
             }
+    }
 
-            m_parsed_backtrace = true;
+    void GDBGenerateBacktrace::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        if (id == m_backtrace_id)
+        {
+            ParseFrames(result, 0, m_prefix);
         }
         else
             if (id == m_args_id)
             {
-                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("arguments"), LogPaneLogger::LineType::Debug);
-                FrameArguments arguments;
-
-                if (!arguments.Attach(result.GetResultValue()))
+                ParseArguments(id, result, m_prefix);
+            }
+            else
+                if (id == m_rest_id)
                 {
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
-                                            __LINE__,
-                                            wxString::Format(_("can't attach to output of command:==>%s<=="), id.ToString()),
-                                            LogPaneLogger::LineType::Error
-                                           );
+                    ParseFrames(result, m_reuse.readFrom, m_rest);
                 }
                 else
-                    if (arguments.GetCount() != static_cast<int>(m_backtrace.size()))
+                    if (id == m_rest_args_id)
                     {
-                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
-                                                __LINE__,
-                                                _("stack arg count differ from the number of frames"),
-                                                LogPaneLogger::LineType::Warning
-                                               );
+                        ParseArguments(id, result, m_rest);
                     }
                     else
-                    {
-                        int size = arguments.GetCount();
-
-                        for (int ii = 0; ii < size; ++ii)
+                        if (id == m_depth_id)
                         {
-                            wxString args;
-
-                            if (arguments.GetFrame(ii, args))
+                            //^done,depth="12"
+                            if ((result.GetResultClass() != ResultParser::ClassDone) || !Lookup(result.GetResultValue(), "depth", m_depth))
+                            {
+                                m_depth = -1;
+                                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not get the stack depth, the backtrace is listed again"), LogPaneLogger::LineType::Debug);
+                            }
+                        }
+                        else
+                            if (id == m_frame_info_id)
                             {
-                                m_backtrace[ii]->SetSymbol(m_backtrace[ii]->GetSymbol() + "(" + args + ")");
+                                //^done,frame={level="0",addr="0x0000000000401060",func="main",
+                                //file="/path/main.cpp",fullname="/path/main.cpp",line="80"}
+                                if (result.GetResultClass() != ResultParser::ClassDone)
+                                {
+                                    m_old_active_frame = 0;
+                                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Wrong result class, using default value!"), LogPaneLogger::LineType::Debug);
+                                }
+                                else
+                                {
+                                    if (!Lookup(result.GetResultValue(), "frame.level", m_old_active_frame))
+                                    {
+                                        m_old_active_frame = 0;
+                                    }
+                                }
                             }
                             else
                             {
-                                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
-                                                        __LINE__,
-                                                        wxString::Format(_("can't get args for frame %d"), ii),
-                                                        LogPaneLogger::LineType::Error
-                                                       );
+                                return;
                             }
-                        }
-                    }
 
-                m_parsed_args = true;
+        if (--m_pending > 0)
+        {
+            return;
+        }
+
+        if (!m_reading_rest)
+        {
+            ReuseFrames();
+
+            if (m_pending > 0)
+            {
+                return;
             }
-            else
-                if (id == m_frame_info_id)
-                {
-                    m_parsed_frame_info = true;
+        }
 
-                    //^done,frame={level="0",addr="0x0000000000401060",func="main",
-                    //file="/path/main.cpp",fullname="/path/main.cpp",line="80"}
-                    if (result.GetResultClass() != ResultParser::ClassDone)
-                    {
-                        m_old_active_frame = 0;
-                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Wrong result class, using default value!"), LogPaneLogger::LineType::Debug);
-                    }
-                    else
-                    {
-                        if (!Lookup(result.GetResultValue(), "frame.level", m_old_active_frame))
-                        {
-                            m_old_active_frame = 0;
-                        }
-                    }
-                }
+        Done();
+    }
 
-        if (m_parsed_backtrace && m_parsed_args && m_parsed_frame_info)
+    void GDBGenerateBacktrace::ReuseFrames()
+    {
+        int depth = m_depth;
+
+        if (m_parse_failed || (depth < 0))
         {
-            if (!m_backtrace.empty())
-            {
-                int frame = m_current_frame.GetUserSelectedFrame();
+            m_cache.Set(std::vector<BacktraceFrameKey>(), -1);
+            depth = (depth < 0) ? int(BacktraceCache::MaxFrames) : depth;
+        }
 
-                if (frame < 0 && cbDebuggerCommonConfig::GetFlag(cbDebuggerCommonConfig::AutoSwitchFrame))
-                {
-                    frame = m_first_valid;
-                }
+        std::vector<BacktraceFrameKey> prefix;
 
-                if (frame < 0)
-                {
-                    frame = 0;
-                }
+        for (ListedFrames::const_iterator it = m_prefix.begin(); it != m_prefix.end(); ++it)
+        {
+            prefix.push_back(it->key);
+        }
+
+        m_reuse = m_cache.Plan(prefix, depth);
+
+        if (m_reuse.readFrom < m_reuse.readTo)
+        {
+            m_reading_rest = true;
+            m_pending = 2;
+            m_rest_id = Execute(wxString::Format("-stack-list-frames %d %d", m_reuse.readFrom, m_reuse.readTo - 1));
+            m_rest_args_id = Execute(wxString::Format("-stack-list-arguments 1 %d %d", m_reuse.readFrom, m_reuse.readTo - 1));
+        }
+    }
+
+    void GDBGenerateBacktrace::Done()
+    {
+        GDBBacktraceContainer backtrace;
+        std::vector<BacktraceFrameKey> keys;
+
+        for (ListedFrames::const_iterator it = m_prefix.begin(); it != m_prefix.end(); ++it)
+        {
+            backtrace.push_back(it->frame);
+            keys.push_back(it->key);
+        }
+
+        // The old frames with their arguments, only their level changes
+        for (int ii = 0; ii < m_reuse.count; ++ii)
+        {
+            cb::shared_ptr<cbStackFrame> frame = m_backtrace[m_reuse.oldLevel + ii];
+            frame->SetNumber(m_reuse.newLevel + ii);
+            backtrace.push_back(frame);
+            keys.push_back(m_cache.GetFrame(m_reuse.oldLevel + ii));
+        }
+
+        for (ListedFrames::const_iterator it = m_rest.begin(); it != m_rest.end(); ++it)
+        {
+            backtrace.push_back(it->frame);
+            keys.push_back(it->key);
+        }
+
+        m_cache.CountFrames(static_cast<int>(m_prefix.size() + m_rest.size()), m_reuse.count);
+
+        if (m_parse_failed)
+        {
+            keys.clear();
+        }
 
-                m_current_frame.SetFrame(frame);
-                int number = m_backtrace.empty() ? 0 : m_backtrace[frame]->GetNumber();
+        m_cache.Set(keys, m_parse_failed ? -1 : m_depth);
+        m_backtrace.swap(backtrace);
+
+        if (!m_backtrace.empty())
+        {
+            int frame = m_current_frame.GetUserSelectedFrame();
 
-                if (m_old_active_frame != number)
+            if (frame < 0 && cbDebuggerCommonConfig::GetFlag(cbDebuggerCommonConfig::AutoSwitchFrame))
+            {
+                for (size_t ii = 0; ii < m_backtrace.size(); ++ii)
                 {
-                    m_switch_to_frame->Invoke(number);
+                    if (m_backtrace[ii]->IsValid())
+                    {
+                        frame = static_cast<int>(ii);
+                        break;
+                    }
                 }
             }
 
-            Manager::Get()->GetDebuggerManager()->GetBacktraceDialog()->Reload();
-            Finish();
+            if (frame < 0)
+            {
+                frame = 0;
+            }
+
+            m_current_frame.SetFrame(frame);
+            int number = m_backtrace.empty() ? 0 : m_backtrace[frame]->GetNumber();
+
+            if (m_old_active_frame != number)
+            {
+                m_switch_to_frame->Invoke(number);
+            }
         }
+
+        Manager::Get()->GetDebuggerManager()->GetBacktraceDialog()->Reload();
+        Finish();
     }
+
     void GDBGenerateBacktrace::OnStart()
     {
         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "", LogPaneLogger::LineType::Debug);
+
+        // The frames of the previous stop are only reused while they are the ones shown
+        if (m_backtrace.size() != m_cache.GetCount())
+        {
+            m_cache.Set(std::vector<BacktraceFrameKey>(), -1);
+        }
+
+        // Without a previous backtrace everything is listed at once, else the innermost frames and the depth
+        int const count = m_cache.IsEmpty() ? int(BacktraceCache::MaxFrames) : int(BacktraceCache::PrefixFrames);
+        m_reuse.oldLevel = -1;
+        m_reuse.newLevel = 0;
+        m_reuse.count = 0;
+        m_reuse.readFrom = 0;
+        m_reuse.readTo = 0;
+        m_pending = 4;
         m_frame_info_id = Execute("-stack-info-frame");
-        m_backtrace_id = Execute("-stack-list-frames 0 30");
-        m_args_id = Execute("-stack-list-arguments 1 0 30");
+        m_depth_id = Execute(wxString::Format("-stack-info-depth %d", int(BacktraceCache::MaxDepth)));
+        m_backtrace_id = Execute(wxString::Format("-stack-list-frames 0 %d", count - 1));
+        m_args_id = Execute(wxString::Format("-stack-list-arguments 1 0 %d", count - 1));
     }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -721,18 +857,15 @@ namespace dbg_mi
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    GDBGenerateCPUInfoRegisters::GDBGenerateCPUInfoRegisters(LogPaneLogger * logger) :
-        m_bParsedRegisteryNamesReceived(false),
-        m_bParsedRegisteryValuesReceived(false),
+    GDBGenerateCPUInfoRegisters::GDBGenerateCPUInfoRegisters(LogPaneLogger * logger, RegisterCache & cache, bool showVector) :
+        m_cache(cache),
+        m_show_vector(showVector),
         m_logger(logger)
     {
-        m_ParsedRegisteryDataReceived.clear();
     }
 
     void GDBGenerateCPUInfoRegisters::OnCommandOutput(CommandID const & id, ResultParser const & result)
     {
-        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("FUTURE TO BE CODED!!! id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Debug);
-
         //    register-names=
         //    [ "rax","rbx","rcx","rdx","rsi","rdi","rbp","rsp","r8","r9","r10","r11","r12","r13","r14","r15","rip",
         //    "eflags","cs","ss","ds","es","fs","gs","st0","st1","st2","st3","st4","st5","st6","st7","fctrl","fstat",
@@ -749,42 +882,61 @@ namespace dbg_mi
             ResultValue const * registryNames = result.GetResultValue().GetTupleValue("register-names");
             if (registryNames)
             {
-                bool bInsertRegistryData = (m_ParsedRegisteryDataReceived.size() ==  0);
-
+                std::vector<std::string> names;
                 int iCount = registryNames->GetTupleSize();
                 for (int iIndex = 0; iIndex < iCount; iIndex++)
                 {
                     const ResultValue * pRegEntry = registryNames->GetTupleValueByIndex(iIndex);
                     if (pRegEntry)
                     {
-                        wxString registryName = pRegEntry->GetSimpleValue();
-                        if (bInsertRegistryData || (m_ParsedRegisteryDataReceived.find(iIndex) == m_ParsedRegisteryDataReceived.end() ))
-                        {
-                            RegistryData regData;
-                            regData.RegistryName = registryName;
-                            regData.RegistryValue = wxEmptyString;
-                            m_ParsedRegisteryDataReceived.insert(std::make_pair(iIndex, regData));
-                        }
-                        else
-                        {
-                            RegistryData & regData = m_ParsedRegisteryDataReceived[iIndex];
-                            regData.RegistryName = registryName;
-                        }
+                        names.push_back(static_cast<const char *>(pRegEntry->GetSimpleValue().utf8_str()));
                     }
                     else
                     {
+                        // Keep the numbers of the following names
+                        names.push_back(std::string());
                         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the register-name index %d. Received id:%s result: - %s", iIndex, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
                     }
-               }
-                m_bParsedRegisteryNamesReceived= true;
+                }
+
+                m_cache.SetNames(names);
             }
             else
             {
-                m_bParsedRegisteryNamesReceived= false;
                 m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the \"-data-list-register-names\" GDB/MI request. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
             }
         }
 
+        //    changed-registers=["0","1","2","4","5","6","7","8","9","10","11","12","13","14","15","16","17","18","19","20"]
+        if (id == m_reg_changed_list_request_id)
+        {
+            ResultValue const * changedRegisters = result.GetResultValue().GetTupleValue("changed-registers");
+            if (changedRegisters)
+            {
+                std::vector<size_t> numbers;
+                int iCount = changedRegisters->GetTupleSize();
+                for (int iIndex = 0; iIndex < iCount; iIndex++)
+                {
+                    const ResultValue * pRegEntry = changedRegisters->GetTupleValueByIndex(iIndex);
+                    unsigned long ulNumber;
+                    if (pRegEntry && pRegEntry->GetSimpleValue().ToULong(&ulNumber, 10))
+                    {
+                        numbers.push_back(ulNumber);
+                    }
+                }
+
+                m_cache.Invalidate(numbers);
+            }
+            else
+            {
+                // Do not know what changed, read everything that is shown
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the \"-data-list-changed-registers\" GDB/MI request. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Warning);
+                m_cache.Invalidate();
+            }
+
+            ReadStale();
+        }
+
         //    register-values=
         //    [
         //    {number="0",value="0xd1845ff7e0"},{number="1",value="0xd1845ff790"},{number="2",value="0xffffff2e7ba00870"},{number="3",value="0x0"},{number="4",value="0x2073692073696854"},
@@ -816,7 +968,6 @@ namespace dbg_mi
             ResultValue const * registryValues = result.GetResultValue().GetTupleValue("register-values");
             if (registryValues)
             {
-                bool bInsertRegistryData = (m_ParsedRegisteryDataReceived.size() ==  0);
                 int iCount = registryValues->GetTupleSize();
                 for (int iIndex = 0; iIndex < iCount; iIndex++)
                 {
@@ -830,23 +981,8 @@ namespace dbg_mi
                             wxString registryIndex = pRegValueIndex->GetSimpleValue();
                             wxString registryValue = pRegValueData->GetSimpleValue();
 
-                            long lregistryIndex;
-                            if (registryIndex.ToLong(&lregistryIndex, 10))
-                            {
-                                if (bInsertRegistryData || (m_ParsedRegisteryDataReceived.find(lregistryIndex) == m_ParsedRegisteryDataReceived.end() ))
-                                {
-                                    RegistryData regData;
-                                    regData.RegistryName = wxEmptyString;
-                                    regData.RegistryValue = registryValue;
-                                    m_ParsedRegisteryDataReceived.insert(std::make_pair(lregistryIndex, regData));
-                                }
-                                else
-                                {
-                                    RegistryData & regData = m_ParsedRegisteryDataReceived[lregistryIndex];
-                                    regData.RegistryValue = registryValue;
-                                }
-                            }
-                            else
+                            unsigned long ulregistryIndex;
+                            if (!registryIndex.ToULong(&ulregistryIndex, 10) || !m_cache.SetValue(ulregistryIndex, static_cast<const char *>(registryValue.utf8_str())))
                             {
                                 m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the register value index at index %d. Entry result: - %s", iIndex, pRegValueIndex->MakeDebugString()), LogPaneLogger::LineType::Error);
                             }
@@ -861,37 +997,61 @@ namespace dbg_mi
                         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the register-value index %d. Received id:%s result: - %s", iIndex, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
                     }
                 }
-                // Failures above with parsing will reset startup values later
-                m_bParsedRegisteryValuesReceived = true;
             }
             else
             {
-                m_bParsedRegisteryValuesReceived = false;
                 m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the \"-data-list-register-values x\" GDB/MI request. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
             }
+
+            ShowRegisters();
+            Finish();
         }
-        // Just in case GDB returns the results in a different order
-        if (m_bParsedRegisteryNamesReceived && m_bParsedRegisteryValuesReceived)
-        {
-            cbCPURegistersDlg * dialog = Manager::Get()->GetDebuggerManager()->GetCPURegistersDialog();
+    }
+
+    void GDBGenerateCPUInfoRegisters::ReadStale()
+    {
+        std::vector<size_t> stale;
+        m_cache.GetStale(m_show_vector, stale);
+        unsigned long shown = 0;
 
-            /* iterate thru map */
-            for (std::map<long, struct RegistryData>::iterator it = m_ParsedRegisteryDataReceived.begin();it != m_ParsedRegisteryDataReceived.end(); it++)
+        for (size_t number = 0; number < m_cache.GetCount(); ++number)
+        {
+            if (!m_cache.GetName(number).empty() && (m_show_vector || !m_cache.IsVector(number)))
             {
-                wxString registryName = it->second.RegistryName;
-                wxString registryValue = it->second.RegistryValue;
-                if (!registryName.IsEmpty() && !registryValue.IsEmpty())
-                {
-                    dialog->SetRegisterValue(registryName, registryValue, wxEmptyString);
-                }
+                shown++;
             }
+        }
 
-            // Reset values as they have been processed
-            m_bParsedRegisteryNamesReceived = false;
-            m_bParsedRegisteryValuesReceived= false;
-            m_ParsedRegisteryDataReceived.clear();
+        m_cache.CountReused(shown - stale.size());
 
+        if (stale.empty())
+        {
+            ShowRegisters();
             Finish();
+            return;
+        }
+
+        wxString cmd("-data-list-register-values x");
+
+        for (std::vector<size_t>::const_iterator it = stale.begin(); it != stale.end(); ++it)
+        {
+            cmd += wxString::Format(" %lu", static_cast<unsigned long>(*it));
+        }
+
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_reg_value_data_list_request_id = Execute(cmd);
+    }
+
+    void GDBGenerateCPUInfoRegisters::ShowRegisters()
+    {
+        cbCPURegistersDlg * dialog = Manager::Get()->GetDebuggerManager()->GetCPURegistersDialog();
+
+        for (size_t number = 0; number < m_cache.GetCount(); ++number)
+        {
+            if (!m_cache.GetName(number).empty() && m_cache.HasValue(number) && (m_show_vector || !m_cache.IsVector(number)))
+            {
+                dialog->SetRegisterValue(wxString::FromUTF8(m_cache.GetName(number).c_str()), wxString::FromUTF8(m_cache.GetValue(number).c_str()), wxEmptyString);
+            }
         }
     }
 
@@ -899,186 +1059,317 @@ namespace dbg_mi
     {
         // Do not use "info registers" with GDB/MI, but
         // On GDB/MI use "-data-list-register-names" and "-data-list-register-values x" - taken from CodeLite src
-        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "-data-list-register-names and -data-list-register-values x", LogPaneLogger::LineType::Debug);
-        m_bParsedRegisteryNamesReceived = false;
-        m_bParsedRegisteryValuesReceived= false;
-        m_ParsedRegisteryDataReceived.clear();
-        m_reg_name_data_list_request_id = Execute("-data-list-register-names");
-        m_reg_value_data_list_request_id = Execute("-data-list-register-values x");
+        // The names are read once a session, the values only for the registers that changed since the last stop
+        if (!m_cache.HasNames())
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "-data-list-register-names", LogPaneLogger::LineType::Debug);
+            m_reg_name_data_list_request_id = Execute("-data-list-register-names");
+        }
+
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "-data-list-changed-registers", LogPaneLogger::LineType::Debug);
+        m_reg_changed_list_request_id = Execute("-data-list-changed-registers");
     }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    GDBGenerateExamineMemory::GDBGenerateExamineMemory(LogPaneLogger * logger) :
-        m_logger(logger)
+    namespace
     {
-        cbExamineMemoryDlg * dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+        /** Addresses are shown with the pointer width of the host, it does not change during a session. */
+        wxString FormatMemoryAddress(uint64_t address)
+        {
+#if wxCHECK_VERSION(3, 1, 5)
+            static const bool is64Bit = (wxPlatformInfo::Get().GetBitness() == wxBITNESS_64);
+#else
+            static const bool is64Bit = (wxPlatformInfo::Get().GetArchitecture() == wxARCH_64);
+#endif
 
-        wxString sBaseAddress = dialog->GetBaseAddress();
-        uint64_t llBaseAddress;
-        if (sBaseAddress.ToULongLong(&llBaseAddress, 16))
+            if (is64Bit)
+            {
+                return wxString::Format("%#018llx", static_cast<unsigned long long>(address)); // 18 = 0x + 16 digits
+            }
+
+            return wxString::Format("%#10llx", static_cast<unsigned long long>(address)); // 10 = 0x + 8 digits
+        }
+
+        /** The text of every byte value, shared by all the bytes of a dump. */
+        wxString const * HexByteStrings()
         {
-            m_symbol = wxEmptyString;
-            m_address = llBaseAddress;
+            static wxString strings[256];
+
+            if (strings[0].empty())
+            {
+                for (int value = 0; value < 256; ++value)
+                {
+                    strings[value] = wxString(hex_codec::ByteToHex(static_cast<uint8_t>(value)), 2);
+                }
+            }
+
+            return strings;
         }
-        else
+    }
+
+    void ShowExamineMemory(uint64_t address, std::vector<uint8_t> const & bytes)
+    {
+        cbExamineMemoryDlg *dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+        dialog->Begin();
+        dialog->Clear();
+
+        const size_t BYTES_DISPPLAY_PER_LINE = 16;
+        wxString const * hexBytes = HexByteStrings();
+
+        for (size_t lineStart = 0; lineStart < bytes.size(); lineStart += BYTES_DISPPLAY_PER_LINE)
         {
-            m_symbol = sBaseAddress;
-            m_address = 0;
+            // One address per row, the bytes only pick their text from the table
+            wxString const sAddressToShow = FormatMemoryAddress(address + lineStart);
+            size_t const lineEnd = std::min(lineStart + BYTES_DISPPLAY_PER_LINE, bytes.size());
+
+            for (size_t index = lineStart; index < lineEnd; ++index)
+            {
+                dialog->AddHexByte(sAddressToShow, hexBytes[bytes[index]]);
+            }
         }
 
-        m_length = dialog->GetBytes();
+        dialog->End();
     }
 
-    void GDBGenerateExamineMemory::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    namespace
     {
-        // example of GDB 11.2 request and response:
-        //
-        // Request: -data-read-memory-bytes &arrTest 32
-        //
-        // Receive ==>190000000000^done,
-        // memory=
-        // [
-        //     {
-        //         begin="0x0000008284fffc40",
-        //         offset="0x0000000000000000",
-        //         end="0x0000008284fffc60",
-        //         contents="000000000154657374204f6e650000000000000000000000000100b501000000"
-        //     }
-        // ]
-        //
-
-        if (id == m_examine_memory_request_id)
+        /** Show memory in a range watch, the watch keeps it in the GDB hex format.
+         *
+         * Returns false if the watch already shows exactly this, it does not need to be redrawn.
+         */
+        bool SetRangeWatchMemory(cb::shared_ptr<GDBMemoryRangeWatch> const & watch, uint64_t address, std::vector<uint8_t> const & bytes)
         {
-            if (result.GetResultClass() == ResultParser::ClassError)
+            if (watch->GetAddress() == 0)
             {
-                const ResultValue & value = result.GetResultValue();
+                watch->SetAddress(address);
+            }
 
-                wxString message;
-                if (Lookup(value, "msg", message))
-                {
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Error detected: %s . Check the debugger log for more info!"), message), LogPaneLogger::LineType::Error);
-                }
-                else
+            std::vector<MemorySpan> changed;
+            bool const sameRange = watch->GetSnapshot().Update(address, bytes, changed);
+
+            if (sameRange && changed.empty() && !watch->GetIsValueErrorMessage())
+            {
+                if (!watch->IsChanged())
                 {
-                    message = _("Error detected, so cannot display memory. Check the debugger log for more info!");
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, message , LogPaneLogger::LineType::Error);
+                    return false;
                 }
 
-                cbExamineMemoryDlg *dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
-                dialog->Clear();
-                dialog->AddError(message);
+                watch->MarkAsChanged(false);
+                return true;
+            }
 
-                Finish();
-                return;
+            std::string hex;
+            hex_codec::Encode(bytes.data(), bytes.size(), hex);
+            watch->SetValue(wxString(hex));
+            watch->SetIsValueErrorMessage(false);
+            // Only memory that differs from the previous stop is shown as changed, not a new range
+            watch->MarkAsChanged(sameRange && !changed.empty());
+            return true;
+        }
+
+        /** Decode all the blocks of a -data-read-memory-bytes reply into the cache, the first block is returned.
+         *
+         * example of GDB 11.2 request and response:
+         *
+         * Request: -data-read-memory-bytes &arrTest 32
+         *
+         * Receive ==>190000000000^done,
+         * memory=
+         * [
+         *     {
+         *         begin="0x0000008284fffc40",
+         *         offset="0x0000000000000000",
+         *         end="0x0000008284fffc60",
+         *         contents="000000000154657374204f6e650000000000000000000000000100b501000000"
+         *     }
+         * ]
+         */
+        bool ParseMemoryReply(ResultParser const & result, MemoryPageCache & cache, uint64_t & begin, std::vector<uint8_t> & bytes, wxString & error)
+        {
+            const ResultValue * pMemory = result.GetResultValue().GetTupleValue("memory");
+
+            if (!pMemory || (pMemory->GetTupleSize() == 0))
+            {
+                error = "Could not find the GDB/MI memory response memory field";
+                return false;
             }
-            bool bErrorFound = false;
-            wxString sErrorFound = wxEmptyString;
-            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
 
-            const ResultValue * pMemory = result.GetResultValue().GetTupleValue("memory");
-            if (pMemory)
+            std::vector<uint8_t> block;
+            int iMemBlockCount = pMemory->GetTupleSize();
+
+            for (int iMemBlockIndex = 0; iMemBlockIndex < iMemBlockCount; iMemBlockIndex++)
             {
-                int iMemBlockCount = pMemory->GetTupleSize();
-                for (int iMemBlockIndex = 0; iMemBlockIndex < iMemBlockCount; iMemBlockIndex++)
+                const ResultValue * pMemBlockEntry = pMemory->GetTupleValueByIndex(iMemBlockIndex);
+
+                if (!pMemBlockEntry)
                 {
-                    const ResultValue * pMemBlockEntry = pMemory->GetTupleValueByIndex(iMemBlockIndex);
-                    if (pMemBlockEntry)
-                    {
-                        const ResultValue * pMemoryAddressBegin = pMemBlockEntry->GetTupleValue("begin");
-                        const ResultValue * pMemoryAddressOffset = pMemBlockEntry->GetTupleValue("offset");
-                        const ResultValue * pMemoryAddressEnd = pMemBlockEntry->GetTupleValue("end");
-                        const ResultValue * pMemoryContents = pMemBlockEntry->GetTupleValue("contents");
-                        if (pMemoryAddressBegin && pMemoryAddressOffset && pMemoryAddressEnd && pMemoryContents)
-                        {
-                            wxString sAddressBegin  = pMemoryAddressBegin->GetSimpleValue();
-                            wxString sAddressOffset = pMemoryAddressOffset->GetSimpleValue();
-                            wxString sAddressEnd    = pMemoryAddressEnd->GetSimpleValue();
-                            wxString sMemoryContents= pMemoryContents->GetSimpleValue();
-                            uint64_t llAddrbegin, llAddrOffset, llAddrEnd;
-
-                            if (
-                                    (sAddressBegin.ToULongLong(&llAddrbegin, 16)) &&
-                                    (sAddressOffset.ToULongLong(&llAddrOffset, 16)) &&
-                                    (sAddressEnd.ToULongLong(&llAddrEnd, 16)) &&
-                                    (!sMemoryContents.IsEmpty())
-                               )
-                            {
-                                cbExamineMemoryDlg *dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
-                                dialog->Begin();
-                                dialog->Clear();
+                    error = wxString::Format("Could not find GDB/MI memory block %d. ", iMemBlockIndex);
+                    return false;
+                }
 
-                                wxString sAddressToShow;
-                                uint64_t llAddrLineStart = llAddrbegin;
-                                const int BYTES_DISPPLAY_PER_LINE = 16;
-                                int iBytesPerLine = BYTES_DISPPLAY_PER_LINE;
+                const ResultValue * pMemoryAddressBegin = pMemBlockEntry->GetTupleValue("begin");
+                const ResultValue * pMemoryContents = pMemBlockEntry->GetTupleValue("contents");
 
-                                int iCount = llAddrEnd - llAddrbegin;
-                                for (int iAddressIndex = 0; iAddressIndex < iCount; iAddressIndex++)
-                                {
-#if wxCHECK_VERSION(3, 1, 5)
-                                    if (wxPlatformInfo::Get().GetBitness() == wxBITNESS_64)
-#else
-                                    if (wxPlatformInfo::Get().GetArchitecture() == wxARCH_64)
-#endif
-                                    {
-                                        sAddressToShow = wxString::Format("%#018llx", llAddrLineStart); // 18 = 0x + 16 digits
-                                    }
-                                    else
-                                    {
-                                        sAddressToShow = wxString::Format("%#10llx", llAddrLineStart); // 10 = 0x + 8 digits
-                                    }
-                                    wxString sHexDataValue = sMemoryContents.Mid(iAddressIndex*2,2);
-                                    dialog->AddHexByte(sAddressToShow, sHexDataValue);
-                                    iBytesPerLine--;
-                                    if (iBytesPerLine == 0)
-                                    {
-                                        llAddrLineStart = llAddrbegin + iAddressIndex;
-                                        iBytesPerLine = BYTES_DISPPLAY_PER_LINE;
-                                    }
-                                }
-                                dialog->End();
-                            }
-                            else
-                            {
-                                bErrorFound = true;
-                                sErrorFound = "Could not parse one pf the GDB/MI memory address fields.";
-                                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse one pf the GDB/MI memory address fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                            }
-                        }
-                        else
-                        {
-                            bErrorFound = true;
-                            sErrorFound = "Could not find one of he GDB/MI memory address fields";
-                            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not find one of he GDB/MI memory address fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                        }
-                    }
-                    else
-                    {
-                        bErrorFound = true;
-                        sErrorFound = wxString::Format("Could not find GDB/MI memory block %d. ", iMemBlockIndex);
-                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not find GDB/MI memory block %d. Received id:%s result: - %s", iMemBlockIndex, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                    }
+                if (!pMemoryAddressBegin || !pMemoryContents)
+                {
+                    error = "Could not find one of he GDB/MI memory address fields";
+                    return false;
+                }
+
+                uint64_t llAddrbegin;
+                std::string const contents = pMemoryContents->GetSimpleValue().ToStdString();
+                block.clear();
+
+                if (!pMemoryAddressBegin->GetSimpleValue().ToULongLong(&llAddrbegin, 16) || contents.empty())
+                {
+                    error = "Could not parse one pf the GDB/MI memory address fields.";
+                    return false;
+                }
+
+                if (!hex_codec::Decode(contents.data(), contents.length(), block))
+                {
+                    error = "Could not decode the GDB/MI memory contents.";
+                    return false;
+                }
+
+                cache.Store(llAddrbegin, block.data(), block.size());
+
+                if (iMemBlockIndex == 0)
+                {
+                    begin = llAddrbegin;
+                    bytes.swap(block);
                 }
             }
-            else
+
+            return true;
+        }
+    }
+
+    GDBGenerateExamineMemory::GDBGenerateExamineMemory(LogPaneLogger * logger, MemoryPageCache & cache, MemorySnapshot & snapshot, MemoryDumpRegistry & dumps) :
+        m_cache(cache),
+        m_snapshot(snapshot),
+        m_dumps(dumps),
+        m_page_read(false),
+        m_logger(logger)
+    {
+        cbExamineMemoryDlg * dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+
+        wxString sBaseAddress = dialog->GetBaseAddress();
+        uint64_t llBaseAddress;
+        if (sBaseAddress.ToULongLong(&llBaseAddress, 16))
+        {
+            m_symbol = wxEmptyString;
+            m_address = llBaseAddress;
+        }
+        else
+        {
+            m_symbol = sBaseAddress;
+            m_address = 0;
+        }
+
+        m_length = dialog->GetBytes();
+        m_cache.AddReader();
+    }
+
+    GDBGenerateExamineMemory::~GDBGenerateExamineMemory()
+    {
+        m_cache.RemoveReader();
+    }
+
+    void GDBGenerateExamineMemory::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        if (id != m_examine_memory_request_id)
+        {
+            return;
+        }
+
+        if (result.GetResultClass() == ResultParser::ClassError)
+        {
+            if (m_page_read)
+            {
+                // The whole pages reach memory that cannot be read, read only the bytes shown
+                ReadExact();
+                return;
+            }
+
+            const ResultValue & value = result.GetResultValue();
+
+            wxString message;
+            if (Lookup(value, "msg", message))
             {
-                bErrorFound = true;
-                sErrorFound = "Could not find the GDB/MI memory response memory field";
-                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not find the GDB/MI memory response memory field. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Error detected: %s . Check the debugger log for more info!"), message), LogPaneLogger::LineType::Error);
             }
-            if (bErrorFound == true)
+            else
             {
-                cbExamineMemoryDlg *dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
-                dialog->Clear();
-                dialog->AddError(sErrorFound);
+                message = _("Error detected, so cannot display memory. Check the debugger log for more info!");
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, message , LogPaneLogger::LineType::Error);
             }
 
+            cbExamineMemoryDlg *dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+            dialog->Clear();
+            dialog->AddError(message);
+            m_snapshot.Clear();
+
             Finish();
+            return;
+        }
+
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
+
+        uint64_t begin = 0;
+        std::vector<uint8_t> bytes;
+        wxString sErrorFound;
+
+        if (!ParseMemoryReply(result, m_cache, begin, bytes, sErrorFound))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s Received id:%s result: - %s", sErrorFound, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+            cbExamineMemoryDlg *dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+            dialog->Clear();
+            dialog->AddError(sErrorFound);
+            m_snapshot.Clear();
+            Finish();
+            return;
+        }
+
+        if (m_page_read)
+        {
+            if (!m_cache.Copy(m_address, m_length, bytes))
+            {
+                // GDB returned only part of the pages
+                ReadExact();
+                return;
+            }
+
+            begin = m_address;
+        }
+
+        Show(begin, bytes);
+        Finish();
+    }
+
+    void GDBGenerateExamineMemory::Show(uint64_t address, std::vector<uint8_t> const & bytes)
+    {
+        std::vector<MemorySpan> changed;
+
+        if (m_snapshot.Update(address, bytes, changed))
+        {
+            if (changed.empty())
+            {
+                // The dialog already shows this memory
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Memory at %#018llx did not change, not redrawn", address), LogPaneLogger::LineType::Debug);
+                return;
+            }
+
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Memory at %#018llx changed in %d span(s), the first at %#018llx",
+                                                                                    address, int(changed.size()), address + changed.front().start),
+                                    LogPaneLogger::LineType::Debug);
         }
+
+        ShowExamineMemory(address, bytes);
     }
 
-    void GDBGenerateExamineMemory::OnStart()
+    void GDBGenerateExamineMemory::ReadExact()
     {
         // GDB 11.2 manual synopsis:
         //  -data-read-memory-bytes [ -o offset ]
@@ -1094,18 +1385,102 @@ namespace dbg_mi
             cmd = wxString::Format("-data-read-memory-bytes %s %d", m_symbol, m_length);
         }
         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_page_read = false;
+        m_examine_memory_request_id = Execute(cmd);
+    }
+
+    void GDBGenerateExamineMemory::OnStart()
+    {
+        if (!m_symbol.IsEmpty() || (m_length <= 0))
+        {
+            // The address of an expression is only known from the reply, its pages are cached then
+            ReadExact();
+            return;
+        }
+
+        std::vector<uint8_t> bytes;
+        MemoryDump const * dump = m_dumps.Find(m_address, m_length, m_cache.GetEpoch());
+        std::string error;
+
+        // Dumped at this stop, the file still matches the target
+        if (dump && MemoryDumpRegistry::Read(*dump, m_address, m_length, bytes, error))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Memory at %#018llx shown from the dump \"%s\"", m_address, wxString::FromUTF8(dump->path.c_str())), LogPaneLogger::LineType::Debug);
+            Show(m_address, bytes);
+            Finish();
+            return;
+        }
+
+        if (m_cache.Read(m_address, m_length, bytes))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Memory at %#018llx shown from the page cache", m_address), LogPaneLogger::LineType::Debug);
+            Show(m_address, bytes);
+            Finish();
+            return;
+        }
+
+        uint64_t start, end;
+        m_cache.GetMissingSpan(m_address, m_length, start, end);
+        wxString const cmd = wxString::Format("-data-read-memory-bytes %#018llx %llu", start, end - start);
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_page_read = true;
         m_examine_memory_request_id = Execute(cmd);
     }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    GDBDisassemble::GDBDisassemble(wxString disassemblyFlavor, LogPaneLogger * logger) :
+    namespace
+    {
+        void ShowDisassemblyView(DisassemblyRange const & listing, MemorySpan const & view, uint64_t pc, wxString const & function)
+        {
+            cbDisassemblyDlg * dialog = Manager::Get()->GetDebuggerManager()->GetDisassemblyDialog();
+            size_t const pcIndex = listing.LowerBound(pc);
+            wxString symbol = function;
+
+            if (symbol.empty() && (pcIndex < listing.GetCount()) && (listing.GetAddress(pcIndex) == pc))
+            {
+                symbol = wxString::FromUTF8(listing.GetFunction(pcIndex).c_str());
+            }
+
+            cbStackFrame sf;
+            sf.SetAddress(pc);
+            sf.SetSymbol(symbol);
+            sf.MakeValid(true);
+            dialog->Clear(sf);
+
+            // Only the view goes to the dialog, however many instructions the function has
+            size_t source = listing.LowerBoundSourceLine(view.start);
+
+            for (size_t index = listing.LowerBound(view.start), last = listing.LowerBound(view.end); index < last; ++index)
+            {
+                uint64_t const address = listing.GetAddress(index);
+
+                for (; (source < listing.GetSourceLineCount()) && (listing.GetSourceLineAddress(source) <= address); ++source)
+                {
+                    if (listing.GetSourceLineAddress(source) == address)
+                    {
+                        dialog->AddSourceLine(listing.GetSourceLine(source), wxString::FromUTF8(listing.GetSourceFile(source).c_str()));
+                    }
+                }
+
+                dialog->AddAssemblerLine(address, wxString::FromUTF8(listing.GetText(index).c_str()));
+            }
+
+            dialog->SetActiveAddress(pc);
+        }
+    }
+
+    GDBDisassemble::GDBDisassemble(wxString disassemblyFlavor, uint64_t pc, LogPaneLogger * logger, DisassemblyCache & cache) :
                                     m_disassemblyFlavor(disassemblyFlavor),
-                                    m_logger(logger)
+                                    m_pc(pc),
+                                    m_mode(0),
+                                    m_show(false),
+                                    m_logger(logger),
+                                    m_cache(cache)
     {
     }
 
-    void GDBDisassemble::ParseASMInsmLine(cbDisassemblyDlg * dialog, const ResultValue * pASMLineItem, int iASMIndex)
+    void GDBDisassemble::ParseASMInsmLine(DisassemblyRange & range, const ResultValue * pASMLineItem, int iASMIndex)
     {
         const ResultValue * pAddress = pASMLineItem->GetTupleValue("address");
         if (!pAddress)
@@ -1134,11 +1509,16 @@ namespace dbg_mi
         if (pAddress && pFunctionName && pOffset && pASMInstruction)
         {
             uint64_t llAddrStart = 0;
+            unsigned long ulOffset = 0;
             wxString sAddress = pAddress->GetSimpleValue();
 
             if (sAddress.ToULongLong(&llAddrStart, 16))
             {
-                dialog->AddAssemblerLine(llAddrStart, pASMInstruction->GetSimpleValue());
+                pOffset->GetSimpleValue().ToULong(&ulOffset, 10);
+                range.AddInstruction(llAddrStart,
+                                     static_cast<uint32_t>(ulOffset),
+                                     static_cast<const char *>(pASMInstruction->GetSimpleValue().utf8_str()),
+                                     static_cast<const char *>(pFunctionName->GetSimpleValue().utf8_str()));
             }
             else
             {
@@ -1149,8 +1529,6 @@ namespace dbg_mi
 
     void GDBDisassemble::OnCommandOutput(CommandID const & id, ResultParser const & result)
     {
-        cbDisassemblyDlg * dialog = Manager::Get()->GetDebuggerManager()->GetDisassemblyDialog();
-
         //    ^done,frame={level="1",addr="0x0001076c",func="callee3",
         //      file="../../../devo/gdb/testsuite/gdb.mi/basics.c",
         //      fullname="/home/foo/bar/devo/gdb/testsuite/gdb.mi/basics.c",line="17",
@@ -1193,20 +1571,20 @@ namespace dbg_mi
                             m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the line in the frame: %s", pFrame->MakeDebugString()), LogPaneLogger::LineType::Error);
                         }
 
-                        if (pAddress && pFunctionName && pFileName && pLine)
+                        // Frames without source are disassembled as well, only the address is needed
+                        if (pAddress)
                         {
                             uint64_t llAddrStart = 0;
                             wxString sAddress = pAddress->GetSimpleValue();
 
                             if (sAddress.ToULongLong(&llAddrStart, 16))
                             {
-                                cbStackFrame sf;
-                                sf.SetAddress(llAddrStart);
-                                sf.SetSymbol(pFunctionName->GetSimpleValue());
-                                sf.MakeValid(true);
-                                dialog->Clear(sf);
+                                m_pc = llAddrStart;
 
-                                dialog->SetActiveAddress(llAddrStart);
+                                if (pFunctionName)
+                                {
+                                    m_function = pFunctionName->GetSimpleValue();
+                                }
                             }
                             else
                             {
@@ -1219,6 +1597,16 @@ namespace dbg_mi
                     m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the frame. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
                 }
             }
+
+            if (m_pc == 0)
+            {
+                // No address to disassemble around
+                Finish();
+            }
+            else
+            {
+                Locate();
+            }
         }
 
         // asm_insns=[
@@ -1256,10 +1644,13 @@ namespace dbg_mi
         // ]
 
 
-        if (id == m_disassemble_data_request_id)
+        WindowMap::iterator window = m_windows.find(id);
+
+        if (window != m_windows.end())
         {
             m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
 
+            DisassemblyRange range;
             const ResultValue * pASMArray = result.GetResultValue().GetTupleValue("asm_insns");
             if (pASMArray)
             {
@@ -1280,7 +1671,7 @@ namespace dbg_mi
 
                                 if (sLineNo.ToLong(&iLineNo, 10))
                                 {
-                                    dialog->AddSourceLine(iLineNo, pFileName->GetSimpleValue());
+                                    range.AddSourceLine(iLineNo, static_cast<const char *>(pFileName->GetSimpleValue().utf8_str()));
                                 }
                                 else
                                 {
@@ -1299,13 +1690,13 @@ namespace dbg_mi
                                 const ResultValue * pASMLineArrayLine = pASMLineArray->GetTupleValueByIndex(iASMLineArrayIndex);
                                 if (pASMLineArrayLine)
                                 {
-                                    ParseASMInsmLine(dialog, pASMLineArrayLine, iASMEntryIndex* 1000 + iASMLineArrayIndex);
+                                    ParseASMInsmLine(range, pASMLineArrayLine, iASMEntryIndex* 1000 + iASMLineArrayIndex);
                                 }
                             }
                         }
                         else
                         {
-                            ParseASMInsmLine(dialog, pASMLine, iASMEntryIndex);
+                            ParseASMInsmLine(range, pASMLine, iASMEntryIndex);
                         }
                     }
                     else
@@ -1318,16 +1709,84 @@ namespace dbg_mi
             {
                 m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse the \"-data-disassemble\" GDB/MI response. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
             }
-            Finish();
+
+            // Errors are kept as read spans without instructions as well, they would fail again
+            if (!m_cache.Add(window->second, range))
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Disassembly from %#018llx did not reach the instruction at %#018llx, dropped", window->second.start, window->second.landing), LogPaneLogger::LineType::Debug);
+            }
+
+            m_windows.erase(window);
+            FinishIfDone();
         }
     }
 
-    void GDBDisassemble::OnStart()
+    void GDBDisassemble::Locate()
+    {
+        MemorySpan const view = m_cache.GetView(m_pc);
+
+        if (m_cache.IsShown(m_pc))
+        {
+            // The dialog already lists the instructions, only the active line moves
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("pc %#018llx is in the shown disassembly", m_pc), LogPaneLogger::LineType::Debug);
+            Manager::Get()->GetDebuggerManager()->GetDisassemblyDialog()->SetActiveAddress(m_pc);
+            m_cache.CountLookup(true);
+        }
+        else if (m_cache.IsRead(view.start, view.end))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("pc %#018llx shown from the disassembly cache", m_pc), LogPaneLogger::LineType::Debug);
+            ShowView();
+            m_cache.CountLookup(true);
+        }
+        else
+        {
+            m_show = true;
+            m_cache.CountLookup(false);
+        }
+
+        // Read one window past the view as well, the next steps find their code cached
+        ReadWindows(view.start, view.end + DisassemblyCache::WindowSize);
+        FinishIfDone();
+    }
+
+    void GDBDisassemble::ReadWindows(uint64_t start, uint64_t end)
+    {
+        std::vector<DisassemblyWindow> windows;
+        m_cache.PlanWindows(m_pc, start, end, windows);
+
+        for (std::vector<DisassemblyWindow>::const_iterator it = windows.begin(); it != windows.end(); ++it)
+        {
+            // Addresses as numbers, they also work for a frame that is not the selected one
+            wxString cmdData = wxString::Format("-data-disassemble -s %#018llx -e %#018llx -- %d", it->start, it->end, m_mode);
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s", cmdData), LogPaneLogger::LineType::Debug);
+            m_windows[Execute(cmdData)] = *it;
+        }
+    }
+
+    void GDBDisassemble::ShowView()
+    {
+        MemorySpan const view = m_cache.GetView(m_pc);
+        ShowDisassemblyView(m_cache.GetInstructions(), view, m_pc, m_function);
+        m_cache.SetShown(view);
+    }
+
+    void GDBDisassemble::FinishIfDone()
     {
-        wxString cmdFrame("-stack-info-frame");
-        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s", cmdFrame), LogPaneLogger::LineType::Debug);
-        m_disassemble_frame_info_request_id = Execute(cmdFrame);
+        if (!m_windows.empty())
+        {
+            return;
+        }
+
+        if (m_show)
+        {
+            ShowView();
+        }
+
+        Finish();
+    }
 
+    void GDBDisassemble::OnStart()
+    {
         // Synopsis
         // -data-disassemble
         //     [ -s start-addr -e end-addr ]
@@ -1363,15 +1822,26 @@ namespace dbg_mi
         // proved useful in practice. See Section 9.6 [Machine Code], page 128, for a
         // discussion of the difference between /m and /s output of the disassemble
         // command
-        int iMode = 0; // Default
+        m_mode = 0; // Default
         if (Manager::Get()->GetDebuggerManager()->IsDisassemblyMixedMode())
         {
-            iMode = 4;
+            m_mode = 4;
         }
 
-        wxString cmdData = wxString::Format("-data-disassemble -s \"$pc -100\" -e \"$pc + 100\" -- %d", iMode);  // As per CodeLite debuggergdp.cpp DbgGdb::Disassemble(...) function
-        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s", cmdData), LogPaneLogger::LineType::Debug);
-        m_disassemble_data_request_id = Execute(cmdData);
+        // The mode and the flavor change the text GDB sends, the cached code is dropped when they change
+        m_cache.SetKey(static_cast<const char *>(wxString::Format("%d %s", m_mode, m_disassemblyFlavor).utf8_str()));
+
+        if (m_pc == 0)
+        {
+            // Not the frame the debuggee stopped in, ask GDB for its address first
+            wxString cmdFrame("-stack-info-frame");
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s", cmdFrame), LogPaneLogger::LineType::Debug);
+            m_disassemble_frame_info_request_id = Execute(cmdFrame);
+        }
+        else
+        {
+            Locate();
+        }
     }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1428,8 +1898,46 @@ namespace dbg_mi
         cbWatch::AddChild(watch, cb::shared_ptr<cbWatch>(new GDBWatch(watch->GetProject(), watch->GetGDBLogger(), "updating...", watch->ForTooltip())));
     }
 
+    void AppendPage(cb::shared_ptr<GDBWatch> parent, int start, int end)
+    {
+        cb::shared_ptr<GDBWatch> page(new GDBWatch(parent->GetProject(), parent->GetGDBLogger(), wxString::Format("[%d..%d]", start, end - 1), parent->ForTooltip(), false));
+        page->SetPageIndex(parent->GetChildCount());
+        page->SetRangeArray(start, end);
+        cbWatch::AddChild(parent, page);
+        AppendNullChild(page);
+    }
+
+    /** Split the children start..end-1 of parent into pages, nesting them so no node gets more than GetPageSize() children. */
+    void AppendPages(cb::shared_ptr<GDBWatch> parent, int start, int end)
+    {
+        long long step = GDBWatch::GetPageSize();
+
+        while ((end - start) / step >= GDBWatch::GetPageSize())
+        {
+            step *= GDBWatch::GetPageSize();
+        }
+
+        for (long long pageStart = start; pageStart < end; pageStart += step)
+        {
+            AppendPage(parent, int(pageStart), int(std::min<long long>(pageStart + step, end)));
+        }
+    }
+
+    /** The watch owning the var-objects of a page, i.e. the nearest ancestor which is not a page. */
+    cb::shared_ptr<GDBWatch> GetPageOwner(cb::shared_ptr<GDBWatch> page)
+    {
+        cb::shared_ptr<GDBWatch> owner = page;
+
+        while (owner && owner->IsPage())
+        {
+            owner = cb::static_pointer_cast<GDBWatch>(owner->GetParent());
+        }
+
+        return owner;
+    }
+
     cb::shared_ptr<GDBWatch> AddChild(cb::shared_ptr<GDBWatch> parent, ResultValue const & child_value, wxString const & symbol,
-                                   GDBWatchesContainer & watches)
+                                   GDBWatchesContainer & watches, WatchChangeSet & changes)
     {
         wxString id;
 
@@ -1446,7 +1954,11 @@ namespace dbg_mi
 
             if (Lookup(child_value, "value", s))
             {
-                child->SetValue(s);
+                if (child->GetRawValue() != s)
+                {
+                    child->SetValue(s);
+                    changes.Add(WatchChangeSet::ValueChanged);
+                }
             }
 
             if (Lookup(child_value, "type", s))
@@ -1459,42 +1971,75 @@ namespace dbg_mi
             child = cb::shared_ptr<GDBWatch>(new dbg_mi::GDBWatch(parent->GetProject(), parent->GetGDBLogger(), symbol, parent->ForTooltip()));
             ParseWatchValueID(*child, child_value);
             cbWatch::AddChild(parent, child);
+            watches.IndexChildAdded(parent, child);
+            changes.Add(WatchChangeSet::Added);
         }
 
         child->MarkAsRemoved(false);
         return child;
     }
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    void UpdateWatches(LogPaneLogger * logger, int updateType)
+    namespace
     {
-#ifndef TEST_PROJECT
-        logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("updating watches"), LogPaneLogger::LineType::Debug);
-        //Manager::Get()->GetDebuggerManager()->GetWatchesDialog()->OnDebuggerUpdated();
-        CodeBlocksEvent event(cbEVT_DEBUGGER_UPDATED);
-        event.SetInt(updateType);
-        //event.SetPlugin(m_pDriver->GetDebugger());
-        Manager::Get()->ProcessEvent(event);
-#endif
+        // Window types (cbDebuggerPlugin::DebugWindows) waiting for a cbEVT_DEBUGGER_UPDATED event
+        std::vector<int> s_pendingWatchUpdates;
     }
 
-    void UpdateWatchesTooltipOrAll(const cb::shared_ptr<GDBWatch> & watch, LogPaneLogger * logger)
+    void UpdateWatches(LogPaneLogger * logger, int updateType)
     {
-#ifndef TEST_PROJECT
-
-        if (watch->ForTooltip())
+        if (std::find(s_pendingWatchUpdates.begin(), s_pendingWatchUpdates.end(), updateType) == s_pendingWatchUpdates.end())
         {
-            logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("updating tooltip watches"), LogPaneLogger::LineType::Debug);
-            Manager::Get()->GetDebuggerManager()->GetInterfaceFactory()->UpdateValueTooltip();
+            s_pendingWatchUpdates.push_back(updateType);
         }
         else
         {
-            UpdateWatches(logger, int(cbDebuggerPlugin::DebugWindows::Watches));
+            logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("coalesced update of window type %d"), updateType), LogPaneLogger::LineType::Debug);
         }
-
-#endif
     }
 
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void FlushWatchUpdates(LogPaneLogger * logger)
+    {
+        if (s_pendingWatchUpdates.empty())
+        {
+            return;
+        }
+
+        // The handlers may start new actions, work on a copy
+        std::vector<int> pending;
+        pending.swap(s_pendingWatchUpdates);
+
+#ifndef TEST_PROJECT
+        for (std::vector<int>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+        {
+            logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("updating watches"), LogPaneLogger::LineType::Debug);
+            TraceSpan span("UpdateWatches");
+            //Manager::Get()->GetDebuggerManager()->GetWatchesDialog()->OnDebuggerUpdated();
+            CodeBlocksEvent event(cbEVT_DEBUGGER_UPDATED);
+            event.SetInt(*it);
+            //event.SetPlugin(m_pDriver->GetDebugger());
+            Manager::Get()->ProcessEvent(event);
+        }
+#endif
+    }
+
+    void UpdateWatchesTooltipOrAll(const cb::shared_ptr<GDBWatch> & watch, LogPaneLogger * logger)
+    {
+#ifndef TEST_PROJECT
+
+        if (watch->ForTooltip())
+        {
+            logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("updating tooltip watches"), LogPaneLogger::LineType::Debug);
+            Manager::Get()->GetDebuggerManager()->GetInterfaceFactory()->UpdateValueTooltip();
+        }
+        else
+        {
+            UpdateWatches(logger, int(cbDebuggerPlugin::DebugWindows::Watches));
+        }
+
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     GDBWatchBaseAction::GDBWatchBaseAction(GDBWatchesContainer & watches, LogPaneLogger * logger) :
         m_watches(watches),
@@ -1503,10 +2048,100 @@ namespace dbg_mi
     {
     }
 
+    void GDBWatchBaseAction::CheckTimeBudget(cb::shared_ptr<GDBWatch> const & watch)
+    {
+        CheckTimeBudget(watch, GetGDBTimeNs());
+    }
+
+    void GDBWatchBaseAction::CheckTimeBudget(cb::shared_ptr<GDBWatch> const & watch, uint64_t elapsed_ns)
+    {
+        int const budget = WatchBudget::Get().time_budget_ms;
+
+        if ((budget <= 0) || !watch || watch->ForTooltip() || !watch->IsAutoUpdateEnabled())
+        {
+            return;
+        }
+
+        long long const elapsed = static_cast<long long>(elapsed_ns / 1000000ULL);
+
+        if (elapsed > budget)
+        {
+            // Frozen from now on by GDBWatchesUpdateAction, so stepping does not pay for it again
+            watch->AutoUpdate(false);
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                    __LINE__,
+                                    wxString::Format(_("Watch \"%s\" took %lld ms to evaluate (budget %d ms), automatic update disabled. Use \"Update\" to refresh it."),
+                                                     watch->GetSymbol(), elapsed, budget),
+                                    LogPaneLogger::LineType::Warning);
+        }
+    }
+
     GDBWatchBaseAction::~GDBWatchBaseAction()
     {
     }
 
+    void GDBWatchBaseAction::ParseCreatedLocal(cb::shared_ptr<GDBWatch> const & local, ResultParser const & result, std::vector<CommandID> & ignored_ids)
+    {
+        if (result.GetResultClass() != ResultParser::ClassDone)
+        {
+            wxString message;
+
+            if (!Lookup(result.GetResultValue(), "msg", message))
+            {
+                message = "The expression can't be evaluated";
+            }
+
+            local->SetValue(message);
+            return;
+        }
+
+        ResultValue const & value = result.GetResultValue();
+        bool dynamic, has_more;
+        int children;
+        ParseWatchInfo(value, children, dynamic, has_more);
+        ParseWatchValueID(*local, value);
+        m_watches.IndexWatch(local);
+
+        if (dynamic && has_more)
+        {
+            ignored_ids.push_back(Execute(wxString::Format("-var-set-update-range \"%s\" 0 %d", local->GetID(), GDBWatch::GetDynamicWindow())));
+            ++m_sub_commands_left;
+
+            if (local->GetRangeArrayStart() < 0)
+            {
+                local->SetRangeArray(0, GDBWatch::GetDynamicWindow());
+            }
+
+            AppendNullChild(local);
+        }
+        else if (children > 0)
+        {
+            // Listed when the local is expanded, see GDBWatchExpandedAction
+            if (children > 1)
+            {
+                local->SetRangeArray(0, children);
+            }
+
+            local->SetNumChildren(children);
+            AppendNullChild(local);
+        }
+    }
+
+    void GDBWatchBaseAction::PublishChanges()
+    {
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "watch changes: " + m_changes.MakeDebugString(), LogPaneLogger::LineType::Debug);
+
+        if (m_changes.IsEmpty() && !m_watches.HasChangesShown())
+        {
+            // Nothing changed and nothing is highlighted from the previous update, keep the window as it is
+            return;
+        }
+
+        m_watches.SetChangesShown(m_changes.GetCount(WatchChangeSet::ValueChanged) > 0);
+        m_changes.Clear();
+        UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::Watches));
+    }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     bool GDBWatchBaseAction::ParseListCommand(CommandID const & id, ResultValue const & value)
     {
@@ -1606,10 +2241,10 @@ namespace dbg_mi
                                 if (!parent_watch->HasBeenExpanded())
                                 {
                                     parent_watch->SetHasBeenExpanded(true);
-                                    parent_watch->RemoveChildren();
+                                    m_watches.RemoveChildren(parent_watch);
                                 }
 
-                                child = AddChild(parent_watch, *child_value, (mapValue ? strMapKey : symbol), m_watches);
+                                child = AddChild(parent_watch, *child_value, (mapValue ? strMapKey : symbol), m_watches, m_changes);
 
                                 if (dynamic)
                                 {
@@ -1631,10 +2266,11 @@ namespace dbg_mi
                                     if (!parent_watch->HasBeenExpanded())
                                     {
                                         parent_watch->SetHasBeenExpanded(true);
-                                        parent_watch->RemoveChildren();
+                                        m_watches.RemoveChildren(parent_watch);
                                     }
 
-                                    child = AddChild(parent_watch, *child_value, (mapValue ? strMapKey : symbol), m_watches);
+                                    child = AddChild(parent_watch, *child_value, (mapValue ? strMapKey : symbol), m_watches, m_changes);
+                                    child->SetNumChildren(dynamic ? -1 : children_count);
                                     AppendNullChild(child);
                                     m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("adding child ==>%s<== to ==>%s<=="), child->GetDebugString(),  parent_watch->GetDebugString()), LogPaneLogger::LineType::Debug);
                                     child = cb::shared_ptr<GDBWatch>();
@@ -1657,7 +2293,26 @@ namespace dbg_mi
                 }
             }
 
-            parent_watch->RemoveMarkedChildren();
+            int const before = parent_watch->GetChildCount();
+            m_watches.RemoveMarkedChildren(parent_watch);
+            m_changes.Add(WatchChangeSet::Removed, before - parent_watch->GetChildCount());
+            int more;
+
+            if (Lookup(value, "has_more", more) && (more == 1) && (parent_watch->GetRangeArrayEnd() > 0))
+            {
+                // Dynamic container with children past the fetched range: offer the next window after
+                // the children just listed, nested in the listed node so none gets more than a page
+                int const start = parent_watch->GetRangeArrayEnd();
+                int const last = parent_watch->GetChildCount() - 1;
+                cb::shared_ptr<GDBWatch> lastChild = (last >= 0) ? cb::static_pointer_cast<GDBWatch>(parent_watch->GetChild(last)) : cb::shared_ptr<GDBWatch>();
+                bool const offered = lastChild && lastChild->IsPage() && (lastChild->GetRangeArrayStart() >= start);
+
+                if (!offered && (parent_watch->GetChildCount() < GDBWatch::GetPageSize()))
+                {
+                    AppendPage(parent_watch, start, start + GDBWatch::GetDynamicWindow());
+                    m_changes.Add(WatchChangeSet::ChildrenChanged);
+                }
+            }
         }
         else
         {
@@ -1741,11 +2396,18 @@ namespace dbg_mi
                     int children;
                     ParseWatchInfo(value, children, dynamic, has_more);
                     ParseWatchValueID(*m_watch, value);
+                    m_watches.IndexWatch(m_watch);
 
                     if (dynamic && has_more)
                     {
                         m_step = StepSetRange;
-                        Execute("-var-set-update-range \"" + m_watch->GetID() + "\" 0 100");
+                        Execute(wxString::Format("-var-set-update-range \"%s\" 0 %d", m_watch->GetID(), GDBWatch::GetDynamicWindow()));
+
+                        if (m_watch->GetRangeArrayStart() < 0)
+                        {
+                            m_watch->SetRangeArray(0, GDBWatch::GetDynamicWindow());
+                        }
+
                         AppendNullChild(m_watch);
                     }
                     else
@@ -1768,7 +2430,7 @@ namespace dbg_mi
                             if (varAddress == 0)
                             {
                                 // If there are children and then the value is an address, which if 0x00 then the pointer is NULL, so cannot show children!!!!
-                                m_watch->RemoveChildren();
+                                m_watches.RemoveChildren(m_watch);
                             }
                             else
                             {
@@ -1778,6 +2440,8 @@ namespace dbg_mi
                                     m_watch->SetRangeArray(0, children);
                                 }
 
+                                m_watch->SetNumChildren(children);
+
                                 m_step = StepListChildren;
                                 AppendNullChild(m_watch);
                             }
@@ -1829,6 +2493,7 @@ namespace dbg_mi
         {
             m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Command ID: %s ==>%s<=="), id.ToString(), resultDebug), LogPaneLogger::LineType::Error);
             UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::Watches));
+            CheckTimeBudget(m_watch);
             Finish();
         }
         else
@@ -1840,6 +2505,7 @@ namespace dbg_mi
                                         wxString::Format(_("Finished sub commands ID: %s"),  id.ToString()),
                                         LogPaneLogger::LineType::Debug);
                 UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::Watches));
+                CheckTimeBudget(m_watch);
                 Finish();
             }
         }
@@ -1868,173 +2534,891 @@ namespace dbg_mi
 
     GDBWatchCreateTooltipAction::~GDBWatchCreateTooltipAction()
     {
-        if (m_watch->ForTooltip())
+        // Not finished: deleted with the other actions when the session ended, its var-object is gone
+        if (m_cancelled || !m_watch->ForTooltip() || !Finished())
+        {
+            return;
+        }
+
+        if (!m_watch->GetID().empty())
+        {
+            m_cache.Add(m_watch->GetSymbol(), m_thread, m_frame, m_epoch, m_watch);
+        }
+
+        if (m_cache.IsLatestRequest(m_request))
         {
             Manager::Get()->GetDebuggerManager()->GetInterfaceFactory()->ShowValueTooltip(m_watch, m_rect);
         }
+        else
+        {
+            // The mouse moved on while GDB was busy, keep the result for the next hover but do not show it
+            GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), m_watch);
+
+            if (it != m_watches.end())
+            {
+                m_watches.erase(it);
+            }
+        }
+    }
+
+    void GDBWatchCreateTooltipAction::OnStart()
+    {
+        if (!m_cache.IsLatestRequest(m_request))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Tooltip for %s superseded, not evaluated"), m_watch->GetSymbol()), LogPaneLogger::LineType::Debug);
+            m_cancelled = true;
+            GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), m_watch);
+
+            if (it != m_watches.end())
+            {
+                m_watches.erase(it);
+            }
+
+            Finish();
+            return;
+        }
+
+        GDBWatchCreateAction::OnStart();
     }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    GDBMemoryRangeWatchCreateAction::GDBMemoryRangeWatchCreateAction(cb::shared_ptr<GDBMemoryRangeWatch> const & watch, LogPaneLogger * logger) :
-//        GDBWatchBaseAction(watchesContainer, logger),
-        m_watch(watch)
+
+    GDBWatchesCreateAction::GDBWatchesCreateAction(std::vector<cb::shared_ptr<GDBWatch>> const & new_watches, GDBWatchesContainer & watches, LogPaneLogger * logger) :
+        GDBWatchBaseAction(watches, logger),
+        m_new_watches(new_watches),
+        m_budget_mark_ns(0)
     {
     }
 
-    void GDBMemoryRangeWatchCreateAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    void GDBWatchesCreateAction::OnStart()
     {
-        // example of GDB 11.2 request and response:
-        //
-        // Request: -data-read-memory-bytes &arrTest 32
-        //
-        // Receive ==>190000000000^done,
-        // memory=
-        // [
-        //     {
-        //         begin="0x0000008284fffc40",
-        //         offset="0x0000000000000000",
-        //         end="0x0000008284fffc60",
-        //         contents="000000000154657374204f6e650000000000000000000000000100b501000000"
-        //     }
-        // ]
-        //
+        for (std::vector<cb::shared_ptr<GDBWatch>>::const_iterator it = m_new_watches.begin(); it != m_new_watches.end(); ++it)
+        {
+            wxString symbol = (*it)->GetSymbol();
+            symbol.Replace("\"", "\\\"");
+            m_create_map[Execute(wxString::Format("-var-create - @ %s", symbol))] = *it;
+            ++m_sub_commands_left;
+        }
 
-        if (id == m_memory_range_watch_request_id)
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Creating %d watches"), int(m_new_watches.size())), LogPaneLogger::LineType::UserDisplay);
+
+        if (m_create_map.empty())
         {
-            if (result.GetResultClass() == ResultParser::ClassError)
+            Finish();
+        }
+    }
+
+    void GDBWatchesCreateAction::ParseCreate(cb::shared_ptr<GDBWatch> const & watch, ResultParser const & result)
+    {
+        if (result.GetResultClass() != ResultParser::ClassDone)
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("The expression can't be evaluated! ==>%s<== ==>%s<=="), watch->GetSymbol(), result.MakeDebugString()), LogPaneLogger::LineType::Debug);
+            watch->SetValue("The expression can't be evaluated");
+            // The row still shows what it had before, the refresh at the end has to include it
+            m_changes.Add(WatchChangeSet::ValueChanged);
+            return;
+        }
+
+        ResultValue const & value = result.GetResultValue();
+        bool dynamic, has_more;
+        int children;
+        ParseWatchInfo(value, children, dynamic, has_more);
+        ParseWatchValueID(*watch, value);
+        m_watches.IndexWatch(watch);
+        m_changes.Add(WatchChangeSet::Added);
+
+        if (dynamic && has_more)
+        {
+            // The reply is not needed, OnCommandOutput() ignores it
+            Execute(wxString::Format("-var-set-update-range \"%s\" 0 %d", watch->GetID(), GDBWatch::GetDynamicWindow()));
+            ++m_sub_commands_left;
+
+            if (watch->GetRangeArrayStart() < 0)
             {
-                const ResultValue & value = result.GetResultValue();
+                watch->SetRangeArray(0, GDBWatch::GetDynamicWindow());
+            }
 
-                wxString message;
-                if (Lookup(value, "msg", message))
-                {
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Error detected: %s . Check the debugger log for more info!"), message), LogPaneLogger::LineType::Error);
-                }
-                else
-                {
-                    message = _("Error detected, so cannot display memory. Check the debugger log for more info!");
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, message , LogPaneLogger::LineType::Error);
-                }
+            AppendNullChild(watch);
+        }
+        else if (children > 0)
+        {
+            long varAddress = -1;
 
-                m_watch->SetValue(message);
-                m_watch->SetIsValueErrorMessage(true);
-                UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
-                Finish();
+            if (!watch->GetRawValue().ToLong(&varAddress, 16))
+            {
+                varAddress = -1;
+            }
+
+            if (varAddress == 0)
+            {
+                // NULL pointer, there are no children to show
+                m_watches.RemoveChildren(watch);
                 return;
             }
-            bool bErrorFound = false;
-            wxString sErrorFound = wxEmptyString;
-            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
 
-            const ResultValue * pMemory = result.GetResultValue().GetTupleValue("memory");
-            if (pMemory)
+            if (children > 1)
             {
-                int iMemBlockCount = pMemory->GetTupleSize();
-                for (int iMemBlockIndex = 0; iMemBlockIndex < iMemBlockCount; iMemBlockIndex++)
-                {
-                    const ResultValue * pMemBlockEntry = pMemory->GetTupleValueByIndex(iMemBlockIndex);
-                    if (pMemBlockEntry)
-                    {
-                        const ResultValue * pMemoryAddressBegin = pMemBlockEntry->GetTupleValue("begin");
-                        const ResultValue * pMemoryAddressOffset = pMemBlockEntry->GetTupleValue("offset");
-                        const ResultValue * pMemoryAddressEnd = pMemBlockEntry->GetTupleValue("end");
-                        const ResultValue * pMemoryContents = pMemBlockEntry->GetTupleValue("contents");
-                        if (pMemoryAddressBegin && pMemoryAddressOffset && pMemoryAddressEnd && pMemoryContents)
-                        {
-                            wxString sAddressBegin  = pMemoryAddressBegin->GetSimpleValue();
-                            wxString sAddressOffset = pMemoryAddressOffset->GetSimpleValue();
-                            wxString sAddressEnd    = pMemoryAddressEnd->GetSimpleValue();
-                            wxString sMemoryContents= pMemoryContents->GetSimpleValue();
-                            uint64_t llAddrbegin, llAddrOffset, llAddrEnd;
-
-                            if (
-                                    (sAddressBegin.ToULongLong(&llAddrbegin, 16)) &&
-                                    (sAddressOffset.ToULongLong(&llAddrOffset, 16)) &&
-                                    (sAddressEnd.ToULongLong(&llAddrEnd, 16)) &&
-                                    (!sMemoryContents.IsEmpty())
-                               )
-                            {
-                                if (m_watch->GetAddress() == 0)
-                                {
-                                    m_watch->SetAddress(llAddrbegin);
-                                }
+                watch->SetRangeArray(0, children);
+            }
 
-                                m_watch->SetValue(sMemoryContents);
-                                m_watch->SetIsValueErrorMessage(false);
-                                UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
-                            }
-                            else
-                            {
-                                bErrorFound = true;
-                                sErrorFound = "Could not parse one pf the GDB/MI memory address fields.";
-                                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse one pf the GDB/MI memory address fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                            }
-                        }
-                        else
-                        {
-                            bErrorFound = true;
-                            sErrorFound = "Could not find one of he GDB/MI memory address fields";
-                            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not find one of he GDB/MI memory address fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                        }
-                    }
-                    else
-                    {
-                        bErrorFound = true;
-                        sErrorFound = wxString::Format("Could not find GDB/MI memory block %d. ", iMemBlockIndex);
-                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not find GDB/MI memory block %d. Received id:%s result: - %s", iMemBlockIndex, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                    }
+            watch->SetNumChildren(children);
+            AppendNullChild(watch);
+
+            // Collapsed watches are listed when expanded, see GDBWatchExpandedAction
+            if (watch->IsExpanded() && (children <= GDBWatch::GetPageSize()))
+            {
+                m_list_children.push_back(watch);
+            }
+        }
+    }
+
+    void GDBWatchesCreateAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        --m_sub_commands_left;
+        ListCommandParentMap::iterator it = m_create_map.find(id);
+        // The time GDB spent on this result alone, the watches of the action are budgeted one by one
+        uint64_t const elapsed = GetGDBTimeNs() - m_budget_mark_ns;
+        m_budget_mark_ns = GetGDBTimeNs();
+
+        if (it != m_create_map.end())
+        {
+            ParseCreate(it->second, result);
+            CheckTimeBudget(it->second, elapsed);
+            m_create_map.erase(it);
+
+            if (m_create_map.empty())
+            {
+                // Every var-object exists now, list the first level of the expanded ones in one go
+                for (std::vector<cb::shared_ptr<GDBWatch>>::const_iterator watch = m_list_children.begin(); watch != m_list_children.end(); ++watch)
+                {
+                    ExecuteListCommand(*watch);
                 }
+
+                m_list_children.clear();
+            }
+        }
+        else if (m_parent_map.find(id) != m_parent_map.end())
+        {
+            // Only the first level of the watches themselves is listed here
+            CheckTimeBudget(m_parent_map[id], elapsed);
+
+            if (result.GetResultClass() == ResultParser::ClassDone)
+            {
+                ParseListCommand(id, result.GetResultValue());
+            }
+            else
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Command ID: %s ==>%s<=="), id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+            }
+        }
+
+        if (m_sub_commands_left == 0)
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "watches created: " + m_changes.MakeDebugString(), LogPaneLogger::LineType::Debug);
+            PublishChanges();
+            Finish();
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    GDBMemoryRangeWatchCreateAction::GDBMemoryRangeWatchCreateAction(cb::shared_ptr<GDBMemoryRangeWatch> const & watch, LogPaneLogger * logger, MemoryPageCache & cache) :
+        m_watch(watch),
+        m_cache(cache),
+        m_page_read(false),
+        m_logger(logger)
+    {
+        m_cache.AddReader();
+    }
+
+    GDBMemoryRangeWatchCreateAction::~GDBMemoryRangeWatchCreateAction()
+    {
+        m_cache.RemoveReader();
+    }
+
+    void GDBMemoryRangeWatchCreateAction::ShowMemory(uint64_t address, std::vector<uint8_t> const & bytes)
+    {
+        SetRangeWatchMemory(m_watch, address, bytes);
+        UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
+    }
+
+    void GDBMemoryRangeWatchCreateAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        if (id != m_memory_range_watch_request_id)
+        {
+            return;
+        }
+
+        if (result.GetResultClass() == ResultParser::ClassError)
+        {
+            if (m_page_read)
+            {
+                // The whole pages reach memory that cannot be read, read only the range
+                ReadExact();
+                return;
+            }
+
+            const ResultValue & value = result.GetResultValue();
+
+            wxString message;
+            if (Lookup(value, "msg", message))
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Error detected: %s . Check the debugger log for more info!"), message), LogPaneLogger::LineType::Error);
             }
             else
             {
-                bErrorFound = true;
-                sErrorFound = "Could not find the GDB/MI memory response memory field";
-                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not find the GDB/MI memory response memory field. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+                message = _("Error detected, so cannot display memory. Check the debugger log for more info!");
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, message , LogPaneLogger::LineType::Error);
+            }
+
+            m_watch->SetValue(message);
+            m_watch->SetIsValueErrorMessage(true);
+            UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
+            Finish();
+            return;
+        }
+
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
+
+        uint64_t begin = 0;
+        std::vector<uint8_t> bytes;
+        wxString sErrorFound;
+
+        if (!ParseMemoryReply(result, m_cache, begin, bytes, sErrorFound))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s Received id:%s result: - %s", sErrorFound, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+            m_watch->SetValue(sErrorFound);
+            m_watch->SetIsValueErrorMessage(true);
+            UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
+            Finish();
+            return;
+        }
+
+        if (m_page_read)
+        {
+            if (!m_cache.Copy(m_watch->GetAddress(), m_watch->GetSize(), bytes))
+            {
+                // GDB returned only part of the pages
+                ReadExact();
+                return;
             }
 
-            if (bErrorFound == true)
-            {
-                m_watch->SetValue(sErrorFound);
-                m_watch->SetIsValueErrorMessage(true);
-                UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
-            }
-            Finish();
-        }
+            begin = m_watch->GetAddress();
+        }
+
+        ShowMemory(begin, bytes);
+        Finish();
+    }
+
+    void GDBMemoryRangeWatchCreateAction::ReadExact()
+    {
+        // GDB 11.2 manual synopsis:
+        //  -data-read-memory-bytes [ -o offset ]
+        //      address count
+
+        wxString sSymbol = m_watch->GetSymbol();
+        wxString cmd;
+        if (sSymbol.IsEmpty())
+        {
+            uint64_t llAddress = m_watch->GetAddress();
+            cmd = wxString::Format("-data-read-memory-bytes %#018llx %llu", llAddress, m_watch->GetSize());
+        }
+        else
+        {
+            cmd = wxString::Format("-data-read-memory-bytes %s %llu", sSymbol, m_watch->GetSize());
+        }
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_page_read = false;
+        m_memory_range_watch_request_id = Execute(cmd);
+    }
+
+    void GDBMemoryRangeWatchCreateAction::OnStart()
+    {
+        // A symbol is evaluated again, e.g. &local moves with the frame, only a fixed address is looked up
+        if (!m_watch->GetSymbol().IsEmpty() || (m_watch->GetSize() == 0))
+        {
+            ReadExact();
+            return;
+        }
+
+        std::vector<uint8_t> bytes;
+        uint64_t const address = m_watch->GetAddress();
+        size_t const size = static_cast<size_t>(m_watch->GetSize());
+
+        if (m_cache.Read(address, size, bytes))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Memory at %#018llx shown from the page cache", address), LogPaneLogger::LineType::Debug);
+            ShowMemory(address, bytes);
+            Finish();
+            return;
+        }
+
+        uint64_t start, end;
+        m_cache.GetMissingSpan(address, size, start, end);
+        wxString const cmd = wxString::Format("-data-read-memory-bytes %#018llx %llu", start, end - start);
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_page_read = true;
+        m_memory_range_watch_request_id = Execute(cmd);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    GDBMemoryDumpAction::GDBMemoryDumpAction(wxString const & start, uint64_t size, std::string const & path, LogPaneLogger * logger, MemoryPageCache & cache, MemoryDumpRegistry & dumps) :
+        m_start(start),
+        m_path(path),
+        m_address(0),
+        m_size(size),
+        m_next_offset(0),
+        m_done_bytes(0),
+        m_progress(nullptr),
+        m_resolving(false),
+        m_cancelled(false),
+        m_failed(false),
+        m_cache(cache),
+        m_dumps(dumps),
+        m_logger(logger)
+    {
+    }
+
+    GDBMemoryDumpAction::~GDBMemoryDumpAction()
+    {
+        if (m_progress)
+        {
+            m_progress->Destroy();
+        }
+
+        if (m_file.IsOpen())
+        {
+            // The dump did not finish, e.g. the debugger was stopped
+            m_file.Close();
+            wxRemoveFile(wxString::FromUTF8(m_path.c_str()));
+        }
+    }
+
+    void GDBMemoryDumpAction::OnStart()
+    {
+        std::string error;
+
+        if ((m_size == 0) || !m_file.Open(m_path, MappedFile::CreateReadWrite, m_size, error))
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Could not create the memory dump \"%s\": %s"), wxString::FromUTF8(m_path.c_str()), wxString::FromUTF8(error.c_str())), LogPaneLogger::LineType::Error);
+            Finish();
+            return;
+        }
+
+        m_progress = new wxProgressDialog(_("Dump memory to file"),
+                                          wxString::Format(_("Dumping %llu bytes at %s"), m_size, m_start),
+                                          ProgressRange,
+                                          Manager::Get()->GetAppWindow(),
+                                          wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME | wxPD_REMAINING_TIME);
+        m_stopwatch.Start();
+
+        // Same parsing as the Examine Memory address
+        if (m_start.ToULongLong(&m_address, 16))
+        {
+            SendChunks();
+        }
+        else
+        {
+            // The first chunk tells where the expression points to, the others are sent once it is known
+            m_resolving = true;
+            SendChunk(m_start);
+        }
+    }
+
+    void GDBMemoryDumpAction::SendChunk(wxString const & address)
+    {
+        uint64_t const length = GetChunkLength(m_next_offset);
+        wxString const cmd = wxString::Format("-data-read-memory-bytes %s %llu", address, length);
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_chunks[Execute(cmd)] = m_next_offset;
+        m_next_offset += length;
+    }
+
+    void GDBMemoryDumpAction::SendChunks()
+    {
+        // Only a few chunks are in flight, the memory used does not depend on the size of the dump
+        while (!m_resolving && !m_cancelled && !m_failed && (m_next_offset < m_size) && (m_chunks.size() < ChunksInFlight))
+        {
+            SendChunk(wxString::Format("%#018llx", m_address + m_next_offset));
+        }
+    }
+
+    void GDBMemoryDumpAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        ChunkMap::iterator it = m_chunks.find(id);
+
+        if (it == m_chunks.end())
+        {
+            return;
+        }
+
+        uint64_t const offset = it->second;
+        uint64_t const length = GetChunkLength(offset);
+        m_chunks.erase(it);
+
+        if (result.GetResultClass() == ResultParser::ClassError)
+        {
+            wxString message;
+
+            if (!Lookup(result.GetResultValue(), "msg", message))
+            {
+                message = _("Error detected. Check the debugger log for more info!");
+            }
+
+            Fail(message);
+        }
+        else
+        {
+            wxString error;
+
+            if (StoreChunk(result, offset, length, error))
+            {
+                m_done_bytes += length;
+                m_resolving = false;
+            }
+            else
+            {
+                Fail(error);
+            }
+        }
+
+        if (!m_failed && !m_cancelled && m_progress)
+        {
+            int const value = static_cast<int>(m_done_bytes * ProgressRange / m_size);
+
+            if (!m_progress->Update(value, wxString::Format(_("%llu of %llu KB"), m_done_bytes / 1024, m_size / 1024)))
+            {
+                m_cancelled = true;
+            }
+        }
+
+        SendChunks();
+
+        if (m_chunks.empty() && (m_failed || m_cancelled || (m_done_bytes == m_size)))
+        {
+            Complete();
+        }
+    }
+
+    bool GDBMemoryDumpAction::StoreChunk(ResultParser const & result, uint64_t offset, uint64_t length, wxString & error)
+    {
+        const ResultValue * pMemory = result.GetResultValue().GetTupleValue("memory");
+
+        if (!pMemory || (pMemory->GetTupleSize() == 0))
+        {
+            error = "Could not find the GDB/MI memory response memory field";
+            return false;
+        }
+
+        std::vector<MemorySpan> read;
+        int iMemBlockCount = pMemory->GetTupleSize();
+
+        for (int iMemBlockIndex = 0; iMemBlockIndex < iMemBlockCount; iMemBlockIndex++)
+        {
+            const ResultValue * pMemBlockEntry = pMemory->GetTupleValueByIndex(iMemBlockIndex);
+            const ResultValue * pMemoryAddressBegin = pMemBlockEntry ? pMemBlockEntry->GetTupleValue("begin") : nullptr;
+            const ResultValue * pMemoryAddressOffset = pMemBlockEntry ? pMemBlockEntry->GetTupleValue("offset") : nullptr;
+            const ResultValue * pMemoryContents = pMemBlockEntry ? pMemBlockEntry->GetTupleValue("contents") : nullptr;
+            uint64_t llAddrbegin, llAddrOffset;
+
+            if (!pMemoryAddressBegin || !pMemoryAddressOffset || !pMemoryContents
+                || !pMemoryAddressBegin->GetSimpleValue().ToULongLong(&llAddrbegin, 16)
+                || !pMemoryAddressOffset->GetSimpleValue().ToULongLong(&llAddrOffset, 16))
+            {
+                error = wxString::Format("Could not parse GDB/MI memory block %d.", iMemBlockIndex);
+                return false;
+            }
+
+            if (m_resolving)
+            {
+                // The offset is relative to the address the expression evaluated to
+                m_address = llAddrbegin - llAddrOffset;
+                m_resolving = false;
+            }
+
+            std::string const contents = pMemoryContents->GetSimpleValue().ToStdString();
+            uint64_t const position = llAddrbegin - m_address;
+            uint64_t const bytes = contents.length() / 2;
+
+            if ((llAddrbegin < m_address) || (position < offset) || (position + bytes > offset + length))
+            {
+                error = wxString::Format("GDB/MI memory block %d at %#018llx is outside of the requested chunk.", iMemBlockIndex, llAddrbegin);
+                return false;
+            }
+
+            // Straight into the mapped file, no copy of the chunk is kept
+            if (!hex_codec::Decode(contents.data(), contents.length(), m_file.GetData() + position))
+            {
+                error = "Could not decode the GDB/MI memory contents.";
+                return false;
+            }
+
+            MemorySpan const span = {llAddrbegin, llAddrbegin + bytes};
+            read.push_back(span);
+        }
+
+        // GDB leaves out the blocks it could not read, the file keeps zeros there
+        std::vector<MemorySpan> const holes = FindUncovered(read, m_address + offset, m_address + offset + length);
+
+        for (std::vector<MemorySpan>::const_iterator it = holes.begin(); it != holes.end(); ++it)
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__,
+                                    wxString::Format(_("%llu byte(s) at %#018llx could not be read, they are zero in the dump"), it->end - it->start, it->start),
+                                    LogPaneLogger::LineType::Warning);
+            m_unreadable.push_back(*it);
+        }
+
+        return true;
+    }
+
+    void GDBMemoryDumpAction::Fail(wxString const & message)
+    {
+        if (!m_failed)
+        {
+            m_failed = true;
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Memory dump failed: %s"), message), LogPaneLogger::LineType::Error);
+        }
+    }
+
+    void GDBMemoryDumpAction::Complete()
+    {
+        if (m_progress)
+        {
+            m_progress->Destroy();
+            m_progress = nullptr;
+        }
+
+        wxString const path = wxString::FromUTF8(m_path.c_str());
+
+        if (m_failed || m_cancelled)
+        {
+            m_file.Close();
+            wxRemoveFile(path);
+
+            if (m_cancelled)
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Memory dump cancelled, \"%s\" removed"), path), LogPaneLogger::LineType::UserDisplay);
+            }
+        }
+        else
+        {
+            m_file.Flush();
+            m_file.Close();
+
+            MemoryDump dump;
+            dump.path = m_path;
+            dump.address = m_address;
+            dump.size = m_size;
+            dump.epoch = m_cache.GetEpoch();
+            // Chunks complete in any order
+            dump.unreadable = CoalesceSpans(m_unreadable, 0);
+            m_dumps.Add(dump);
+
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__,
+                                    wxString::Format(_("Dumped %llu bytes at %#018llx to \"%s\" in %ld ms"), m_size, m_address, path, m_stopwatch.Time()),
+                                    LogPaneLogger::LineType::UserDisplay);
+        }
+
+        Finish();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    GDBMemoryRangeWatchesUpdateAction::GDBMemoryRangeWatchesUpdateAction(GDBMemoryRangeWatchesContainer const & watches, uint64_t gap, LogPaneLogger * logger, MemoryPageCache & cache) :
+        m_watches(watches),
+        m_gap(gap),
+        m_merged_left(0),
+        m_redraw(false),
+        m_cache(cache),
+        m_logger(logger)
+    {
+        m_cache.AddReader();
+    }
+
+    GDBMemoryRangeWatchesUpdateAction::~GDBMemoryRangeWatchesUpdateAction()
+    {
+        m_cache.RemoveReader();
+    }
+
+    void GDBMemoryRangeWatchesUpdateAction::OnStart()
+    {
+        std::vector<MemorySpan> spans;
+        int cached = 0;
+
+        for (GDBMemoryRangeWatchesContainer::const_iterator it = m_watches.begin(); it != m_watches.end(); ++it)
+        {
+            cb::shared_ptr<GDBMemoryRangeWatch> const & watch = *it;
+
+            if (watch->GetSize() == 0)
+            {
+                continue;
+            }
+
+            if (!watch->GetSymbol().IsEmpty())
+            {
+                // The address of an expression is only known from the reply, it cannot be merged
+                ReadExact(watch);
+                continue;
+            }
+
+            std::vector<uint8_t> bytes;
+
+            if (m_cache.Read(watch->GetAddress(), static_cast<size_t>(watch->GetSize()), bytes))
+            {
+                m_redraw |= SetRangeWatchMemory(watch, watch->GetAddress(), bytes);
+                cached++;
+                continue;
+            }
+
+            MemorySpan const span = {watch->GetAddress(), watch->GetAddress() + watch->GetSize()};
+            spans.push_back(span);
+            m_merged_watches.push_back(watch);
+        }
+
+        // Only the pages missing from the cache are read, page aligned spans can touch so they are merged again
+        std::vector<MemorySpan> const merged = CoalesceSpans(spans, m_gap);
+        std::vector<MemorySpan> reads;
+
+        for (std::vector<MemorySpan>::const_iterator it = merged.begin(); it != merged.end(); ++it)
+        {
+            MemorySpan pages;
+
+            if (m_cache.GetMissingSpan(it->start, static_cast<size_t>(it->end - it->start), pages.start, pages.end))
+            {
+                reads.push_back(pages);
+            }
+        }
+
+        reads = CoalesceSpans(reads, 0);
+
+        for (std::vector<MemorySpan>::const_iterator it = reads.begin(); it != reads.end(); ++it)
+        {
+            wxString const cmd = wxString::Format("-data-read-memory-bytes %#018llx %llu", it->start, it->end - it->start);
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+            m_reads[Execute(cmd)] = cb::shared_ptr<GDBMemoryRangeWatch>();
+            m_merged_left++;
+        }
+
+        if (!m_merged_watches.empty())
+        {
+            unsigned long const saved = m_merged_watches.size() - reads.size();
+            m_cache.AddSavedReads(saved);
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__,
+                                    wxString::Format("Memory range watches: %d range(s) read with %d request(s), %lu read(s) saved by merging, %d range(s) from the page cache",
+                                                     int(m_merged_watches.size()), int(reads.size()), saved, cached),
+                                    LogPaneLogger::LineType::Debug);
+        }
+
+        if (m_merged_left == 0)
+        {
+            SliceMergedReads();
+        }
+
+        FinishIfDone();
+    }
+
+    void GDBMemoryRangeWatchesUpdateAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        ReadMap::iterator it = m_reads.find(id);
+
+        if (it == m_reads.end())
+        {
+            return;
+        }
+
+        cb::shared_ptr<GDBMemoryRangeWatch> watch = it->second;
+        m_reads.erase(it);
+
+        uint64_t begin = 0;
+        std::vector<uint8_t> bytes;
+        wxString error;
+        bool parsed = false;
+
+        if (result.GetResultClass() == ResultParser::ClassError)
+        {
+            if (!Lookup(result.GetResultValue(), "msg", error))
+            {
+                error = _("Error detected, so cannot display memory. Check the debugger log for more info!");
+            }
+        }
+        else
+        {
+            parsed = ParseMemoryReply(result, m_cache, begin, bytes, error);
+        }
+
+        if (!watch)
+        {
+            // A merged read, the ranges it did not fill are read on their own afterwards
+            if (!parsed)
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Merged memory read failed: %s", error), LogPaneLogger::LineType::Warning);
+            }
+
+            if (--m_merged_left == 0)
+            {
+                SliceMergedReads();
+            }
+        }
+        else if (parsed)
+        {
+            m_redraw |= SetRangeWatchMemory(watch, begin, bytes);
+        }
+        else
+        {
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("%s Received id:%s result: - %s", error, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+            watch->SetValue(error);
+            watch->SetIsValueErrorMessage(true);
+            m_redraw = true;
+        }
+
+        FinishIfDone();
+    }
+
+    void GDBMemoryRangeWatchesUpdateAction::ReadExact(cb::shared_ptr<GDBMemoryRangeWatch> const & watch)
+    {
+        wxString const sSymbol = watch->GetSymbol();
+        wxString cmd;
+
+        if (sSymbol.IsEmpty())
+        {
+            cmd = wxString::Format("-data-read-memory-bytes %#018llx %llu", watch->GetAddress(), watch->GetSize());
+        }
+        else
+        {
+            cmd = wxString::Format("-data-read-memory-bytes %s %llu", sSymbol, watch->GetSize());
+        }
+
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
+        m_reads[Execute(cmd)] = watch;
+    }
+
+    void GDBMemoryRangeWatchesUpdateAction::SliceMergedReads()
+    {
+        for (GDBMemoryRangeWatchesContainer::const_iterator it = m_merged_watches.begin(); it != m_merged_watches.end(); ++it)
+        {
+            std::vector<uint8_t> bytes;
+
+            if (m_cache.Copy((*it)->GetAddress(), static_cast<size_t>((*it)->GetSize()), bytes))
+            {
+                m_redraw |= SetRangeWatchMemory(*it, (*it)->GetAddress(), bytes);
+            }
+            else
+            {
+                // GDB could not read all the pages, e.g. the range borders unmapped memory
+                ReadExact(*it);
+            }
+        }
+
+        m_merged_watches.clear();
+    }
+
+    void GDBMemoryRangeWatchesUpdateAction::FinishIfDone()
+    {
+        if (m_reads.empty())
+        {
+            // Not redrawn when every range is the same as at the previous stop
+            if (m_redraw)
+            {
+                UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::MemoryRange));
+            }
+
+            Finish();
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    GDBWatchesUpdateAction::GDBWatchesUpdateAction(GDBWatchesContainer & watches, LogPaneLogger * logger) :
+        GDBWatchBaseAction(watches, logger)
+    {
+    }
+
+    GDBWatchesUpdateAction::GDBWatchesUpdateAction(GDBWatchesContainer & watches, LogPaneLogger * logger, cb::shared_ptr<GDBWatch> const & expanded_watch) :
+        GDBWatchBaseAction(watches, logger),
+        m_expanded_watch(expanded_watch)
+    {
     }
 
-    void GDBMemoryRangeWatchCreateAction::OnStart()
+    void GDBWatchesUpdateAction::UpdateFrozenState(cb::shared_ptr<GDBWatch> const & watch, bool visible)
     {
-        // GDB 11.2 manual synopsis:
-        //  -data-read-memory-bytes [ -o offset ]
-        //      address count
+        // The user turned auto update off, it stays frozen even when it is shown
+        visible = visible && watch->IsAutoUpdateEnabled();
 
-        wxString sSymbol = m_watch->GetSymbol();
-        wxString cmd;
-        if (sSymbol.IsEmpty())
+        if (!watch->GetID().empty() && (watch->IsFrozen() == visible))
         {
-            uint64_t llAddress = m_watch->GetAddress();
-            cmd = wxString::Format("-data-read-memory-bytes %#018llx %llu", llAddress, m_watch->GetSize());
+            watch->SetFrozen(!visible);
+            m_frozen_commands.push_back(Execute(wxString::Format("-var-set-frozen %s %d", watch->GetID(), visible ? 0 : 1)));
+            ++m_sub_commands_left;
         }
-        else
+
+        if (!visible)
         {
-            cmd = wxString::Format("-data-read-memory-bytes %s %llu", sSymbol, m_watch->GetSize());
+            // GDB skips the children of a frozen var-object, leave their state alone
+            return;
         }
-        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, cmd, LogPaneLogger::LineType::Debug);
-        m_memory_range_watch_request_id = Execute(cmd);
-    }
 
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool const childrenVisible = watch->IsExpanded();
 
-    GDBWatchesUpdateAction::GDBWatchesUpdateAction(GDBWatchesContainer & watches, LogPaneLogger * logger) :
-        GDBWatchBaseAction(watches, logger)
-    {
+        for (int child = 0; child < watch->GetChildCount(); ++child)
+        {
+            UpdateFrozenState(cb::static_pointer_cast<GDBWatch>(watch->GetChild(child)), childrenVisible);
+        }
     }
 
     void GDBWatchesUpdateAction::OnStart()
     {
+        m_sub_commands_left = 0;
+
+        if (m_expanded_watch)
+        {
+            // Thaw the children frozen while the watch was collapsed, the update of the watch includes them
+            UpdateFrozenState(m_expanded_watch, true);
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("-var-update 1 %s", m_expanded_watch->GetID()), LogPaneLogger::LineType::Debug);
+            m_update_command = Execute(wxString::Format("-var-update 1 %s", m_expanded_watch->GetID()));
+            ++m_sub_commands_left;
+            return;
+        }
+
+        // Only watches the user can see are updated: watches with auto update disabled and the
+        // children of collapsed watches are frozen and refreshed once they become visible again.
+        for (GDBWatchesContainer::iterator it = m_watches.begin(); it != m_watches.end(); ++it)
+        {
+            UpdateFrozenState(*it, (*it)->IsAutoUpdateEnabled());
+        }
+
+        std::vector<cb::shared_ptr<GDBWatch>> & locals = m_watches.GetLocals();
+
+        for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = locals.begin(); it != locals.end(); ++it)
+        {
+            cb::shared_ptr<cbWatch> parent = (*it)->GetParent();
+            UpdateFrozenState(*it, (!parent || parent->IsExpanded()) && (*it)->IsAutoUpdateEnabled());
+        }
+
         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "-var-update 1 *", LogPaneLogger::LineType::Debug);
         m_update_command = Execute("-var-update 1 *");
-        m_sub_commands_left = 1;
+        ++m_sub_commands_left;
+    }
+
+    bool GDBWatchesUpdateAction::RecreateLocal(cb::shared_ptr<GDBWatch> const & watch)
+    {
+        std::vector<cb::shared_ptr<GDBWatch>> const & locals = m_watches.GetLocals();
+
+        if (std::find(locals.begin(), locals.end(), watch) == locals.end())
+        {
+            return false;
+        }
+
+        // Bound to a frame that is gone, e.g. another call of the function at the same level
+        watch->Expand(false);
+        m_changes.Add(WatchChangeSet::Removed, watch->GetChildCount());
+        m_watches.RemoveChildren(watch);
+        m_watches.UnindexWatch(watch);
+        m_ignored_ids.push_back(Execute("-var-delete " + watch->GetID()));
+        watch->SetID(wxEmptyString);
+        watch->SetFrozen(false);
+        watch->SetHasBeenExpanded(false);
+        m_recreate_map[Execute(wxString::Format("-var-create - * %s", watch->GetSymbol()))] = watch;
+        m_sub_commands_left += 2;
+        m_changes.Add(WatchChangeSet::ValueChanged);
+        return true;
     }
 
     bool GDBWatchesUpdateAction::ParseUpdate(ResultParser const & result)
@@ -2085,15 +3469,29 @@ namespace dbg_mi
                     switch (updated_var.GetInScope())
                     {
                         case UpdatedVariable::InScope_No:
+                            if (RecreateLocal(watch))
+                            {
+                                break;
+                            }
+
                             watch->Expand(false);
-                            watch->RemoveChildren();
+                            m_changes.Add(WatchChangeSet::Removed, watch->GetChildCount());
+                            m_watches.RemoveChildren(watch);
                             watch->SetValue("-- not in scope --");
+                            m_changes.Add(WatchChangeSet::ValueChanged);
                             break;
 
                         case UpdatedVariable::InScope_Invalid:
+                            if (RecreateLocal(watch))
+                            {
+                                break;
+                            }
+
                             watch->Expand(false);
-                            watch->RemoveChildren();
+                            m_changes.Add(WatchChangeSet::Removed, watch->GetChildCount());
+                            m_watches.RemoveChildren(watch);
                             watch->SetValue("-- invalid -- ");
+                            m_changes.Add(WatchChangeSet::ValueChanged);
                             break;
 
                         case UpdatedVariable::InScope_Yes:
@@ -2101,7 +3499,8 @@ namespace dbg_mi
                             {
                                 if (updated_var.HasNewNumberOfChildren())
                                 {
-                                    watch->RemoveChildren();
+                                    m_changes.Add(WatchChangeSet::ChildrenChanged);
+                                    m_watches.RemoveChildren(watch);
 
                                     if (updated_var.GetNewNumberOfChildren() > 0)
                                     {
@@ -2111,6 +3510,7 @@ namespace dbg_mi
                                 else
                                     if (updated_var.HasMore())
                                     {
+                                        m_changes.Add(WatchChangeSet::ChildrenChanged);
                                         watch->MarkChildsAsRemoved(); // watch->RemoveChildren();
                                         ExecuteListCommand(watch);
                                     }
@@ -2119,6 +3519,7 @@ namespace dbg_mi
                                         {
                                             watch->SetValue(updated_var.GetValue());
                                             watch->MarkAsChanged(true);
+                                            m_changes.Add(WatchChangeSet::ValueChanged);
                                         }
                                         else
                                         {
@@ -2132,7 +3533,8 @@ namespace dbg_mi
                             {
                                 if (updated_var.HasNewNumberOfChildren())
                                 {
-                                    watch->RemoveChildren();
+                                    m_changes.Add(WatchChangeSet::ChildrenChanged);
+                                    m_watches.RemoveChildren(watch);
 
                                     if (updated_var.GetNewNumberOfChildren() > 0)
                                     {
@@ -2144,6 +3546,7 @@ namespace dbg_mi
                                 {
                                     watch->SetValue(updated_var.GetValue());
                                     watch->MarkAsChanged(true);
+                                    m_changes.Add(WatchChangeSet::ValueChanged);
                                     m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
                                                             __LINE__,
                                                             wxString::Format(_("Update ==>%s<<== = ==>%s<<=="),  expression, updated_var.GetValue()),
@@ -2153,6 +3556,7 @@ namespace dbg_mi
                                 else
                                 {
                                     watch->SetValue(wxEmptyString);
+                                    m_changes.Add(WatchChangeSet::ValueChanged);
                                 }
                             }
 
@@ -2173,11 +3577,44 @@ namespace dbg_mi
     {
         --m_sub_commands_left;
 
-        if (id == m_update_command)
+        if (std::find(m_frozen_commands.begin(), m_frozen_commands.end(), id) != m_frozen_commands.end())
+        {
+            if (result.GetResultClass() == ResultParser::ClassError)
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                        __LINE__,
+                                        wxString::Format(_("-var-set-frozen failed ==>%s<=="), result.MakeDebugString()),
+                                        LogPaneLogger::LineType::Debug);
+            }
+        }
+        else if (std::find(m_ignored_ids.begin(), m_ignored_ids.end(), id) != m_ignored_ids.end())
+        {
+            // -var-delete of a local's old var-object, or the update range of its new one
+        }
+        else if (m_recreate_map.find(id) != m_recreate_map.end())
+        {
+            ParseCreatedLocal(m_recreate_map[id], result, m_ignored_ids);
+        }
+        else if (id == m_update_command)
         {
-            for (GDBWatchesContainer::iterator it = m_watches.begin();  it != m_watches.end(); ++it)
+            if (m_expanded_watch)
+            {
+                // The other watches keep the changes of the last step highlighted
+                m_expanded_watch->MarkAsChangedRecursive(false);
+            }
+            else
             {
-                (*it)->MarkAsChangedRecursive(false);
+                for (GDBWatchesContainer::iterator it = m_watches.begin();  it != m_watches.end(); ++it)
+                {
+                    (*it)->MarkAsChangedRecursive(false);
+                }
+
+                std::vector<cb::shared_ptr<GDBWatch>> & locals = m_watches.GetLocals();
+
+                for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = locals.begin(); it != locals.end(); ++it)
+                {
+                    (*it)->MarkAsChangedRecursive(false);
+                }
             }
 
             if (!ParseUpdate(result))
@@ -2208,7 +3645,7 @@ namespace dbg_mi
                                     wxString::Format(_("WatchUpdateAction::Output - finishing at==>%s<<=="), id.ToString()),
                                     LogPaneLogger::LineType::Debug
                                    );
-            UpdateWatches(m_logger, int(cbDebuggerPlugin::DebugWindows::Watches));
+            PublishChanges();
             Finish();
         }
     }
@@ -2227,15 +3664,84 @@ namespace dbg_mi
 
     void GDBWatchExpandedAction::OnStart()
     {
+        int const pageStart = m_expanded_watch->IsPage() ? m_expanded_watch->GetRangeArrayStart() : 0;
+        int const pageEnd = m_expanded_watch->IsPage() ? m_expanded_watch->GetRangeArrayEnd() : m_expanded_watch->GetNumChildren();
+
+        if (pageEnd - pageStart > GDBWatch::GetPageSize())
+        {
+            // Too many children to fetch at once, show pages and fetch a page when it is expanded
+            m_watches.RemoveChildren(m_expanded_watch);
+            AppendPages(m_expanded_watch, pageStart, pageEnd);
+            m_expanded_watch->SetHasBeenExpanded(true);
+            UpdateWatchesTooltipOrAll(m_expanded_watch, m_logger);
+            Finish();
+            return;
+        }
+
+        if (m_expanded_watch->IsPage())
+        {
+            std::vector<cb::shared_ptr<GDBWatch>> evicted;
+            m_watches.TouchPage(m_expanded_watch, evicted);
+
+            for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = evicted.begin(); it != evicted.end(); ++it)
+            {
+                cb::shared_ptr<GDBWatch> page = *it;
+
+                for (int child = 0; child < page->GetChildCount(); ++child)
+                {
+                    wxString const & childID = cb::static_pointer_cast<GDBWatch>(page->GetChild(child))->GetID();
+
+                    if (!childID.empty())
+                    {
+                        m_delete_ids.push_back(Execute("-var-delete " + childID));
+                    }
+                }
+
+                m_watches.RemoveChildren(page);
+                page->SetHasBeenExpanded(false);
+                page->Expand(false);
+                AppendNullChild(page);
+            }
+
+            cb::shared_ptr<GDBWatch> owner = GetPageOwner(m_expanded_watch);
+
+            if (!owner)
+            {
+                Finish();
+                return;
+            }
+
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                    __LINE__,
+                                    wxString::Format("page %d..%d of %s, %d page(s) evicted", pageStart, pageEnd, owner->GetID(), int(evicted.size())),
+                                    LogPaneLogger::LineType::Debug);
+            ExecuteListCommand(owner->GetID(), m_expanded_watch);
+            return;
+        }
+
         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("-var-update %s", m_watch->GetID()), LogPaneLogger::LineType::Debug);
         m_update_id = Execute(wxString::Format("-var-update %s", m_watch->GetID()));
+
+        if (m_expanded_watch->IsFrozen())
+        {
+            // The watch was hidden until now, its children are visible from here on
+            m_expanded_watch->SetFrozen(false);
+            m_unfreeze_id = Execute(wxString::Format("-var-set-frozen %s 0", m_expanded_watch->GetID()));
+        }
+
         ExecuteListCommand(m_expanded_watch, cb::shared_ptr<GDBWatch>());
     }
 
     void GDBWatchExpandedAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
     {
-        if ((id == m_update_id) && (result.GetResultClass() != ResultParser::ClassError))
+        if (((id == m_update_id) || (id == m_unfreeze_id)) && (result.GetResultClass() != ResultParser::ClassError))
+        {
+            return;
+        }
+
+        if (std::find(m_delete_ids.begin(), m_delete_ids.end(), id) != m_delete_ids.end())
         {
+            // var-objects of an evicted page, an error only means GDB already dropped them
             return;
         }
 
@@ -2256,7 +3762,7 @@ namespace dbg_mi
             }
 
             m_watch->SetValue("Malformed debugger response");
-            m_expanded_watch->RemoveChildren();
+            m_watches.RemoveChildren(m_expanded_watch);
             UpdateWatchesTooltipOrAll(m_expanded_watch, m_logger);
 m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "Calling Finished()", LogPaneLogger::LineType::Debug);
             Finish();
@@ -2282,6 +3788,7 @@ m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "Calling Finished()", Log
                                         _("GDBWatchExpandedAction::Output - done"),
                                         LogPaneLogger::LineType::Debug);
                 UpdateWatchesTooltipOrAll(m_expanded_watch, m_logger);
+                CheckTimeBudget(m_watch);
                 Finish();
             }
         }
@@ -2289,6 +3796,42 @@ m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "Calling Finished()", Log
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    void GDBWatchFetchFullValueAction::OnStart()
+    {
+        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("-var-evaluate-expression %s", m_watch->GetID()), LogPaneLogger::LineType::Debug);
+        Execute("-gdb-set print elements 0");
+        m_evaluate_id = Execute("-var-evaluate-expression " + m_watch->GetID());
+        Execute(wxString::Format("-gdb-set print elements %d", WatchBudget::Get().max_string_chars));
+        m_sub_commands_left = 3;
+    }
+
+    void GDBWatchFetchFullValueAction::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        --m_sub_commands_left;
+
+        if (id == m_evaluate_id)
+        {
+            wxString value;
+
+            if ((result.GetResultClass() == ResultParser::ClassDone) && Lookup(result.GetResultValue(), "value", value))
+            {
+                m_watch->SetFullValue(value);
+                UpdateWatchesTooltipOrAll(m_watch, m_logger);
+            }
+            else
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Could not fetch the full value ==>%s<=="), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+            }
+        }
+
+        if (m_sub_commands_left == 0)
+        {
+            Finish();
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
     void GDBWatchCollapseAction::OnStart()
     {
         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("-var-delete -c %s", m_collapsed_watch->GetID()), LogPaneLogger::LineType::Debug);
@@ -2300,7 +3843,7 @@ m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "Calling Finished()", Log
         if (result.GetResultClass() == ResultParser::ClassDone)
         {
             m_collapsed_watch->SetHasBeenExpanded(false);
-            m_collapsed_watch->RemoveChildren();
+            m_watches.RemoveChildren(m_collapsed_watch);
             AppendNullChild(m_collapsed_watch);
             UpdateWatchesTooltipOrAll(m_collapsed_watch, m_logger);
         }
@@ -2310,114 +3853,198 @@ m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "Calling Finished()", Log
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    GDBStackVariables::GDBStackVariables(LogPaneLogger * logger, cb::shared_ptr<dbg_mi::GDBWatch> watchLocalsandArgs, bool bWatchFuncLocalsArgs):
+    GDBStackVariables::GDBStackVariables(LogPaneLogger * logger, cb::shared_ptr<dbg_mi::GDBWatch> watchLocalsandArgs, bool bWatchFuncLocalsArgs, GDBWatchesContainer & watches, int thread_id):
+                                            GDBWatchBaseAction(watches, logger),
                                             m_WatchLocalsandArgs(watchLocalsandArgs),
                                             m_bWatchFuncLocalsArgs(bWatchFuncLocalsArgs),
-                                            m_logger(logger)
+                                            m_thread_id(thread_id),
+                                            m_replies_left(0)
     {
     }
 
-    void GDBStackVariables::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    void GDBStackVariables::DeleteLocal(cb::shared_ptr<GDBWatch> const & local)
     {
-        if (result.GetResultClass() != ResultParser::ClassDone)
+        if (!local->GetID().empty())
         {
-            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Wrong result class. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+            m_ignored_ids.push_back(Execute("-var-delete " + local->GetID()));
+            ++m_sub_commands_left;
         }
-        else
+
+        m_watches.UnindexWatch(local);
+        m_changes.Add(WatchChangeSet::Removed);
+    }
+
+    void GDBStackVariables::Reconcile()
+    {
+        std::vector<cb::shared_ptr<GDBWatch>> & locals = m_watches.GetLocals();
+        // The frame base tells one call of the function from another at the same level
+        m_frame_key = wxString::Format("%s@%s thread %d frame %s", m_frame_function, m_frame_level, m_thread_id, m_frame_base);
+
+        if (m_frame_key != m_watches.GetLocalsKey())
+        {
+            // Another function or frame, none of the var-objects can be reused
+            m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("locals for %s, were %s", m_frame_key, m_watches.GetLocalsKey()), LogPaneLogger::LineType::Debug);
+
+            for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = locals.begin(); it != locals.end(); ++it)
+            {
+                DeleteLocal(*it);
+            }
+
+            locals.clear();
+            m_watches.SetLocalsKey(m_frame_key);
+        }
+
+        std::vector<cb::shared_ptr<GDBWatch>> current;
+
+        for (std::vector<wxString>::const_iterator name = m_names.begin(); name != m_names.end(); ++name)
         {
-            if (id == m_stack_list_variables_request_id)
-            {
-                // type: result ,
-                // ClassDone  ,
-                // { m_value results:
-                //     {
-                //         variables=
-                //         [
-                //             {name=cTest,type=char [300]},
-                //             {name=stTest,type=TestSimpleStruct},
-                //             {name=arrTest,type=TestSimpleStruct [3]},
-                //             {name=result,type=int,value=<optimized out>},
-                //             {name=btest,type=int,value=3},
-                //             {name=stlTest,type=TestSTLStruct},
-                //             {name=aStlTest,type=TestSTLStruct [5]}
-                //         ]
-                //     }
-                // }
-
-                if (m_WatchLocalsandArgs)
+            cb::shared_ptr<GDBWatch> local;
+
+            for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = locals.begin(); it != locals.end(); ++it)
+            {
+                if (*it && ((*it)->GetSymbol() == *name))
                 {
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
-                    const ResultValue * pVariableArray = result.GetResultValue().GetTupleValue("variables");
-                    if (pVariableArray)
-                    {
-                        m_WatchLocalsandArgs->MarkChildsAsRemoved();
+                    local = *it;
+                    it->reset();
+                    break;
+                }
+            }
 
-                        int iVariableArrayCount = pVariableArray->GetTupleSize();
-                        if (iVariableArrayCount == 0)
-                        {
-                            m_WatchLocalsandArgs->SetValue("-- No arguments or locals --");
-                        }
-                        else
-                        {
-                            m_WatchLocalsandArgs->SetValue(wxEmptyString);
-                            for (int iIndex = 0; iIndex < iVariableArrayCount; iIndex++)
-                            {
-                                const ResultValue * pVariableEntry = pVariableArray->GetTupleValueByIndex(iIndex);
-                                if (pVariableEntry)
-                                {
-                                    const ResultValue * pVariableResultName = pVariableEntry->GetTupleValue("name");
-                                    const ResultValue * pVariableResultType = pVariableEntry->GetTupleValue("type");
+            if (!local)
+            {
+                local = cb::shared_ptr<GDBWatch>(new dbg_mi::GDBWatch(m_WatchLocalsandArgs->GetProject(),
+                                                                      m_WatchLocalsandArgs->GetGDBLogger(),
+                                                                      *name,
+                                                                      m_WatchLocalsandArgs->ForTooltip()
+                                                                     ));
+                // Bound to the selected frame, so the value is not re-evaluated in another frame
+                m_create_map[Execute(wxString::Format("-var-create - * %s", *name))] = local;
+                ++m_sub_commands_left;
+                m_changes.Add(WatchChangeSet::Added);
+            }
 
-                                    if (pVariableResultName && pVariableResultType)
-                                    {
-                                        const wxString & VarName = pVariableResultName->GetSimpleValue();
+            current.push_back(local);
+        }
 
-                                        if (m_WatchLocalsandArgs)
-                                        {
-                                            cb::shared_ptr<GDBWatch> child = cb::shared_ptr<GDBWatch>(new dbg_mi::GDBWatch( m_WatchLocalsandArgs->GetProject(),
-                                                                                                                            m_WatchLocalsandArgs->GetGDBLogger(),
-                                                                                                                           VarName,
-                                                                                                                           m_WatchLocalsandArgs->ForTooltip()
-                                                                                                                           ));
-                                            ParseWatchValueID(*child, *pVariableEntry);
-                                            cbWatch::AddChild(m_WatchLocalsandArgs, child);
-                                        }
-                                    }
-                                    else
-                                    {
-                                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse one of the variable entry fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                                    }
+        // Went out of scope (end of a block)
+        for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = locals.begin(); it != locals.end(); ++it)
+        {
+            if (*it)
+            {
+                DeleteLocal(*it);
+            }
+        }
 
-                                }
-                                else
-                                {
-                                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse variable entry index %d field. Received id:%s result: - %s", iIndex, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                                }
-                            }
-                        }
-                        m_WatchLocalsandArgs->RemoveMarkedChildren();
+        m_WatchLocalsandArgs->SetValue(current.empty() ? wxString("-- No arguments or locals --") : wxString(wxEmptyString));
+        m_watches.SetLocals(m_WatchLocalsandArgs, current);
+    }
+
+    void GDBStackVariables::OnCommandOutput(CommandID const & id, ResultParser const & result)
+    {
+        --m_sub_commands_left;
+
+        if (id == m_frame_base_request_id)
+        {
+            // value="0x7fffffffd9f0", an error for frames without debug information
+            --m_replies_left;
+
+            if ((result.GetResultClass() != ResultParser::ClassDone) || !Lookup(result.GetResultValue(), "value", m_frame_base))
+            {
+                m_frame_base = wxEmptyString;
+            }
+
+            if (m_replies_left == 0)
+            {
+                Reconcile();
+            }
+        }
+        else if ((id == m_stack_info_frame_request_id) || (id == m_stack_list_variables_request_id))
+        {
+            --m_replies_left;
+
+            if (result.GetResultClass() != ResultParser::ClassDone)
+            {
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Wrong result class. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+                Finish();
+                return;
+            }
+
+            if (id == m_stack_info_frame_request_id)
+            {
+                // frame={level="0",addr="0x00401a2b",func="main",file="main.cpp",fullname="...",line="12"}
+                ResultValue const * frame = result.GetResultValue().GetTupleValue("frame");
+
+                if (frame)
+                {
+                    Lookup(*frame, "level", m_frame_level);
+                    Lookup(*frame, "func", m_frame_function);
+                }
+            }
+            else
+            {
+                // variables=[{name=cTest},{name=stTest},{name=arrTest},{name=result},{name=btest}]
+                m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Debug);
+                const ResultValue * pVariableArray = result.GetResultValue().GetTupleValue("variables");
+
+                if (!pVariableArray)
+                {
+                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse variables entry fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+                    Finish();
+                    return;
+                }
+
+                int iVariableArrayCount = pVariableArray->GetTupleSize();
+
+                for (int iIndex = 0; iIndex < iVariableArrayCount; iIndex++)
+                {
+                    const ResultValue * pVariableEntry = pVariableArray->GetTupleValueByIndex(iIndex);
+                    wxString VarName;
 
-                        // Update watches now
-                        CodeBlocksEvent event(cbEVT_DEBUGGER_UPDATED);
-                        event.SetInt(int(cbDebuggerPlugin::DebugWindows::Watches));
-                        Manager::Get()->ProcessEvent(event);
+                    if (pVariableEntry && Lookup(*pVariableEntry, "name", VarName))
+                    {
+                        m_names.push_back(VarName);
                     }
                     else
                     {
-                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse variables entry fields. Received id:%s result: - %s", id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
+                        m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Could not parse variable entry index %d field. Received id:%s result: - %s", iIndex, id.ToString(), result.MakeDebugString()), LogPaneLogger::LineType::Error);
                     }
                 }
-                else
-                {
-                    m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("m_localsWatch is nullptr. result: - %s", result.MakeDebugString()), LogPaneLogger::LineType::Error);
-                }
+            }
+
+            if (m_replies_left == 0)
+            {
+                Reconcile();
             }
         }
-        Finish();
+        else if (std::find(m_ignored_ids.begin(), m_ignored_ids.end(), id) != m_ignored_ids.end())
+        {
+            // -var-delete of a local gone out of scope, or the update range of a new one
+        }
+        else
+        {
+            ListCommandParentMap::iterator it = m_create_map.find(id);
+
+            if (it != m_create_map.end())
+            {
+                ParseCreatedLocal(it->second, result, m_ignored_ids);
+            }
+        }
+
+        if (m_sub_commands_left == 0)
+        {
+            PublishChanges();
+            Finish();
+        }
     }
 
     void GDBStackVariables::OnStart()
     {
+        if (!m_WatchLocalsandArgs)
+        {
+            Finish();
+            return;
+        }
+
         // GDB 11.2: Synopsis
         //
         // -stack-list-variables [ --no-frame-filters ] [ --skip-unavailable ] print-values
@@ -2427,9 +4054,15 @@ m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, "Calling Finished()", Log
         // print also their values; and if it is 2 or --simple-values, print the name, type and
         // value for simple data types, and the name and type for arrays, structures and unions. If the
         // option --no-frame-filters is supplied, then Python frame filters will not be executed.
+        //
+        // Only the names are needed, the values come from the var-objects of the locals.
 
         m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("GDB/MI comamnds \"-stack-list-variables\""), LogPaneLogger::LineType::UserDisplay);
-        m_stack_list_variables_request_id = Execute("-stack-list-variables --skip-unavailable --simple-values");
+        m_stack_info_frame_request_id = Execute("-stack-info-frame");
+        m_frame_base_request_id = Execute("-data-evaluate-expression $fp");
+        m_stack_list_variables_request_id = Execute("-stack-list-variables --skip-unavailable --no-values");
+        m_replies_left = 3;
+        m_sub_commands_left = 3;
     }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
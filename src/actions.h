@@ -11,13 +11,22 @@
 #include <tr1/memory>
 #include <tr1/unordered_map>
 #include <map>
+#include <wx/stopwatch.h>
 
 // GDB includes
+#include "backtrace_cache.h"
 #include "cmd_queue.h"
 #include "definitions.h"
+#include "disassembly_cache.h"
 #include "gdb_logger.h"
+#include "mapped_file.h"
+#include "memory_cache.h"
+#include "memory_dump.h"
+#include "register_cache.h"
+#include "tooltip_cache.h"
 
 class cbDebuggerPlugin;
+class wxProgressDialog;
 
 namespace dbg_mi
 {
@@ -152,19 +161,37 @@ namespace dbg_mi
             GDBGenerateBacktrace(   GDBSwitchToFrameInvoker * switch_to_frame,
                                     GDBBacktraceContainer & backtrace,
                                     GDBCurrentFrame & current_frame,
+                                    BacktraceCache & cache,
                                     LogPaneLogger * logger);
             virtual ~GDBGenerateBacktrace();
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
         protected:
             virtual void OnStart();
         private:
+            struct ListedFrame
+            {
+                cb::shared_ptr<cbStackFrame> frame;
+                BacktraceFrameKey key;
+            };
+            typedef std::vector<ListedFrame> ListedFrames;
+
+            void ParseFrames(ResultParser const & result, int level, ListedFrames & frames);
+            void ParseArguments(CommandID const & id, ResultParser const & result, ListedFrames & frames);
+            /** Keep the frames of the previous stop that did not change, list the others. */
+            void ReuseFrames();
+            void Done();
+
             GDBSwitchToFrameInvoker * m_switch_to_frame;
-            CommandID m_backtrace_id, m_args_id, m_frame_info_id;
+            CommandID m_backtrace_id, m_args_id, m_frame_info_id, m_depth_id, m_rest_id, m_rest_args_id;
             GDBBacktraceContainer & m_backtrace;
             LogPaneLogger * m_logger;
             GDBCurrentFrame & m_current_frame;
-            int m_first_valid, m_old_active_frame;
-            bool m_parsed_backtrace, m_parsed_args, m_parsed_frame_info;
+            BacktraceCache & m_cache;
+            ListedFrames m_prefix;      ///< the innermost frames, listed at every stop
+            ListedFrames m_rest;        ///< frames listed after the prefix, when they could not be reused
+            BacktraceReuse m_reuse;
+            int m_old_active_frame, m_depth, m_pending;
+            bool m_parse_failed, m_reading_rest;
     };
 
     class GDBGenerateThreadsList : public Action
@@ -183,24 +210,22 @@ namespace dbg_mi
 
     class GDBGenerateCPUInfoRegisters : public Action
     {
-        private:
-            struct RegistryData
-            {
-                wxString RegistryName;
-                wxString RegistryValue;
-            };
-
         public:
-            GDBGenerateCPUInfoRegisters(LogPaneLogger * logger);
+            /** showVector: read and show the vector registers as well. */
+            GDBGenerateCPUInfoRegisters(LogPaneLogger * logger, RegisterCache & cache, bool showVector);
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
         protected:
             virtual void OnStart();
         private:
-            bool m_bParsedRegisteryNamesReceived;
-            bool m_bParsedRegisteryValuesReceived;
+            /** Read the shown registers that changed, or were never read. */
+            void ReadStale();
+            void ShowRegisters();
+
+            RegisterCache & m_cache;
+            bool m_show_vector;
             CommandID m_reg_name_data_list_request_id;
+            CommandID m_reg_changed_list_request_id;
             CommandID m_reg_value_data_list_request_id;
-            std::map<long, RegistryData> m_ParsedRegisteryDataReceived;
 
             LogPaneLogger * m_logger;
     };
@@ -208,15 +233,24 @@ namespace dbg_mi
     class GDBGenerateExamineMemory : public Action
     {
         public:
-            GDBGenerateExamineMemory(LogPaneLogger * logger);
+            GDBGenerateExamineMemory(LogPaneLogger * logger, MemoryPageCache & cache, MemorySnapshot & snapshot, MemoryDumpRegistry & dumps);
+            virtual ~GDBGenerateExamineMemory();
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
         protected:
             virtual void OnStart();
         private:
+            void ReadExact();
+            /** Redraw the dialog, unless it already shows this memory. */
+            void Show(uint64_t address, std::vector<uint8_t> const & bytes);
+
             wxString m_symbol;
             uint64_t m_address;
             int m_length;
             CommandID m_examine_memory_request_id;
+            MemoryPageCache & m_cache;
+            MemorySnapshot & m_snapshot;
+            MemoryDumpRegistry & m_dumps;
+            bool m_page_read;   ///< the request reads whole pages into the cache
 
             LogPaneLogger * m_logger;
     };
@@ -224,16 +258,108 @@ namespace dbg_mi
     class GDBMemoryRangeWatchCreateAction : public Action
     {
         public:
-            GDBMemoryRangeWatchCreateAction(cb::shared_ptr<GDBMemoryRangeWatch> const & watch, LogPaneLogger * logger);
+            GDBMemoryRangeWatchCreateAction(cb::shared_ptr<GDBMemoryRangeWatch> const & watch, LogPaneLogger * logger, MemoryPageCache & cache);
+            virtual ~GDBMemoryRangeWatchCreateAction();
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
 
         protected:
             virtual void OnStart();
 
         private:
+            void ReadExact();
+            void ShowMemory(uint64_t address, std::vector<uint8_t> const & bytes);
+
             CommandID m_memory_range_watch_request_id;
 
             cb::shared_ptr<GDBMemoryRangeWatch> m_watch;
+            MemoryPageCache & m_cache;
+            bool m_page_read;   ///< the request reads whole pages into the cache
+
+            LogPaneLogger * m_logger;
+    };
+
+    /** Fill the Examine Memory dialog with bytes read at address. */
+    void ShowExamineMemory(uint64_t address, std::vector<uint8_t> const & bytes);
+
+    /** Write target memory to a file, read in chunks that are decoded straight into the mapped file. */
+    class GDBMemoryDumpAction : public Action
+    {
+        public:
+            static const uint64_t ChunkSize = 1024 * 1024;
+            static const size_t ChunksInFlight = 4;
+
+        public:
+            /** start is an address or an expression, as in the Examine Memory window. path is UTF-8. */
+            GDBMemoryDumpAction(wxString const & start, uint64_t size, std::string const & path, LogPaneLogger * logger, MemoryPageCache & cache, MemoryDumpRegistry & dumps);
+            virtual ~GDBMemoryDumpAction();
+            virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
+
+        protected:
+            virtual void OnStart();
+
+        private:
+            /** Pending chunk reads and their offset in the dump. */
+            typedef std::tr1::unordered_map<CommandID, uint64_t> ChunkMap;
+
+            static const int ProgressRange = 1000;
+
+            uint64_t GetChunkLength(uint64_t offset) const
+            {
+                return (m_size - offset < ChunkSize) ? (m_size - offset) : ChunkSize;
+            }
+
+            void SendChunk(wxString const & address);
+            void SendChunks();
+            bool StoreChunk(ResultParser const & result, uint64_t offset, uint64_t length, wxString & error);
+            void Fail(wxString const & message);
+            void Complete();
+
+            wxString m_start;
+            std::string m_path;
+            MappedFile m_file;
+            uint64_t m_address;
+            uint64_t m_size;
+            uint64_t m_next_offset;
+            uint64_t m_done_bytes;
+            ChunkMap m_chunks;
+            std::vector<MemorySpan> m_unreadable;   ///< not served from the dump later
+            wxProgressDialog * m_progress;
+            wxStopWatch m_stopwatch;
+            bool m_resolving;       ///< the first chunk is read at an expression, its reply gives the address
+            bool m_cancelled;
+            bool m_failed;
+            MemoryPageCache & m_cache;
+            MemoryDumpRegistry & m_dumps;
+
+            LogPaneLogger * m_logger;
+    };
+
+    /** Read all the memory range watches, ranges that overlap or lie close together are read with one request. */
+    class GDBMemoryRangeWatchesUpdateAction : public Action
+    {
+        public:
+            GDBMemoryRangeWatchesUpdateAction(GDBMemoryRangeWatchesContainer const & watches, uint64_t gap, LogPaneLogger * logger, MemoryPageCache & cache);
+            virtual ~GDBMemoryRangeWatchesUpdateAction();
+            virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
+
+        protected:
+            virtual void OnStart();
+
+        private:
+            /** Pending reads, a merged read has no watch. */
+            typedef std::tr1::unordered_map<CommandID, cb::shared_ptr<GDBMemoryRangeWatch> > ReadMap;
+
+            void ReadExact(cb::shared_ptr<GDBMemoryRangeWatch> const & watch);
+            void SliceMergedReads();
+            void FinishIfDone();
+
+            GDBMemoryRangeWatchesContainer m_watches;
+            GDBMemoryRangeWatchesContainer m_merged_watches;    ///< filled from the cache once the merged reads are done
+            ReadMap m_reads;
+            uint64_t m_gap;
+            int m_merged_left;
+            bool m_redraw;          ///< a watch changed, the window is updated once at the end
+            MemoryPageCache & m_cache;
 
             LogPaneLogger * m_logger;
     };
@@ -241,17 +367,31 @@ namespace dbg_mi
     class GDBDisassemble : public Action
     {
         public:
-            GDBDisassemble(wxString disassemblyFlavor, LogPaneLogger * logger);
+            /** pc is the address of the frame to show, 0 if it is not known and has to be asked to GDB. */
+            GDBDisassemble(wxString disassemblyFlavor, uint64_t pc, LogPaneLogger * logger, DisassemblyCache & cache);
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
         protected:
             virtual void OnStart();
         private:
-            void ParseASMInsmLine(cbDisassemblyDlg * dialog, const ResultValue * pASMLineItem, int iASMIndex);
+            /** Pending "-data-disassemble" reads. */
+            typedef std::tr1::unordered_map<CommandID, DisassemblyWindow> WindowMap;
+
+            void ParseASMInsmLine(DisassemblyRange & range, const ResultValue * pASMLineItem, int iASMIndex);
+            /** Show the code around the pc, reading what is not cached. */
+            void Locate();
+            void ReadWindows(uint64_t start, uint64_t end);
+            void ShowView();
+            void FinishIfDone();
             wxString m_disassemblyFlavor;
+            uint64_t m_pc;
+            int m_mode;
+            bool m_show;            ///< the view was not cached, it is shown once the reads are done
+            wxString m_function;
             CommandID m_disassemble_frame_info_request_id;
-            CommandID m_disassemble_data_request_id;
+            WindowMap m_windows;
 
             LogPaneLogger * m_logger;
+            DisassemblyCache & m_cache;
     };
 
     template<typename Notification>
@@ -309,6 +449,65 @@ namespace dbg_mi
             bool m_user_action;
     };
 
+    /** Changes to the watch trees found while an action parses GDB output. */
+    class WatchChangeSet
+    {
+        public:
+            enum Kind
+            {
+                Added = 0,
+                Removed,
+                ValueChanged,
+                ChildrenChanged,
+                KindCount
+            };
+
+        public:
+            WatchChangeSet()
+            {
+                Clear();
+            }
+
+            void Add(Kind kind, int count = 1)
+            {
+                m_counts[kind] += count;
+            }
+
+            int GetCount(Kind kind) const
+            {
+                return m_counts[kind];
+            }
+
+            bool IsEmpty() const
+            {
+                return (m_counts[Added] + m_counts[Removed] + m_counts[ValueChanged] + m_counts[ChildrenChanged]) == 0;
+            }
+
+            void Clear()
+            {
+                for (int kind = 0; kind < KindCount; ++kind)
+                {
+                    m_counts[kind] = 0;
+                }
+            }
+
+            wxString MakeDebugString() const
+            {
+                return wxString::Format("added %d, removed %d, value changed %d, children changed %d",
+                                        m_counts[Added], m_counts[Removed], m_counts[ValueChanged], m_counts[ChildrenChanged]);
+            }
+
+        private:
+            int m_counts[KindCount];
+    };
+
+    /** Send the debugger updated events requested with UpdateWatches() since the last flush, one per window type.
+     *
+     * Called once the plugin has dispatched a batch of GDB output, so several actions finishing in the same
+     * batch cause a single refresh of the watches dialog.
+     */
+    void FlushWatchUpdates(LogPaneLogger * logger);
+
     class GDBWatchBaseAction : public Action
     {
         public:
@@ -319,11 +518,20 @@ namespace dbg_mi
             void ExecuteListCommand(cb::shared_ptr<GDBWatch> watch, cb::shared_ptr<GDBWatch> parent = cb::shared_ptr<GDBWatch>());
             void ExecuteListCommand(wxString const & watch_id, cb::shared_ptr<GDBWatch> parent);
             bool ParseListCommand(CommandID const & id, ResultValue const & value);
+            /** Refresh the watches window if m_changes has anything, or if the previous refresh highlighted changed values. */
+            void PublishChanges();
+            /** Check the time GDB spent on the commands of the action against WatchBudget::time_budget_ms,
+             *  a watch over budget stops being updated on every step. */
+            void CheckTimeBudget(cb::shared_ptr<GDBWatch> const & watch);
+            void CheckTimeBudget(cb::shared_ptr<GDBWatch> const & watch, uint64_t elapsed_ns);
+            /** Fill a local created with "-var-create - * name", the commands whose replies do not matter go to ignored_ids. */
+            void ParseCreatedLocal(cb::shared_ptr<GDBWatch> const & local, ResultParser const & result, std::vector<CommandID> & ignored_ids);
 
         protected:
             typedef std::tr1::unordered_map<CommandID, cb::shared_ptr<GDBWatch> > ListCommandParentMap;
         protected:
             ListCommandParentMap m_parent_map;
+            WatchChangeSet m_changes;
             GDBWatchesContainer & m_watches;
             LogPaneLogger * m_logger;
             int m_sub_commands_left;
@@ -354,20 +562,61 @@ namespace dbg_mi
     {
         public:
             GDBWatchCreateTooltipAction(cb::shared_ptr<GDBWatch> const & watch, GDBWatchesContainer & watches,
-                                     LogPaneLogger * logger, wxRect const & rect) :
+                                     LogPaneLogger * logger, wxRect const & rect, TooltipCache & cache, int thread, int frame) :
                 GDBWatchCreateAction(watch, watches, logger, true),
-                m_rect(rect)
+                m_rect(rect),
+                m_cache(cache),
+                m_request(cache.NextRequest()),
+                m_epoch(cache.GetEpoch()),
+                m_thread(thread),
+                m_frame(frame),
+                m_cancelled(false)
             {
             }
             virtual ~GDBWatchCreateTooltipAction();
+        protected:
+            virtual void OnStart();
         private:
             wxRect m_rect;
+            TooltipCache & m_cache;
+            int m_request;
+            unsigned m_epoch;
+            int m_thread;
+            int m_frame;
+            bool m_cancelled;
+    };
+
+    /** Create the var-objects of many watches at once, e.g. the watches loaded from the project.
+     *
+     * All the -var-create commands are sent together, then the first level of children of the
+     * expanded watches is listed, again all together. The watches window is refreshed once at the
+     * end instead of once per watch.
+     */
+    class GDBWatchesCreateAction : public GDBWatchBaseAction
+    {
+        public:
+            GDBWatchesCreateAction(std::vector<cb::shared_ptr<GDBWatch>> const & new_watches, GDBWatchesContainer & watches, LogPaneLogger * logger);
+            virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
+
+        protected:
+            virtual void OnStart();
+
+        private:
+            void ParseCreate(cb::shared_ptr<GDBWatch> const & watch, ResultParser const & result);
+
+        private:
+            std::vector<cb::shared_ptr<GDBWatch>> m_new_watches;
+            std::vector<cb::shared_ptr<GDBWatch>> m_list_children;
+            ListCommandParentMap m_create_map;
+            uint64_t m_budget_mark_ns;      ///< GDB time of the action when the previous result arrived
     };
 
     class GDBWatchesUpdateAction : public GDBWatchBaseAction
     {
         public:
             GDBWatchesUpdateAction(GDBWatchesContainer & watches, LogPaneLogger * logger);
+            /** Only refresh expanded_watch, expanded again after its children were frozen by a collapse. */
+            GDBWatchesUpdateAction(GDBWatchesContainer & watches, LogPaneLogger * logger, cb::shared_ptr<GDBWatch> const & expanded_watch);
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
 
         protected:
@@ -375,7 +624,14 @@ namespace dbg_mi
 
         private:
             bool ParseUpdate(ResultParser const & result);
+            void UpdateFrozenState(cb::shared_ptr<GDBWatch> const & watch, bool visible);
+            /** A local whose var-object is out of scope or invalid gets a new one in the selected frame. */
+            bool RecreateLocal(cb::shared_ptr<GDBWatch> const & watch);
+            cb::shared_ptr<GDBWatch> m_expanded_watch;
             CommandID   m_update_command;
+            std::vector<CommandID> m_frozen_commands;
+            std::vector<CommandID> m_ignored_ids;
+            ListCommandParentMap m_recreate_map;
     };
 
     class GDBWatchExpandedAction : public GDBWatchBaseAction
@@ -389,6 +645,8 @@ namespace dbg_mi
 
         private:
             CommandID m_update_id;
+            CommandID m_unfreeze_id;
+            std::vector<CommandID> m_delete_ids;
             cb::shared_ptr<GDBWatch> m_watch;
             cb::shared_ptr<GDBWatch> m_expanded_watch;
     };
@@ -413,21 +671,60 @@ namespace dbg_mi
             cb::shared_ptr<GDBWatch> m_collapsed_watch;
     };
 
-    class GDBStackVariables : public Action
+    /** Fetch the value of a watch cut by WatchBudget::max_string_chars, lifting GDB's "print elements" for this one evaluation. */
+    class GDBWatchFetchFullValueAction : public GDBWatchBaseAction
     {
         public:
-            GDBStackVariables(LogPaneLogger * logger, cb::shared_ptr<dbg_mi::GDBWatch> watchLocalsandArgs, bool bWatchFuncLocalsArgs);
+            GDBWatchFetchFullValueAction(cb::shared_ptr<GDBWatch> const & watch, GDBWatchesContainer & watches, LogPaneLogger * logger) :
+                GDBWatchBaseAction(watches, logger),
+                m_watch(watch)
+            {
+            }
+
+            virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
+        protected:
+            virtual void OnStart();
+
+        private:
+            cb::shared_ptr<GDBWatch> m_watch;
+            CommandID m_evaluate_id;
+    };
+
+    /** Keep the children of the locals pseudo watch in sync with the selected frame.
+     *
+     * Every local and argument is a var-object created for the frame. While the debuggee stays in
+     * the same function and frame the var-objects are kept, GDBWatchesUpdateAction refreshes their
+     * values with -var-update and their expanded children survive the step. Only the names are
+     * listed here to find the locals that came into or went out of scope.
+     */
+    class GDBStackVariables : public GDBWatchBaseAction
+    {
+        public:
+            GDBStackVariables(LogPaneLogger * logger, cb::shared_ptr<dbg_mi::GDBWatch> watchLocalsandArgs, bool bWatchFuncLocalsArgs, GDBWatchesContainer & watches, int thread_id);
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result);
 
         protected:
             virtual void OnStart();
 
+        private:
+            void Reconcile();
+            void DeleteLocal(cb::shared_ptr<GDBWatch> const & local);
+
         private:
             cb::shared_ptr<dbg_mi::GDBWatch> m_WatchLocalsandArgs;
             bool m_bWatchFuncLocalsArgs;
+            CommandID m_stack_info_frame_request_id;
             CommandID m_stack_list_variables_request_id;
-
-            LogPaneLogger * m_logger;
+            CommandID m_frame_base_request_id;
+            ListCommandParentMap m_create_map;
+            std::vector<CommandID> m_ignored_ids;
+            std::vector<wxString> m_names;
+            wxString m_frame_key;
+            wxString m_frame_function;
+            wxString m_frame_level;
+            wxString m_frame_base;
+            int m_thread_id;
+            int m_replies_left;
     };
 
 
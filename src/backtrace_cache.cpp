@@ -0,0 +1,113 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <algorithm>
+
+// GDB includes
+#include "backtrace_cache.h"
+
+namespace dbg_mi
+{
+    BacktraceCache::BacktraceCache() :
+        m_thread(-1),
+        m_depth(-1),
+        m_stepped(false),
+        m_read(0),
+        m_reused(0)
+    {
+    }
+
+    void BacktraceCache::SetThread(int thread)
+    {
+        if (thread != m_thread)
+        {
+            m_thread = thread;
+            m_frames.clear();
+            m_depth = -1;
+        }
+    }
+
+    BacktraceReuse BacktraceCache::Plan(std::vector<BacktraceFrameKey> const & prefix, int depth) const
+    {
+        int const listed = static_cast<int>(prefix.size());
+        BacktraceReuse reuse;
+        reuse.oldLevel = -1;
+        reuse.newLevel = listed;
+        reuse.count = 0;
+        reuse.readFrom = listed;
+        reuse.readTo = std::max(listed, std::min(depth, int(MaxFrames)));
+
+        // Frame 0 is where the thread stopped, only a caller frame tells where the chain joins the old one
+        if ((reuse.readFrom >= reuse.readTo) || (listed < 2) || (m_depth < 0) || m_frames.empty() || !m_stepped)
+        {
+            return reuse;
+        }
+
+        // Counting stopped at the limit, the distance from the outermost frame is not known
+        if ((depth >= MaxDepth) || (m_depth >= MaxDepth))
+        {
+            return reuse;
+        }
+
+        int const anchor = listed - 1;
+        int const old = anchor - (depth - m_depth);
+
+        if ((old < 0) || (old >= static_cast<int>(m_frames.size())))
+        {
+            return reuse;
+        }
+
+        BacktraceFrameKey const & before = m_frames[old];
+
+        if ((before.address != prefix[anchor].address) || (before.function != prefix[anchor].function))
+        {
+            return reuse;
+        }
+
+        reuse.count = std::min(static_cast<int>(m_frames.size()) - old - 1, reuse.readTo - listed);
+
+        if (reuse.count > 0)
+        {
+            reuse.oldLevel = old + 1;
+        }
+        else
+        {
+            reuse.count = 0;
+        }
+
+        // The previous backtrace was cut at MaxFrames, a shallower stack shows frames it did not have
+        reuse.readFrom = listed + reuse.count;
+        return reuse;
+    }
+
+    void BacktraceCache::Set(std::vector<BacktraceFrameKey> const & frames, int depth)
+    {
+        m_frames = frames;
+        m_depth = depth;
+    }
+
+    void BacktraceCache::Clear()
+    {
+        m_thread = -1;
+        m_depth = -1;
+        m_stepped = false;
+        m_frames.clear();
+    }
+
+    size_t BacktraceCache::GetMemoryBytes() const
+    {
+        size_t bytes = m_frames.capacity() * sizeof(BacktraceFrameKey);
+
+        for (std::vector<BacktraceFrameKey>::const_iterator it = m_frames.begin(); it != m_frames.end(); ++it)
+        {
+            bytes += it->function.capacity();
+        }
+
+        return bytes;
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_BACKTRACE_CACHE_H_
+#define _DEBUGGER_GDB_MI_BACKTRACE_CACHE_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dbg_mi
+{
+    /** What tells a frame apart from the others of a thread. */
+    struct BacktraceFrameKey
+    {
+        uint64_t address;       ///< pc of frame 0, return address of the callers
+        std::string function;   ///< UTF-8
+    };
+
+    /** How the backtrace of a stop is built from the previous one. */
+    struct BacktraceReuse
+    {
+        int oldLevel;   ///< first frame of the previous backtrace kept, -1 if none is
+        int newLevel;   ///< level it has now
+        int count;      ///< frames kept
+        int readFrom;   ///< frames [readFrom, readTo) still have to be listed by GDB
+        int readTo;
+    };
+
+    /** Frames of the backtrace shown at the previous stop.
+     *
+     * While stepping usually only the innermost frames change. At a stop only the first
+     * PrefixFrames frames and the depth of the stack are asked to GDB. GDB/MI does not tell the
+     * CFA of a frame, so a caller frame is recognised by its return address, its function and its
+     * distance from the outermost frame (depth - level): when the outermost frame of the prefix
+     * matches a frame of the previous backtrace, the frames beyond it are the same and are kept,
+     * along with their arguments. Stepping into or out of a function is handled the same way,
+     * only the levels shift.
+     *
+     * That is only sound after a step or a finish: the thread left at most the frame it stepped
+     * in, so the callers of its caller are still there. After a breakpoint or a signal the same
+     * function can have been reached from other callers with the same return address and depth,
+     * everything is listed again then.
+     *
+     * Does not depend on wxWidgets.
+     */
+    class BacktraceCache
+    {
+        public:
+            /** Frames listed in the backtrace window. */
+            static const int MaxFrames = 30;
+            /** Frames listed at every stop when there is a previous backtrace. */
+            static const int PrefixFrames = 3;
+            /** GDB stops counting the depth there, so a deep stack is not unwound at every stop.
+             * The depth of a deeper stack is not known and nothing is reused.
+             */
+            static const int MaxDepth = 256;
+
+        public:
+            BacktraceCache();
+
+            /** Thread of the next backtrace, the frames of another thread are dropped. */
+            void SetThread(int thread);
+
+            /** The thread stopped at the end of a step or a finish, frames can be reused. */
+            void SetStepped(bool stepped)
+            {
+                m_stepped = stepped;
+            }
+
+            bool IsEmpty() const
+            {
+                return m_frames.empty();
+            }
+
+            size_t GetCount() const
+            {
+                return m_frames.size();
+            }
+
+            BacktraceFrameKey const & GetFrame(size_t level) const
+            {
+                return m_frames[level];
+            }
+
+            /** prefix: frames 0.. listed at this stop, depth: "-stack-info-depth MaxDepth" of this stop. */
+            BacktraceReuse Plan(std::vector<BacktraceFrameKey> const & prefix, int depth) const;
+
+            /** The backtrace shown now, depth -1 if it is not known (nothing is reused then). */
+            void Set(std::vector<BacktraceFrameKey> const & frames, int depth);
+
+            void Clear();
+
+            /** Frames listed by GDB and frames kept from the previous stop. */
+            void CountFrames(int read, int reused)
+            {
+                m_read += read;
+                m_reused += reused;
+            }
+
+            unsigned long GetRead() const
+            {
+                return m_read;
+            }
+
+            unsigned long GetReused() const
+            {
+                return m_reused;
+            }
+
+            size_t GetMemoryBytes() const;
+
+        private:
+            int m_thread;
+            int m_depth;
+            bool m_stepped;
+            std::vector<BacktraceFrameKey> m_frames;
+            unsigned long m_read;
+            unsigned long m_reused;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_BACKTRACE_CACHE_H_
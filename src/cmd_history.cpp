@@ -0,0 +1,110 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <wx/time.h>
+
+// GDB includes
+#include "cmd_history.h"
+
+namespace dbg_mi
+{
+    CommandHistory::CommandHistory(size_t capacity) :
+        m_entries(capacity > 0 ? capacity : 1),
+        m_next(0),
+        m_count(0),
+        m_total(0)
+    {
+    }
+
+    wxString const * CommandHistory::Intern(wxString const & command)
+    {
+        Pool::iterator it = m_pool.find(command);
+
+        if (it == m_pool.end())
+        {
+            it = m_pool.insert(Pool::value_type(command, 0)).first;
+        }
+
+        ++it->second;
+        // Pointers to the keys of an unordered_map stay valid until the element is erased
+        return &it->first;
+    }
+
+    void CommandHistory::Release(wxString const * command)
+    {
+        Pool::iterator it = m_pool.find(*command);
+
+        if (it != m_pool.end() && --it->second == 0)
+        {
+            m_pool.erase(it);
+        }
+    }
+
+    void CommandHistory::Add(int32_t action, int32_t command_in_action, wxString const & command)
+    {
+        Entry & entry = m_entries[m_next];
+
+        if (m_count == m_entries.size())
+        {
+            Release(entry.command);
+        }
+        else
+        {
+            ++m_count;
+        }
+
+        entry.action = action;
+        entry.command_in_action = command_in_action;
+        entry.timestamp_ms = wxGetUTCTimeMillis();
+        entry.command = Intern(command);
+        m_next = (m_next + 1) % m_entries.size();
+        ++m_total;
+    }
+
+    void CommandHistory::Clear()
+    {
+        m_pool.clear();
+        m_next = 0;
+        m_count = 0;
+        m_total = 0;
+    }
+
+    CommandHistory::Entry const & CommandHistory::GetEntry(size_t index) const
+    {
+        size_t const oldest = (m_count == m_entries.size()) ? m_next : 0;
+        return m_entries[(oldest + index) % m_entries.size()];
+    }
+
+    bool CommandHistory::Find(int32_t action, int32_t command_in_action, wxString & command) const
+    {
+        for (size_t index = m_count; index > 0; --index)
+        {
+            Entry const & entry = GetEntry(index - 1);
+
+            if ((entry.action == action) && (entry.command_in_action == command_in_action))
+            {
+                command = *entry.command;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    size_t CommandHistory::GetInternedBytes() const
+    {
+        size_t bytes = 0;
+
+        for (Pool::const_iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+        {
+            bytes += sizeof(Pool::value_type) + it->first.length() * sizeof(wxChar);
+        }
+
+        return bytes;
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,90 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_CMD_HISTORY_H_
+#define _DEBUGGER_GDB_MI_CMD_HISTORY_H_
+
+// System and library includes
+#include <unordered_map>
+#include <vector>
+#include <wx/hashmap.h>
+#include <wx/longlong.h>
+#include <wx/string.h>
+
+namespace dbg_mi
+{
+    /** Fixed capacity history of the commands sent to GDB.
+     *
+     * The history is a ring of small records, once it is full the oldest record is overwritten.
+     * The command text is interned: identical commands (-var-update 1 *, -stack-info-frame, ...)
+     * share one string, and a string is released when the last record using it is overwritten.
+     */
+    class CommandHistory
+    {
+        public:
+            struct Entry
+            {
+                int32_t action;
+                int32_t command_in_action;
+                wxLongLong timestamp_ms;
+                wxString const * command;
+            };
+
+            static const size_t DefaultCapacity = 10000;
+
+        public:
+            explicit CommandHistory(size_t capacity = DefaultCapacity);
+
+            void Add(int32_t action, int32_t command_in_action, wxString const & command);
+            void Clear();
+
+            /** Number of records kept, at most GetCapacity(). */
+            size_t GetCount() const
+            {
+                return m_count;
+            }
+
+            size_t GetCapacity() const
+            {
+                return m_entries.size();
+            }
+
+            /** Number of commands added since the last Clear(), including the ones already overwritten. */
+            unsigned long long GetTotalCount() const
+            {
+                return m_total;
+            }
+
+            /** Record by age, 0 is the oldest record still kept. */
+            Entry const & GetEntry(size_t index) const;
+
+            /** Search the most recent records for the command sent with the given id. */
+            bool Find(int32_t action, int32_t command_in_action, wxString & command) const;
+
+            size_t GetInternedCount() const
+            {
+                return m_pool.size();
+            }
+
+            size_t GetInternedBytes() const;
+
+        private:
+            typedef std::unordered_map<wxString, unsigned long, wxStringHash, wxStringEqual> Pool;
+
+            wxString const * Intern(wxString const & command);
+            void Release(wxString const * command);
+
+        private:
+            std::vector<Entry> m_entries;
+            Pool m_pool;
+            size_t m_next;
+            size_t m_count;
+            unsigned long long m_total;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_CMD_HISTORY_H_
@@ -5,6 +5,7 @@
 */
 
 #include "cmd_queue.h"
+#include "mi_recorder.h"
 #include <wx/wxcrt.h>
 
 namespace dbg_mi
@@ -52,7 +53,10 @@ namespace dbg_mi
 
     CommandExecutor::CommandExecutor() :
         m_last(0),
-        m_logger(NULL)
+        m_last_result_size(0),
+        m_last_result_ns(0),
+        m_logger(NULL),
+        m_recorder(NULL)
     {
     }
 
@@ -68,7 +72,9 @@ namespace dbg_mi
         {
             m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("cmd: %s%s",  id.ToString(), cmd), LogPaneLogger::LineType::Command);
         }
-        AddCommandQueue(id.ToString() + cmd);
+        AddCommandQueue(id, cmd);
+        RecordTraffic(MIRecorder::KindSend, id, cmd);
+        TraceSpan span("DoExecute", id.GetActionID(), id.GetCommandID());
 
         if (DoExecute(id, cmd))
         {
@@ -86,16 +92,21 @@ namespace dbg_mi
         {
             m_logger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("cmd: %s%s",  id.ToString(), cmd), LogPaneLogger::LineType::Command);
         }
-        AddCommandQueue(id.ToString() + cmd);
+        AddCommandQueue(id, cmd);
+        RecordTraffic(MIRecorder::KindSend, id, cmd);
+        TraceSpan span("DoExecute", id.GetActionID(), id.GetCommandID());
 
         DoExecute(id, cmd);
     }
 
     bool CommandExecutor::ProcessOutput(wxString const & output)
     {
+        TraceSpan span("ProcessOutput");
         Result r;
+        bool parsed = dbg_mi::ParseGDBOutputLine(output, r.id, r.output);
+        RecordTraffic(MIRecorder::KindReceive, r.id, output);
 
-        if (dbg_mi::ParseGDBOutputLine(output, r.id, r.output))
+        if (parsed)
         {
             if (m_logger)
             {
@@ -125,6 +136,7 @@ namespace dbg_mi
 
     dbg_mi::ResultParser * CommandExecutor::GetResult(dbg_mi::CommandID & id)
     {
+        TraceSpan span("GetResult");
         dbg_mi::ResultParser * parser = new dbg_mi::ResultParser;
 
         if (m_results.empty())
@@ -138,8 +150,15 @@ namespace dbg_mi
         {
             Result const & r = m_results.front();
             id = r.id;
+            m_last_result_size = r.output.length();
+            span.SetCommand(id.GetActionID(), id.GetCommandID());
+            bool parsed;
+            {
+                TraceSpan parseSpan("ResultParser::Parse", id.GetActionID(), id.GetCommandID());
+                parsed = parser->Parse(r.output);
+            }
 
-            if (parser->Parse(r.output))
+            if (parsed)
             {
                 dbg_mi::ResultParser::Class rClass = parser->GetResultClass();
 
@@ -190,36 +209,54 @@ namespace dbg_mi
         return m_logger;
     }
 
+    void CommandExecutor::SetRecorder(dbg_mi::MIRecorder * recorder)
+    {
+        m_recorder = recorder;
+    }
+
+    dbg_mi::MIRecorder * CommandExecutor::GetRecorder()
+    {
+        return m_recorder;
+    }
+
+    void CommandExecutor::RecordTraffic(int kind, dbg_mi::CommandID const & id, wxString const & text)
+    {
+        if (m_recorder && m_recorder->IsOpen())
+        {
+            wxScopedCharBuffer const & utf8 = text.utf8_str();
+            m_recorder->Record(static_cast<MIRecorder::RecordKind>(kind), id.GetActionID(), id.GetCommandID(), utf8.data(), utf8.length());
+        }
+    }
+
     int32_t CommandExecutor::GetLastID() const
     {
         return m_last;
     }
 
-    void CommandExecutor::AddCommandQueue(wxString const & command)
+    void CommandExecutor::AddCommandQueue(dbg_mi::CommandID const & id, wxString const & command)
     {
-        m_CMDQueue.push_back(command);
+        m_CMDQueue.Add(id.GetActionID(), id.GetCommandID(), command);
     }
 
     int CommandExecutor::GetCommandQueueCount() const
     {
-        return m_CMDQueue.size();
+        return m_CMDQueue.GetCount();
     }
 
-    wxString const & CommandExecutor::GetQueueCommand(long index) const
+    wxString CommandExecutor::GetQueueCommand(long index) const
     {
-        static const wxString emptyString = wxEmptyString;
-
-        if (index < (long) m_CMDQueue.size())
+        if ((index >= 0) && (index < (long) m_CMDQueue.GetCount()))
         {
-            return m_CMDQueue[index];
+            CommandHistory::Entry const & entry = m_CMDQueue.GetEntry(index);
+            return CommandID(entry.action, entry.command_in_action).ToString() + *entry.command;
         }
 
-        return  emptyString;
+        return wxEmptyString;
     }
 
     void CommandExecutor::ClearQueueCommand()
     {
-        m_CMDQueue.clear();
+        m_CMDQueue.Clear();
     }
 
     bool CommandExecutor::HasOutput() const
@@ -227,6 +264,18 @@ namespace dbg_mi
         return !m_results.empty();
     }
 
+    size_t CommandExecutor::GetPendingResultsBytes() const
+    {
+        size_t bytes = 0;
+
+        for (Results::const_iterator it = m_results.begin(); it != m_results.end(); ++it)
+        {
+            bytes += sizeof(Result) + it->output.length() * sizeof(wxChar);
+        }
+
+        return bytes;
+    }
+
     ActionsMap::ActionsMap() :
         m_last_id(1)
     {
@@ -303,6 +352,8 @@ namespace dbg_mi
             return;
         }
 
+        TraceSpan span("ActionsMap::Run");
+
         LogPaneLogger * logger = executor.GetLogger();
         bool first = true;
 
@@ -321,6 +372,11 @@ namespace dbg_mi
                 action.Start();
             }
 
+            if (action.HasPendingCommands())
+            {
+                action.SetDispatchTime(SpanTracer::Now());
+            }
+
             while (action.HasPendingCommands())
             {
                 CommandID id;
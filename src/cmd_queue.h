@@ -11,14 +11,20 @@
 #include <deque>
 #include <ostream>
 #include <tr1/unordered_map>
+#include <typeinfo>
 #include <wx/string.h>
 
 // GDB includes
+#include "cmd_history.h"
 #include "cmd_result_parser.h"
 #include "gdb_logger.h"
+#include "span_tracer.h"
+#include "stall_watchdog.h"
 
 namespace dbg_mi
 {
+    class MIRecorder;
+
     class CommandID
     {
         public:
@@ -106,7 +112,9 @@ namespace dbg_mi
                 m_started(false),
                 m_finished(false),
                 m_wait_previous(false),
-                m_StallCountActionsMapRun(0)
+                m_StallCountActionsMapRun(0),
+                m_dispatched_ns(0),
+                m_gdb_ns(0)
             {
             }
 
@@ -204,6 +212,32 @@ namespace dbg_mi
                 m_StallCountActionsMapRun = 0;
             }
 
+            /** The pending commands were written to GDB at now_ns. */
+            void SetDispatchTime(uint64_t now_ns)
+            {
+                m_dispatched_ns = now_ns;
+            }
+
+            /** A result of the action arrived at now_ns, the previous result of any action at previous_result_ns.
+             *
+             * GDB runs the commands one after the other, so it worked on this one since the later of
+             * the two: the time the action spent queued behind other commands is not counted.
+             */
+            void AddGDBTime(uint64_t previous_result_ns, uint64_t now_ns)
+            {
+                uint64_t const start = (previous_result_ns > m_dispatched_ns) ? previous_result_ns : m_dispatched_ns;
+
+                if (now_ns > start)
+                {
+                    m_gdb_ns += now_ns - start;
+                }
+            }
+
+            uint64_t GetGDBTimeNs() const
+            {
+                return m_gdb_ns;
+            }
+
         public:
             virtual void OnCommandOutput(CommandID const & id, ResultParser const & result) = 0;
         protected:
@@ -216,6 +250,8 @@ namespace dbg_mi
             bool m_finished;
             bool m_wait_previous;
             long m_StallCountActionsMapRun;
+            uint64_t m_dispatched_ns;
+            uint64_t m_gdb_ns;
     };
 
     class CommandExecutor
@@ -237,26 +273,56 @@ namespace dbg_mi
             bool ProcessOutput(wxString const & output);
             void Clear();
             dbg_mi::ResultParser * GetResult(dbg_mi::CommandID & id);
+            size_t GetPendingResultsCount() const
+            {
+                return m_results.size();
+            }
+            size_t GetPendingResultsBytes() const;
+            size_t GetLastResultSize() const
+            {
+                return m_last_result_size;
+            }
             void SetLogger(dbg_mi::LogPaneLogger * logger);
             dbg_mi::LogPaneLogger * GetLogger();
+            void SetRecorder(dbg_mi::MIRecorder * recorder);
+            dbg_mi::MIRecorder * GetRecorder();
             int32_t GetLastID() const;
-            void AddCommandQueue(wxString const & command);
+            void AddCommandQueue(dbg_mi::CommandID const & id, wxString const & command);
             int GetCommandQueueCount() const;
-            wxString const & GetQueueCommand(long index) const;
+            wxString GetQueueCommand(long index) const;
             void ClearQueueCommand();
+            dbg_mi::CommandHistory const & GetCommandHistory() const
+            {
+                return m_CMDQueue;
+            }
+
+            /** Arrival of the last command result, SpanTracer::Now() time. */
+            uint64_t GetLastResultTime() const
+            {
+                return m_last_result_ns;
+            }
+
+            void SetLastResultTime(uint64_t now_ns)
+            {
+                m_last_result_ns = now_ns;
+            }
 
         protected:
             virtual bool DoExecute(dbg_mi::CommandID const & id, wxString const & cmd) = 0;
             virtual void DoClear() = 0;
+            void RecordTraffic(int kind, dbg_mi::CommandID const & id, wxString const & text);
 
         protected:
             typedef std::deque<Result> Results;
             Results m_results;
             int32_t m_last;
+            size_t m_last_result_size;
+            uint64_t m_last_result_ns;
 
-            std::vector<wxString> m_CMDQueue;
+            dbg_mi::CommandHistory m_CMDQueue;
 
             dbg_mi::LogPaneLogger * m_logger;
+            dbg_mi::MIRecorder * m_recorder;
     };
 
     class ActionsMap
@@ -290,6 +356,8 @@ namespace dbg_mi
     template<typename OnNotify>
     bool DispatchResults(CommandExecutor & exec, ActionsMap & actions_map, OnNotify & on_notify)
     {
+        TraceSpan span("DispatchResults");
+
         while (exec.HasOutput())
         {
             CommandID id;
@@ -304,9 +372,20 @@ namespace dbg_mi
                 case ResultParser::Result:
                 {
                     Action * action = actions_map.Find(id.GetActionID());
+                    uint64_t const now = SpanTracer::Now();
+
+                    if (action)
+                    {
+                        action->AddGDBTime(exec.GetLastResultTime(), now);
+                    }
+
+                    exec.SetLastResultTime(now);
 
                     if (action)
                     {
+                        TraceSpan actionSpan("OnCommandOutput", id.GetActionID(), id.GetCommandID(), typeid(*action).name());
+                        StallScope stallScope(StallWatchdog::EntryOnCommandOutput, &exec);
+                        stallScope.Attribute(typeid(*action).name(), id.GetActionID(), id.GetCommandID(), exec.GetLastResultSize());
                         action->OnCommandOutput(id, *parser);
                     }
                 }
@@ -10,6 +10,8 @@
 
 namespace dbg_mi
 {
+    long ResultValue::s_live_count = 0;
+    long ResultValue::s_live_bytes = 0;
 
     void find_and_replace(wxString & source, const wxString & find, wxString const & replace)
     {
@@ -331,6 +333,7 @@ namespace dbg_mi
     {
         assert(value);
         m_value.tuple.push_back(value);
+        s_live_bytes += sizeof(ResultValue *);
     }
 
     ResultValue const * ResultValue::GetTupleValue(wxString const & key) const
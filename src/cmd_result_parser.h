@@ -35,11 +35,51 @@ namespace dbg_mi
             ResultValue() :
                 m_type(Simple)
             {
+                TrackCreated();
             }
             ResultValue(wxChar const * name, Type type) :
                 m_name(name),
                 m_type(type)
             {
+                TrackCreated();
+            }
+            ResultValue(ResultValue const & o) :
+                m_name(o.m_name),
+                m_type(o.m_type),
+                m_value(o.m_value)
+            {
+                TrackCreated();
+            }
+            ~ResultValue()
+            {
+                --s_live_count;
+                s_live_bytes -= sizeof(ResultValue) + GetStringBytes();
+            }
+
+            ResultValue & operator =(ResultValue const & o)
+            {
+                if (this != &o)
+                {
+                    s_live_bytes -= GetStringBytes();
+                    m_name = o.m_name;
+                    m_type = o.m_type;
+                    m_value = o.m_value;
+                    s_live_bytes += GetStringBytes();
+                }
+
+                return *this;
+            }
+
+            /** Number of ResultValue nodes currently alive, used for the memory statistics. */
+            static long GetLiveCount()
+            {
+                return s_live_count;
+            }
+
+            /** Approximate heap and object bytes of the live nodes. */
+            static long GetLiveBytes()
+            {
+                return s_live_bytes;
             }
 
             bool operator ==(ResultValue const & o) const
@@ -69,11 +109,13 @@ namespace dbg_mi
 
             void SetName(wxString const & name)
             {
+                s_live_bytes += (static_cast<long>(name.length()) - static_cast<long>(m_name.length())) * sizeof(wxChar);
                 m_name = name;
             }
             void SetSimpleValue(wxString const & value)
             {
                 assert(m_type == Simple);
+                s_live_bytes += (static_cast<long>(value.length()) - static_cast<long>(m_value.simple.length())) * sizeof(wxChar);
                 m_value.simple = value;
             }
 
@@ -105,6 +147,17 @@ namespace dbg_mi
             ResultValue const * GetTupleValueByIndex(int index) const;
             wxString MakeDebugString() const;
         private:
+            void TrackCreated()
+            {
+                ++s_live_count;
+                s_live_bytes += sizeof(ResultValue) + GetStringBytes();
+            }
+
+            long GetStringBytes() const
+            {
+                return (m_name.length() + m_value.simple.length()) * sizeof(wxChar) + m_value.tuple.size() * sizeof(ResultValue *);
+            }
+
             Container::iterator FindTupleValue(wxChar const * name)
             {
                 for (Container::iterator it = m_value.tuple.begin(); it != m_value.tuple.end(); ++it)
@@ -130,6 +183,9 @@ namespace dbg_mi
                 return m_value.tuple.end();
             }
         private:
+            static long s_live_count;
+            static long s_live_bytes;
+
             wxString m_name;
             Type     m_type;
 
@@ -0,0 +1,110 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include <wx/button.h>
+#include <wx/datetime.h>
+#include <wx/intl.h>
+#include <wx/string.h>
+
+#include "cmd_history.h"
+#include "cmd_queue.h"
+#include "commandstreamdlg.h"
+
+namespace dbg_mi
+{
+    namespace
+    {
+        enum Columns
+        {
+            ColumnTime = 0,
+            ColumnID,
+            ColumnCommand
+        };
+    }
+
+    const long CommandStreamDlg::ID_LST_COMMANDS = wxNewId();
+    const long CommandStreamDlg::ID_BTN_REFRESH = wxNewId();
+
+    CommandStreamList::CommandStreamList(wxWindow * parent, wxWindowID id, CommandHistory const & history) :
+        wxListCtrl(parent, id, wxDefaultPosition, wxSize(700, 400), wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL | wxLC_HRULES),
+        m_history(history)
+    {
+        InsertColumn(ColumnTime, _("Time"), wxLIST_FORMAT_LEFT, 100);
+        InsertColumn(ColumnID, _("ID"), wxLIST_FORMAT_RIGHT, 110);
+        InsertColumn(ColumnCommand, _("Command"), wxLIST_FORMAT_LEFT, 480);
+    }
+
+    wxString CommandStreamList::OnGetItemText(long item, long column) const
+    {
+        if ((item < 0) || (static_cast<size_t>(item) >= m_history.GetCount()))
+        {
+            return wxEmptyString;
+        }
+
+        CommandHistory::Entry const & entry = m_history.GetEntry(item);
+
+        switch (column)
+        {
+            case ColumnTime:
+                return wxDateTime(entry.timestamp_ms).Format("%H:%M:%S.%l");
+
+            case ColumnID:
+                return CommandID(entry.action, entry.command_in_action).ToString();
+
+            case ColumnCommand:
+                return *entry.command;
+
+            default:
+                return wxEmptyString;
+        }
+    }
+
+    BEGIN_EVENT_TABLE(CommandStreamDlg, wxScrollingDialog)
+        EVT_BUTTON(ID_BTN_REFRESH, CommandStreamDlg::OnRefresh)
+    END_EVENT_TABLE()
+
+    CommandStreamDlg::CommandStreamDlg(wxWindow * parent, CommandHistory const & history) :
+        wxScrollingDialog(parent, wxID_ANY, _("Command stream"), wxDefaultPosition, wxDefaultSize,
+                          wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER | wxMAXIMIZE_BOX | wxMINIMIZE_BOX),
+        m_history(history)
+    {
+        wxBoxSizer * bszMain = new wxBoxSizer(wxVERTICAL);
+        m_list = new CommandStreamList(this, ID_LST_COMMANDS, history);
+        m_list->SetFont(wxFont(8, wxFONTFAMILY_MODERN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+        bszMain->Add(m_list, 1, wxALL | wxEXPAND, 4);
+
+        wxBoxSizer * bszBottom = new wxBoxSizer(wxHORIZONTAL);
+        m_summary = new wxStaticText(this, wxID_ANY, wxEmptyString);
+        bszBottom->Add(m_summary, 1, wxALIGN_CENTER_VERTICAL | wxLEFT, 4);
+        bszBottom->Add(new wxButton(this, ID_BTN_REFRESH, _("Refresh")), 0, wxALL, 4);
+        bszMain->Add(bszBottom, 0, wxEXPAND);
+
+        SetSizerAndFit(bszMain);
+        Reload();
+    }
+
+    void CommandStreamDlg::Reload()
+    {
+        long const count = static_cast<long>(m_history.GetCount());
+        m_list->SetItemCount(count);
+
+        if (count > 0)
+        {
+            m_list->RefreshItems(0, count - 1);
+            m_list->EnsureVisible(count - 1);
+        }
+
+        m_summary->SetLabel(wxString::Format(_("Showing the last %ld of %llu commands (history keeps %lu)"),
+                                             count,
+                                             m_history.GetTotalCount(),
+                                             static_cast<unsigned long>(m_history.GetCapacity())));
+    }
+
+    void CommandStreamDlg::OnRefresh(wxCommandEvent & /*event*/)
+    {
+        Reload();
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#ifndef _DEBUGGER_GDB_MI_COMMANDSTREAMDLG_H_
+#define _DEBUGGER_GDB_MI_COMMANDSTREAMDLG_H_
+
+#include <wx/wxprec.h>
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#include <wx/listctrl.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+#include "scrollingdialog.h"
+
+namespace dbg_mi
+{
+    class CommandHistory;
+
+    /** Virtual list over the CommandHistory ring, only the visible rows are ever formatted. */
+    class CommandStreamList : public wxListCtrl
+    {
+        public:
+            CommandStreamList(wxWindow * parent, wxWindowID id, CommandHistory const & history);
+
+        protected:
+            wxString OnGetItemText(long item, long column) const override;
+
+        private:
+            CommandHistory const & m_history;
+    };
+
+    class CommandStreamDlg : public wxScrollingDialog
+    {
+        public:
+            CommandStreamDlg(wxWindow * parent, CommandHistory const & history);
+
+            /** Resize the list to the current history and scroll to the newest command. */
+            void Reload();
+
+            static const long ID_LST_COMMANDS;
+            static const long ID_BTN_REFRESH;
+
+        private:
+            void OnRefresh(wxCommandEvent & event);
+
+        private:
+            CommandHistory const & m_history;
+            CommandStreamList * m_list;
+            wxStaticText * m_summary;
+
+            DECLARE_EVENT_TABLE()
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_COMMANDSTREAMDLG_H_
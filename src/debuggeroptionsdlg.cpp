@@ -3,6 +3,7 @@
  * http://www.gnu.org/licenses/gpl-3.0.html
  */
 
+#include <algorithm>
 #include <wx/checkbox.h>
 #include <wx/choice.h>
 #include <wx/filedlg.h>
@@ -106,6 +107,16 @@ namespace dbg_mi
         XRCCTRL(*panel, "chkDoNotRun",              wxCheckBox)->SetValue(GetFlag(DoNotRun));
         XRCCTRL(*panel, "chkPrettyPrinters",        wxCheckBox)->SetValue(GetFlag(CheckPrettyPrinters));
         XRCCTRL(*panel, "chkPersistDebugElements",  wxCheckBox)->SetValue(GetFlag(PersistDebugElements));
+        XRCCTRL(*panel, "chkRecordMITraffic",       wxCheckBox)->SetValue(GetFlag(RecordMITraffic));
+        XRCCTRL(*panel, "chkShowVectorRegisters",   wxCheckBox)->SetValue(GetFlag(ShowVectorRegisters));
+        XRCCTRL(*panel, "chkTracePipeline",         wxCheckBox)->SetValue(GetFlag(TracePipeline));
+        XRCCTRL(*panel, "spnRecorderSize",          wxSpinCtrl)->SetValue(GetMIRecorderSizeMB());
+        XRCCTRL(*panel, "spnStallThreshold",        wxSpinCtrl)->SetValue(GetStallThresholdMs());
+        XRCCTRL(*panel, "spnWatchMaxChildren",      wxSpinCtrl)->SetValue(GetWatchMaxChildren());
+        XRCCTRL(*panel, "spnWatchMaxDepth",         wxSpinCtrl)->SetValue(GetWatchMaxDepth());
+        XRCCTRL(*panel, "spnWatchMaxStringChars",   wxSpinCtrl)->SetValue(GetWatchMaxStringChars());
+        XRCCTRL(*panel, "spnWatchTimeBudget",       wxSpinCtrl)->SetValue(GetWatchTimeBudgetMs());
+        XRCCTRL(*panel, "spnMemoryMergeGap",        wxSpinCtrl)->SetValue(GetMemoryMergeGap());
         XRCCTRL(*panel, "choDisassemblyFlavor",     wxChoice)->SetSelection(m_config.ReadInt("disassembly_flavor", 0));
         XRCCTRL(*panel, "txtInstructionSet",        wxTextCtrl)->ChangeValue(m_config.Read("instruction_set", wxEmptyString));
         return panel;
@@ -124,6 +135,16 @@ namespace dbg_mi
         m_config.Write("do_not_run",            XRCCTRL(*panel, "chkDoNotRun",             wxCheckBox)->GetValue());
         m_config.Write("check_pretty_printers", XRCCTRL(*panel, "chkPrettyPrinters",       wxCheckBox)->GetValue());
         m_config.Write("persist_debug_elements",XRCCTRL(*panel, "chkPersistDebugElements", wxCheckBox)->GetValue());
+        m_config.Write("record_mi_traffic",     XRCCTRL(*panel, "chkRecordMITraffic",      wxCheckBox)->GetValue());
+        m_config.Write("show_vector_registers", XRCCTRL(*panel, "chkShowVectorRegisters",  wxCheckBox)->GetValue());
+        m_config.Write("trace_pipeline",        XRCCTRL(*panel, "chkTracePipeline",        wxCheckBox)->GetValue());
+        m_config.Write("mi_recorder_size_mb",   XRCCTRL(*panel, "spnRecorderSize",         wxSpinCtrl)->GetValue());
+        m_config.Write("stall_threshold_ms",    XRCCTRL(*panel, "spnStallThreshold",       wxSpinCtrl)->GetValue());
+        m_config.Write("watch_max_children",    XRCCTRL(*panel, "spnWatchMaxChildren",     wxSpinCtrl)->GetValue());
+        m_config.Write("watch_max_depth",       XRCCTRL(*panel, "spnWatchMaxDepth",        wxSpinCtrl)->GetValue());
+        m_config.Write("watch_max_string_chars",XRCCTRL(*panel, "spnWatchMaxStringChars",  wxSpinCtrl)->GetValue());
+        m_config.Write("watch_time_budget_ms",  XRCCTRL(*panel, "spnWatchTimeBudget",      wxSpinCtrl)->GetValue());
+        m_config.Write("memory_merge_gap",      XRCCTRL(*panel, "spnMemoryMergeGap",       wxSpinCtrl)->GetValue());
         m_config.Write("disassembly_flavor",    XRCCTRL(*panel, "choDisassemblyFlavor",    wxChoice)->GetSelection());
         m_config.Write("instruction_set",       XRCCTRL(*panel, "txtInstructionSet",       wxTextCtrl)->GetValue());
         return true;
@@ -157,6 +178,15 @@ namespace dbg_mi
             case PersistDebugElements:
                 return m_config.ReadBool("persist_debug_elements", false);
 
+            case RecordMITraffic:
+                return m_config.ReadBool("record_mi_traffic", true);
+
+            case ShowVectorRegisters:
+                return m_config.ReadBool("show_vector_registers", false);
+
+            case TracePipeline:
+                return m_config.ReadBool("trace_pipeline", true);
+
             default:
                 return false;
         }
@@ -194,6 +224,19 @@ namespace dbg_mi
 
             case PersistDebugElements:
                 m_config.Write("persist_debug_elements", value);
+                break;
+
+            case RecordMITraffic:
+                m_config.Write("record_mi_traffic", value);
+                break;
+
+            case ShowVectorRegisters:
+                m_config.Write("show_vector_registers", value);
+                break;
+
+            case TracePipeline:
+                m_config.Write("trace_pipeline", value);
+                break;
 
             default:
                 ;
@@ -269,4 +312,40 @@ namespace dbg_mi
         return m_config.Read("init_commands", wxEmptyString);
     }
 
+    int DebuggerConfiguration::GetMIRecorderSizeMB()
+    {
+        return m_config.ReadInt("mi_recorder_size_mb", 16);
+    }
+
+    int DebuggerConfiguration::GetStallThresholdMs()
+    {
+        return m_config.ReadInt("stall_threshold_ms", 50);
+    }
+
+    int DebuggerConfiguration::GetWatchMaxChildren()
+    {
+        // Pages are nested by this factor, so it has to stay well above 1
+        return std::max(16, m_config.ReadInt("watch_max_children", 256));
+    }
+
+    int DebuggerConfiguration::GetWatchMaxDepth()
+    {
+        return m_config.ReadInt("watch_max_depth", 20);
+    }
+
+    int DebuggerConfiguration::GetWatchMaxStringChars()
+    {
+        return m_config.ReadInt("watch_max_string_chars", 200);
+    }
+
+    int DebuggerConfiguration::GetWatchTimeBudgetMs()
+    {
+        return m_config.ReadInt("watch_time_budget_ms", 1000);
+    }
+
+    int DebuggerConfiguration::GetMemoryMergeGap()
+    {
+        return std::max(0, m_config.ReadInt("memory_merge_gap", 256));
+    }
+
 } // namespace dbg_mi
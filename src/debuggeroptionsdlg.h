@@ -31,7 +31,10 @@ namespace dbg_mi
                 AddOtherProjectDirs,
                 CheckPrettyPrinters,
                 PersistDebugElements,
-                DoNotRun
+                DoNotRun,
+                RecordMITraffic,
+                ShowVectorRegisters,
+                TracePipeline
             };
 
             bool GetFlag(Flags flag);
@@ -40,6 +43,13 @@ namespace dbg_mi
             wxString GetUserArguments(bool expandMacro = true);
             wxString GetDisassemblyFlavorCommand();
             wxString GetInitialCommands();
+            int GetMIRecorderSizeMB();
+            int GetStallThresholdMs();
+            int GetWatchMaxChildren();
+            int GetWatchMaxDepth();
+            int GetWatchMaxStringChars();
+            int GetWatchTimeBudgetMs();
+            int GetMemoryMergeGap();
 
     };
 
@@ -5,6 +5,8 @@
 */
 
 // System include files
+#include <algorithm>
+#include <unordered_set>
 #include <tinyxml2.h>
 #include <wx/version.h>
 
@@ -18,6 +20,7 @@
 // GDB include files
 #include "definitions.h"
 #include "plugin.h"
+#include "value_format.h"
 
 namespace dbg_mi
 {
@@ -314,45 +317,340 @@ namespace dbg_mi
         return m_temporary;
     }
 
-    cb::shared_ptr<GDBWatch> FindWatch(wxString const & expression, GDBWatchesContainer & watches)
+    void GDBWatchesContainer::SetEntry(cb::shared_ptr<GDBWatch> const & watch, int position)
+    {
+        wxString const & id = watch->GetID();
+
+        if (id.empty())
+        {
+            return;
+        }
+
+        Index::iterator it = m_index.find(id);
+
+        if (it != m_index.end() && it->second.watch.lock() == watch)
+        {
+            it->second.position = position;
+            return;
+        }
+
+        IndexEntry & entry = m_index[id];
+        entry.watch = watch;
+        entry.position = position;
+        entry.children_indexed = -1;
+    }
+
+    void GDBWatchesContainer::MarkChildrenUnknown(cb::shared_ptr<cbWatch> const & parent)
+    {
+        if (!parent)
+        {
+            return;
+        }
+
+        Index::iterator it = m_index.find(cb::static_pointer_cast<GDBWatch>(parent)->GetID());
+
+        if (it != m_index.end())
+        {
+            it->second.children_indexed = -1;
+        }
+    }
+
+    cb::shared_ptr<GDBWatch> GDBWatchesContainer::FindIndexed(wxString const & id)
+    {
+        Index::iterator it = m_index.find(id);
+
+        if (it == m_index.end())
+        {
+            return cb::shared_ptr<GDBWatch>();
+        }
+
+        cb::shared_ptr<GDBWatch> watch = it->second.watch.lock();
+
+        if (!watch || watch->GetID() != id)
+        {
+            m_index.erase(it);
+            return cb::shared_ptr<GDBWatch>();
+        }
+
+        cb::shared_ptr<cbWatch> parent = watch->GetParent();
+
+        if (!parent)
+        {
+            if (!IsRoot(watch))
+            {
+                m_index.erase(it);
+                return cb::shared_ptr<GDBWatch>();
+            }
+
+            return watch;
+        }
+
+        int const position = it->second.position;
+
+        if (position < 0 || position >= parent->GetChildCount() || parent->GetChild(position) != watch)
+        {
+            // Moved by RemoveMarkedChildren() or dropped, the parent needs to be reconciled
+            m_index.erase(it);
+            MarkChildrenUnknown(parent);
+            return cb::shared_ptr<GDBWatch>();
+        }
+
+        cb::shared_ptr<GDBWatch> gdbParent = cb::static_pointer_cast<GDBWatch>(parent);
+
+        // Pages have no var-object, check they are still in place and go on with the owner of the children
+        while (gdbParent->IsPage())
+        {
+            cb::shared_ptr<cbWatch> owner = gdbParent->GetParent();
+
+            if (!owner || gdbParent->GetPageIndex() >= owner->GetChildCount() || owner->GetChild(gdbParent->GetPageIndex()) != gdbParent)
+            {
+                return cb::shared_ptr<GDBWatch>();
+            }
+
+            gdbParent = cb::static_pointer_cast<GDBWatch>(owner);
+        }
+
+        if (gdbParent->GetID().empty())
+        {
+            // Child of the locals pseudo watch, a var-object of its own
+            return IsRoot(watch) ? watch : cb::shared_ptr<GDBWatch>();
+        }
+
+        if (FindIndexed(gdbParent->GetID()) != gdbParent)
+        {
+            return cb::shared_ptr<GDBWatch>();
+        }
+
+        return watch;
+    }
+
+    bool GDBWatchesContainer::IsRoot(cb::shared_ptr<GDBWatch> const & watch) const
+    {
+        return (std::find(begin(), end(), watch) != end()) || (std::find(m_locals.begin(), m_locals.end(), watch) != m_locals.end());
+    }
+
+    void GDBWatchesContainer::ClearLocals()
+    {
+        for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = m_locals.begin(); it != m_locals.end(); ++it)
+        {
+            UnindexWatch(*it);
+        }
+
+        m_locals.clear();
+        m_locals_key.clear();
+    }
+
+    void GDBWatchesContainer::SetLocals(cb::shared_ptr<GDBWatch> const & parent, std::vector<cb::shared_ptr<GDBWatch>> const & locals)
     {
-        size_t expLength = expression.length();
+        for (int child = 0; child < parent->GetChildCount(); ++child)
+        {
+            cb::shared_ptr<GDBWatch> childWatch = cb::static_pointer_cast<GDBWatch>(parent->GetChild(child));
+
+            if (std::find(locals.begin(), locals.end(), childWatch) == locals.end())
+            {
+                UnindexWatch(childWatch);
+            }
+        }
 
-        for (GDBWatchesContainer::iterator it = watches.begin(); it != watches.end(); ++it)
+        parent->RemoveChildren();
+        m_locals = locals;
+
+        // The kept locals get their new position
+        for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = m_locals.begin(); it != m_locals.end(); ++it)
         {
-            if (expression.StartsWith(it->get()->GetID()))
+            cbWatch::AddChild(parent, *it);
+            SetEntry(*it, parent->GetChildCount() - 1);
+        }
+    }
+
+    void GDBWatchesContainer::IndexWatch(cb::shared_ptr<GDBWatch> const & watch)
+    {
+        int position = -1;
+        cb::shared_ptr<cbWatch> parent = watch->GetParent();
+
+        // The locals are var-objects of their own but children of the locals pseudo watch
+        if (parent)
+        {
+            for (int child = 0; child < parent->GetChildCount(); ++child)
             {
-                if (expLength == it->get()->GetID().length())
+                if (parent->GetChild(child) == watch)
                 {
-                    return *it;
+                    position = child;
+                    break;
                 }
-                else
+            }
+        }
+
+        SetEntry(watch, position);
+    }
+
+    void GDBWatchesContainer::IndexChildAdded(cb::shared_ptr<GDBWatch> const & parent, cb::shared_ptr<GDBWatch> const & child)
+    {
+        int const position = parent->GetChildCount() - 1;
+        SetEntry(child, position);
+        Index::iterator it = m_index.find(parent->GetID());
+
+        if (it != m_index.end())
+        {
+            IndexEntry & entry = it->second;
+            entry.children_indexed = (entry.children_indexed == position) ? position + 1 : -1;
+        }
+    }
+
+    void GDBWatchesContainer::IndexChildren(cb::shared_ptr<GDBWatch> const & parent)
+    {
+        int const count = parent->GetChildCount();
+        Index::iterator parentIt = m_index.find(parent->GetID());
+
+        if (parentIt != m_index.end() && parentIt->second.children_indexed == count)
+        {
+            return;
+        }
+
+        for (int child = 0; child < count; ++child)
+        {
+            cb::shared_ptr<GDBWatch> childWatch = cb::static_pointer_cast<GDBWatch>(parent->GetChild(child));
+            SetEntry(childWatch, child);
+
+            if (childWatch->IsPage())
+            {
+                IndexChildren(childWatch);
+            }
+        }
+
+        Index::iterator it = m_index.find(parent->GetID());
+
+        if (it != m_index.end())
+        {
+            it->second.children_indexed = count;
+        }
+    }
+
+    void GDBWatchesContainer::UnindexWatch(cb::shared_ptr<cbWatch> const & watch)
+    {
+        if (!watch)
+        {
+            return;
+        }
+
+        Index::iterator it = m_index.find(cb::static_pointer_cast<GDBWatch>(watch)->GetID());
+
+        if (it != m_index.end() && it->second.watch.lock() == watch)
+        {
+            m_index.erase(it);
+        }
+
+        for (int child = 0; child < watch->GetChildCount(); ++child)
+        {
+            UnindexWatch(watch->GetChild(child));
+        }
+    }
+
+    void GDBWatchesContainer::RemoveChildren(cb::shared_ptr<GDBWatch> const & watch)
+    {
+        for (int child = 0; child < watch->GetChildCount(); ++child)
+        {
+            UnindexWatch(watch->GetChild(child));
+        }
+
+        watch->RemoveChildren();
+        MarkChildrenUnknown(watch);
+    }
+
+    void GDBWatchesContainer::RemoveMarkedChildren(cb::shared_ptr<GDBWatch> const & watch)
+    {
+        for (int child = 0; child < watch->GetChildCount(); ++child)
+        {
+            cb::shared_ptr<cbWatch> childWatch = watch->GetChild(child);
+
+            if (childWatch->IsRemoved())
+            {
+                UnindexWatch(childWatch);
+            }
+        }
+
+        watch->RemoveMarkedChildren();
+        // Positions of the remaining children may have moved
+        MarkChildrenUnknown(watch);
+        IndexChildren(watch);
+    }
+
+    void GDBWatchesContainer::TouchPage(cb::shared_ptr<GDBWatch> const & page, std::vector<cb::shared_ptr<GDBWatch>> & evicted)
+    {
+        for (std::list<cb::weak_ptr<GDBWatch>>::iterator it = m_loaded_pages.begin(); it != m_loaded_pages.end(); )
+        {
+            cb::shared_ptr<GDBWatch> loaded = it->lock();
+
+            // Forget pages that were destroyed (collapsed or deleted parent) or already touched
+            if (!loaded || loaded == page)
+            {
+                it = m_loaded_pages.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        m_loaded_pages.push_front(page);
+
+        while (m_loaded_pages.size() > MaxLoadedPages)
+        {
+            cb::shared_ptr<GDBWatch> oldest = m_loaded_pages.back().lock();
+            m_loaded_pages.pop_back();
+
+            if (oldest)
+            {
+                evicted.push_back(oldest);
+            }
+        }
+    }
+
+    namespace
+    {
+        cb::shared_ptr<GDBWatch> WalkWatches(wxString const & expression, std::vector<cb::shared_ptr<GDBWatch>> & roots, GDBWatchesContainer & watches)
+        {
+            size_t expLength = expression.length();
+
+            for (std::vector<cb::shared_ptr<GDBWatch>>::iterator it = roots.begin(); it != roots.end(); ++it)
+            {
+                if (expression.StartsWith(it->get()->GetID()))
                 {
-                    cb::shared_ptr<GDBWatch> curr = *it;
+                    watches.IndexWatch(*it);
 
-                    while (curr)
+                    if (expLength == it->get()->GetID().length())
                     {
-                        cb::shared_ptr<GDBWatch> temp = curr;
-                        curr = cb::shared_ptr<GDBWatch>();
+                        return *it;
+                    }
+                    else
+                    {
+                        cb::shared_ptr<GDBWatch> curr = *it;
 
-                        for (int child = 0; child < temp->GetChildCount(); ++child)
+                        while (curr)
                         {
-                            cb::shared_ptr<GDBWatch> p = cb::static_pointer_cast<GDBWatch>(temp->GetChild(child));
-                            wxString id = p->GetID();
+                            cb::shared_ptr<GDBWatch> temp = curr;
+                            curr = cb::shared_ptr<GDBWatch>();
+                            watches.IndexChildren(temp);
 
-                            if (expression.StartsWith(id))
+                            for (int child = 0; child < temp->GetChildCount(); ++child)
                             {
-                                if (expLength == id.length())
-                                {
-                                    return p;
-                                }
-                                else
+                                cb::shared_ptr<GDBWatch> p = cb::static_pointer_cast<GDBWatch>(temp->GetChild(child));
+                                wxString id = p->GetID();
+
+                                if (expression.StartsWith(id))
                                 {
-                                    if ((expLength > id.length()) && (expression[id.length()] == '.'))
+                                    if (expLength == id.length())
+                                    {
+                                        return p;
+                                    }
+                                    else
                                     {
-                                        // Go into sub child
-                                        curr = p;
-                                        break;
+                                        if ((expLength > id.length()) && (expression[id.length()] == '.'))
+                                        {
+                                            // Go into sub child
+                                            curr = p;
+                                            break;
+                                        }
                                     }
                                 }
                             }
@@ -360,9 +658,160 @@ namespace dbg_mi
                     }
                 }
             }
+
+            return cb::shared_ptr<GDBWatch>();
+        }
+    }
+
+    cb::shared_ptr<GDBWatch> FindWatch(wxString const & expression, GDBWatchesContainer & watches)
+    {
+        cb::shared_ptr<GDBWatch> watch = watches.FindIndexed(expression);
+
+        if (watch)
+        {
+            return watch;
+        }
+
+        size_t const dot = expression.rfind('.');
+
+        if (dot != wxString::npos)
+        {
+            cb::shared_ptr<GDBWatch> parent = FindWatch(expression.Left(dot), watches);
+
+            if (parent)
+            {
+                // Reconcile the parent's children once, most misses are found then
+                watches.IndexChildren(parent);
+                watch = watches.FindIndexed(expression);
+
+                if (watch)
+                {
+                    return watch;
+                }
+            }
+        }
+
+        // Not reachable through the index (top level watch, a name with dots inside a component, or a
+        // watch added without the container): walk the tree and index what is found
+        watch = WalkWatches(expression, watches, watches);
+
+        if (!watch)
+        {
+            watch = WalkWatches(expression, watches.GetLocals(), watches);
+        }
+
+        return watch;
+    }
+
+    WatchBudget & WatchBudget::Get()
+    {
+        static WatchBudget budget = {256, 20, 200, 1000};
+        return budget;
+    }
+
+    bool GDBWatch::SetValue(const wxString & value)
+    {
+        int const maxChars = WatchBudget::Get().max_string_chars;
+
+        if ((maxChars > 0) && (value.length() > static_cast<size_t>(maxChars)))
+        {
+            // The full value is fetched when the watch is updated by hand, see Debugger_GDB_MI::UpdateWatch()
+            m_value = value.Left(maxChars) + "...";
+            m_value_truncated = true;
+        }
+        else
+        {
+            m_value = value;
+            m_value_truncated = false;
+        }
+
+        return true;
+    }
+
+    void GDBWatch::GetValue(wxString & value) const
+    {
+        value = m_value;
+        WatchFormat const format = GetDisplayFormat();
+
+        if ((format == WatchFormat::Undefined) || m_ValueErrorMessage || m_value_truncated)
+        {
+            return;
+        }
+
+        if (m_type_size == 0)
+        {
+            // Not a scalar type known to value_format, shown as GDB reported it
+            return;
+        }
+
+        // Formatted on every call instead of asking GDB with -var-set-format, changing the format is free
+        value_format::TypeInfo info;
+        info.size = m_type_size;
+        info.is_signed = m_type_signed;
+        info.is_float = m_type_float;
+        std::string formatted;
+
+        if (value_format::FormatValue(m_value.ToStdString(), info, static_cast<value_format::Format>(format), formatted))
+        {
+            value = wxString(formatted);
+        }
+    }
+
+    void GDBWatch::SetType(const wxString & type)
+    {
+        wxString const * interned = InternType(type);
+
+        if (interned == m_type)
+        {
+            return;
+        }
+
+        m_type = interned;
+        value_format::TypeInfo info;
+
+        if (value_format::ClassifyType(m_type->ToStdString(), info) && (info.size > 0) && (info.size <= 255))
+        {
+            m_type_size = static_cast<unsigned char>(info.size);
+            m_type_signed = info.is_signed;
+            m_type_float = info.is_float;
+        }
+        else
+        {
+            m_type_size = 0;
+        }
+    }
+
+    GDBWatch::WatchFormat GDBWatch::GetDisplayFormat() const
+    {
+        if ((m_format != WatchFormat::Undefined) && (m_format < WatchFormat::Last))
+        {
+            return m_format;
+        }
+
+        for (cb::shared_ptr<cbWatch> parent = GetParent(); parent; parent = parent->GetParent())
+        {
+            WatchFormat const format = cb::static_pointer_cast<GDBWatch>(parent)->GetFormat();
+
+            if ((format != WatchFormat::Undefined) && (format < WatchFormat::Last))
+            {
+                return format;
+            }
         }
 
-        return cb::shared_ptr<GDBWatch>();
+        return WatchFormat::Undefined;
+    }
+
+    wxString const & GDBWatch::GetClassName()
+    {
+        static const wxString className("GDBWatch");
+        return className;
+    }
+
+    wxString const * GDBWatch::InternType(wxString const & type)
+    {
+        // Never freed, the number of distinct types in a session is small and watches keep pointers into it
+        static std::unordered_set<wxString, wxStringHash, wxStringEqual> * types = new std::unordered_set<wxString, wxStringHash, wxStringEqual>();
+        return &*types->insert(type).first;
     }
 
     wxString GDBWatch::GetWatchFormatTowxString()
@@ -448,15 +897,15 @@ namespace dbg_mi
         tinyxml2::XMLElement* pNewXMLElement = pDoc->NewElement("Watch");
         tinyxml2::XMLNode* pNodeWatch = pWatchesMasterNode->InsertEndChild(pNewXMLElement);
 
-        AddChildNode(pNodeWatch, "GDBWatchClassName", m_GDBWatchClassName);
+        AddChildNode(pNodeWatch, "GDBWatchClassName", GetClassName());
         AddChildNode(pNodeWatch, "projectTitle", m_project->GetTitle());   // The Project the file belongs to.
         // AddChildNode(pNodeWatch, "id", m_id);
         AddChildNode(pNodeWatch, "symbol", m_symbol);
         // AddChildNode(pNodeWatch, "value", m_value);
-        AddChildNode(pNodeWatch, "type", m_type);
+        AddChildNode(pNodeWatch, "type", *m_type);
         AddChildNode(pNodeWatch, "format", GetWatchFormatTowxString());
 
-        AddChildNode(pNodeWatch, "debug_string", m_debug_string);
+        AddChildNode(pNodeWatch, "debug_string", GetDebugString());
         AddChildNode(pNodeWatch, "has_been_expanded", m_has_been_expanded);
         AddChildNode(pNodeWatch, "for_tooltip", m_for_tooltip);
         AddChildNode(pNodeWatch, "delete_on_collapse", m_delete_on_collapse);
@@ -470,15 +919,12 @@ namespace dbg_mi
     void GDBWatch::LoadWatchFromXML(tinyxml2::XMLElement* pElementWatch, Debugger_GDB_MI * dbgGDB)
     {
         //Only load the breakpoints that belong to the current project
-        m_GDBWatchClassName = ReadChildNodewxString(pElementWatch, "GDBWatchClassName");
-
-        m_id = ReadChildNodewxString(pElementWatch, "id");
+        SetID(ReadChildNodewxString(pElementWatch, "id"));
         m_symbol = ReadChildNodewxString(pElementWatch, "symbol");
         m_value = ReadChildNodewxString(pElementWatch, "value");
-        m_type = ReadChildNodewxString(pElementWatch, "type");
+        SetType(ReadChildNodewxString(pElementWatch, "type"));
         SetFormat(ReadChildNodewxString(pElementWatch, "format"));
 
-        m_debug_string = ReadChildNodewxString(pElementWatch, "debug_string");
         m_has_been_expanded = ReadChildNodeBool(pElementWatch, "has_been_expanded");
         m_for_tooltip = ReadChildNodeBool(pElementWatch, "for_tooltip");
         m_delete_on_collapse = ReadChildNodeBool(pElementWatch, "delete_on_collapse");
@@ -8,9 +8,14 @@
 #define _DEBUGGER_GDB_MI_DEFINITIONS_H_
 
 // System and library includes
+#include <algorithm>
 #include <deque>
+#include <list>
 #include <tinyxml2.h>
 #include <tr1/memory>
+#include <unordered_map>
+#include <vector>
+#include <wx/hashmap.h>
 #include <wx/sizer.h>
 #include <wx/string.h>
 #include <scrollingdialog.h>
@@ -20,6 +25,7 @@
 
 // GDB include files
 #include "gdb_logger.h"
+#include "memory_diff.h"
 
 class Debugger_GDB_MI;
 
@@ -407,6 +413,19 @@ namespace dbg_mi
     typedef std::deque<cb::shared_ptr<cbStackFrame> > GDBBacktraceContainer;
     typedef std::deque<cb::shared_ptr<cbThread> > GDBThreadsContainer;
 
+    /** Limits that keep one expensive watch (e.g. a big container shown by a pretty-printer) from
+     * stalling every step. Set from the debugger options when a session starts.
+     */
+    struct WatchBudget
+    {
+        int max_children;       ///< children fetched per level, larger containers are split in pages
+        int max_depth;          ///< nesting GDB prints inside one value ("print max-depth")
+        int max_string_chars;   ///< characters GDB prints ("print elements") and the plugin keeps of a value
+        int time_budget_ms;     ///< a watch taking longer to evaluate is no longer updated on every step
+
+        static WatchBudget & Get();
+    };
+
     class GDBWatch : public cbWatch
     {
         public:
@@ -429,30 +448,51 @@ namespace dbg_mi
                 Any             // used for watches searches
             };
 
+            /** Children of large containers are fetched in pages of WatchBudget::max_children elements. */
+            static int GetPageSize()
+            {
+                return WatchBudget::Get().max_children;
+            }
+
+            /** Children of a dynamic container listed at once, one less than a page so the placeholder of the next window fits. */
+            static int GetDynamicWindow()
+            {
+                return std::max(1, GetPageSize() - 1);
+            }
+
         public:
 
             GDBWatch(cbProject * project, dbg_mi::LogPaneLogger * logger, wxString const & symbol, bool for_tooltip, bool delete_on_collapse = true) :
                 m_project(project),
                 m_pLogger(logger),
-                m_GDBWatchClassName("GDBWatch"),
-                m_id(wxEmptyString),
                 m_symbol(symbol),
+                m_type(InternType(wxEmptyString)),
                 m_address(0),
-                m_type(wxEmptyString),
+                m_type_size(0),
+                m_array_start(-1),
+                m_array_end(-1),
+                m_num_children(-1),
+                m_page_index(-1),
                 m_format(WatchFormat::Undefined),
-                m_debug_string(wxEmptyString),
                 m_has_been_expanded(false),
                 m_for_tooltip(for_tooltip),
                 m_delete_on_collapse(delete_on_collapse),
-                m_array_start(-1),
-                m_array_end(-1),
+                m_frozen(false),
+                m_value_truncated(false),
                 m_is_array(false),
                 m_forTooltip(false),
-                m_value(wxEmptyString),
-                m_ValueErrorMessage(false)
+                m_ValueErrorMessage(false),
+                m_type_signed(false),
+                m_type_float(false)
             {
             }
 
+            /** Name stored in the XML layout file for this class. */
+            static wxString const & GetClassName();
+
+            /** Return the shared copy of a type string, the same type is held once for all watches. */
+            static wxString const * InternType(wxString const & type);
+
             dbg_mi::LogPaneLogger * GetGDBLogger()
             {
                 return m_pLogger;
@@ -460,9 +500,13 @@ namespace dbg_mi
 
             void Reset()
             {
-                m_id = m_type = m_value = wxEmptyString;
+                m_id = m_value = wxEmptyString;
+                m_type = InternType(wxEmptyString);
+                m_type_size = 0;
                 m_ValueErrorMessage = false;
                 m_has_been_expanded = false;
+                m_frozen = false;
+                m_value_truncated = false;
                 RemoveChildren();
                 m_array_start = -1;
                 m_array_end = -1;
@@ -506,6 +550,7 @@ namespace dbg_mi
             }
 
 
+            /** Full var-object name, kept as GDB gave it so lookups do not walk the parents. */
             wxString const & GetID() const
             {
                 return m_id;
@@ -541,6 +586,47 @@ namespace dbg_mi
                 return m_delete_on_collapse;
             }
 
+            /** True if the var-object is frozen in GDB (-var-set-frozen), so "-var-update *" skips it and its children. */
+            bool IsFrozen() const
+            {
+                return m_frozen;
+            }
+
+            void SetFrozen(bool frozen)
+            {
+                m_frozen = frozen;
+            }
+
+            /** Number of children reported by GDB (numchild), -1 if unknown or dynamic. */
+            int GetNumChildren() const
+            {
+                return m_num_children;
+            }
+
+            void SetNumChildren(int count)
+            {
+                m_num_children = count;
+            }
+
+            /** A page is a placeholder node without var-object standing for the children in the range array.
+             *
+             * The page index is the position of the page under its parent.
+             */
+            bool IsPage() const
+            {
+                return m_page_index >= 0;
+            }
+
+            int GetPageIndex() const
+            {
+                return m_page_index;
+            }
+
+            void SetPageIndex(int index)
+            {
+                m_page_index = index;
+            }
+
             void GetSymbol(wxString & symbol) const  override
             {
                 symbol = m_symbol;
@@ -566,15 +652,28 @@ namespace dbg_mi
                 m_address = address;
             }
 
-            void GetValue(wxString & value) const  override
+            /** The value formatted with GetDisplayFormat(), see value_format.h. */
+            void GetValue(wxString & value) const  override;
+
+            /** The value as reported by GDB, in natural format. */
+            wxString const & GetRawValue() const
             {
-                value = m_value;
+                return m_value;
             }
 
-            bool SetValue(const wxString & value) override
+            /** Values longer than WatchBudget::max_string_chars are cut, see SetFullValue(). */
+            bool SetValue(const wxString & value) override;
+
+            /** Store a value fetched on demand, without the length budget. */
+            void SetFullValue(const wxString & value)
             {
                 m_value = value;
-                return true;
+                m_value_truncated = false;
+            }
+
+            bool IsValueTruncated() const
+            {
+                return m_value_truncated;
             }
 
             bool GetIsValueErrorMessage() override
@@ -589,18 +688,16 @@ namespace dbg_mi
 
             void GetFullWatchString(wxString & full_watch) const override
             {
-                full_watch = m_value;
+                GetValue(full_watch);
             }
 
             void GetType(wxString & type) const
             {
-                type = m_type;
+                type = *m_type;
             }
 
-            void SetType(const wxString & type)
-            {
-                m_type = type;
-            }
+            /** Also classifies the type once, GetValue() only formats. */
+            void SetType(const wxString & type);
 
             void SetFormat(WatchFormat format)
             {
@@ -616,13 +713,15 @@ namespace dbg_mi
             {
                 return m_format;
             }
+
+            /** Format of the watch, or of the nearest parent with one, so an array shown as hex shows all its elements as hex. */
+            WatchFormat GetDisplayFormat() const;
             wxString GetWatchFormatTowxString();
             WatchFormat GetWatchFormatFromwxString(wxString wFormat);
 
             wxString GetDebugString() const
             {
-                m_debug_string = m_id + "->" + m_symbol + " = " + m_value;
-                return m_debug_string;
+                return GetID() + "->" + m_symbol + " = " + m_value;
             }
 
             cbProject * GetProject()
@@ -643,31 +742,147 @@ namespace dbg_mi
             virtual void DoDestroy() {}
 
         private:
+            // Ordered for size, one of these exists per element of an expanded container
             cbProject * m_project;              // The Project the watch belongs to.
             dbg_mi::LogPaneLogger * m_pLogger;
 
-            wxString m_GDBWatchClassName;
-            wxString m_id;
+            wxString m_id;                      // Full var-object name
             wxString m_symbol;
+            wxString m_value;
+            wxString const * m_type;            // Interned, see InternType()
             uint64_t m_address;
-            wxString m_type;
-            WatchFormat m_format;
-
-            mutable wxString m_debug_string;
-            bool m_has_been_expanded;
-            bool m_for_tooltip;
-            bool m_delete_on_collapse;
+            unsigned char m_type_size;          // Bytes of a scalar type the plugin can format, 0 otherwise
 
             long m_array_start;
             long m_array_end;
-            bool m_is_array;
-            bool m_forTooltip;
+            int m_num_children;
+            int m_page_index;
+            WatchFormat m_format;
 
-            wxString m_value;
-            bool m_ValueErrorMessage;   // True if the m_value is a message instead of data
+            bool m_has_been_expanded : 1;
+            bool m_for_tooltip : 1;
+            bool m_delete_on_collapse : 1;
+            bool m_frozen : 1;
+            bool m_value_truncated : 1;
+            bool m_is_array : 1;
+            bool m_forTooltip : 1;
+            bool m_ValueErrorMessage : 1;       // True if the m_value is a message instead of data
+            bool m_type_signed : 1;
+            bool m_type_float : 1;
     };
 
-    typedef std::vector<cb::shared_ptr<GDBWatch>> GDBWatchesContainer;
+    /** Top level watches plus an index from var-object name to the GDBWatch in the tree.
+     *
+     * An index entry records the watch and its position under the parent. A hit is verified up to the
+     * top level watch before it is returned, so children dropped by RemoveChildren(), RemoveMarkedChildren()
+     * or GDBWatch::Reset() are never handed out even if a code path did not unindex them. For every parent
+     * the index remembers whether all of its children are indexed, in which case a miss is authoritative
+     * and no linear walk over the siblings is needed.
+     */
+    class GDBWatchesContainer : public std::vector<cb::shared_ptr<GDBWatch>>
+    {
+        public:
+            GDBWatchesContainer() :
+                m_changes_shown(false)
+            {
+            }
+
+            /** Verified index lookup, returns an empty pointer on a miss or a stale entry. */
+            cb::shared_ptr<GDBWatch> FindIndexed(wxString const & id);
+
+            /** Index a top level watch or a local once GDB gave it a var-object name. */
+            void IndexWatch(cb::shared_ptr<GDBWatch> const & watch);
+            /** Index a child just appended to parent with cbWatch::AddChild. */
+            void IndexChildAdded(cb::shared_ptr<GDBWatch> const & parent, cb::shared_ptr<GDBWatch> const & child);
+            /** (Re)index all children of parent with their current positions. */
+            void IndexChildren(cb::shared_ptr<GDBWatch> const & parent);
+            /** Drop the index entries of watch and all of its children. */
+            void UnindexWatch(cb::shared_ptr<cbWatch> const & watch);
+
+            /** Same as GDBWatch::RemoveChildren() and RemoveMarkedChildren(), keeping the index in sync. */
+            void RemoveChildren(cb::shared_ptr<GDBWatch> const & watch);
+            void RemoveMarkedChildren(cb::shared_ptr<GDBWatch> const & watch);
+
+            iterator erase(iterator position)
+            {
+                UnindexWatch(*position);
+                return std::vector<cb::shared_ptr<GDBWatch>>::erase(position);
+            }
+
+            size_t GetIndexSize() const
+            {
+                return m_index.size();
+            }
+
+            /** Note a page whose children were just fetched.
+             *
+             * Pages are kept in least recently used order, the ones beyond MaxLoadedPages are returned in
+             * evicted so the caller can delete their var-objects and drop the children.
+             */
+            void TouchPage(cb::shared_ptr<GDBWatch> const & page, std::vector<cb::shared_ptr<GDBWatch>> & evicted);
+
+            static const size_t MaxLoadedPages = 16;
+
+            /** True while the watches window shows values highlighted as changed by the last update. */
+            bool HasChangesShown() const
+            {
+                return m_changes_shown;
+            }
+
+            void SetChangesShown(bool shown)
+            {
+                m_changes_shown = shown;
+            }
+
+            /** Var-objects of the locals and arguments of the selected frame.
+             *
+             * They are the children of the locals pseudo watch, which has no var-object of its own. They
+             * are kept apart from the user watches, but are found and updated together with them.
+             */
+            std::vector<cb::shared_ptr<GDBWatch>> & GetLocals()
+            {
+                return m_locals;
+            }
+
+            /** Function and frame the locals were created for, see GDBStackVariables. */
+            wxString const & GetLocalsKey() const
+            {
+                return m_locals_key;
+            }
+
+            void SetLocalsKey(wxString const & key)
+            {
+                m_locals_key = key;
+            }
+
+            /** Make locals the locals and the children of the locals pseudo watch parent, keeping the index in sync. */
+            void SetLocals(cb::shared_ptr<GDBWatch> const & parent, std::vector<cb::shared_ptr<GDBWatch>> const & locals);
+
+            /** Forget the locals, e.g. when the debugger has exited and their var-objects are gone. */
+            void ClearLocals();
+
+            /** True for a user watch or a local, i.e. a var-object created by -var-create. */
+            bool IsRoot(cb::shared_ptr<GDBWatch> const & watch) const;
+
+        private:
+            struct IndexEntry
+            {
+                cb::weak_ptr<GDBWatch> watch;
+                int position;           ///< index in the parent's children, -1 for a top level watch
+                int children_indexed;   ///< child count when all children were indexed, -1 if unknown
+            };
+
+            typedef std::unordered_map<wxString, IndexEntry, wxStringHash, wxStringEqual> Index;
+
+            void SetEntry(cb::shared_ptr<GDBWatch> const & watch, int position);
+            void MarkChildrenUnknown(cb::shared_ptr<cbWatch> const & parent);
+
+            Index m_index;
+            std::list<cb::weak_ptr<GDBWatch>> m_loaded_pages;
+            std::vector<cb::shared_ptr<GDBWatch>> m_locals;
+            wxString m_locals_key;
+            bool m_changes_shown;
+    };
 
     cb::shared_ptr<GDBWatch> FindWatch(wxString const & expression, GDBWatchesContainer & watches);
 
@@ -753,6 +968,12 @@ namespace dbg_mi
                 return m_project;
             }
 
+            /** The memory shown at the previous stop. */
+            MemorySnapshot & GetSnapshot()
+            {
+                return m_snapshot;
+            }
+
             // GDB additional
             void SaveWatchToXML(tinyxml2::XMLNode* pWatchesMasterNode);
             void LoadWatchFromXML(tinyxml2::XMLElement* pElementWatch, Debugger_GDB_MI* dbgGDB);
@@ -766,11 +987,11 @@ namespace dbg_mi
             uint64_t m_size;
             wxString m_symbol;
             wxString m_value;
+            MemorySnapshot m_snapshot;
 
             bool m_ValueErrorMessage;
     };
 
-    typedef std::vector<cb::shared_ptr<GDBWatch>> GDBWatchesContainer;
     typedef std::vector<cb::shared_ptr<GDBMemoryRangeWatch>> GDBMemoryRangeWatchesContainer;
 
     enum class GDBWatchType
@@ -812,6 +1033,7 @@ namespace dbg_mi
     {
         public:
             GDBCurrentFrame() :
+                m_address(0),
                 m_line(-1),
                 m_stack_frame(-1),
                 m_user_selected_stack_frame(-1),
@@ -821,6 +1043,7 @@ namespace dbg_mi
 
             void Reset()
             {
+                m_address = 0;
                 m_stack_frame = -1;
                 m_user_selected_stack_frame = -1;
             }
@@ -850,6 +1073,11 @@ namespace dbg_mi
                 m_filename = filename;
                 m_line = line;
             }
+            /** Address of the frame the debuggee stopped in. */
+            void SetAddress(uint64_t address)
+            {
+                m_address = address;
+            }
 
             int GetStackFrame() const
             {
@@ -868,9 +1096,15 @@ namespace dbg_mi
             {
                 return m_thread;
             }
+            /** pc of the selected frame if it is known without asking GDB, 0 once another frame is selected. */
+            uint64_t GetSelectedFrameAddress() const
+            {
+                return (m_stack_frame <= 0) ? m_address : 0;
+            }
 
         private:
             wxString m_filename;
+            uint64_t m_address;
             int m_line;
             int m_stack_frame;
             int m_user_selected_stack_frame;
@@ -0,0 +1,438 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <algorithm>
+
+// GDB includes
+#include "disassembly_cache.h"
+
+namespace dbg_mi
+{
+    namespace
+    {
+        bool AddressBeforeSpan(uint64_t address, MemorySpan const & span)
+        {
+            return address < span.start;
+        }
+
+        size_t NamesBytes(std::vector<std::string> const & names)
+        {
+            size_t bytes = names.capacity() * sizeof(std::string);
+
+            for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+            {
+                bytes += it->capacity();
+            }
+
+            return bytes;
+        }
+    }
+
+    uint32_t DisassemblyRange::AddName(std::vector<std::string> & names, std::string const & name)
+    {
+        // Consecutive instructions nearly always have the same function and file, look there first
+        if (!names.empty() && (names.back() == name))
+        {
+            return static_cast<uint32_t>(names.size() - 1);
+        }
+
+        std::vector<std::string>::const_iterator it = std::find(names.begin(), names.end(), name);
+        uint32_t const index = static_cast<uint32_t>(it - names.begin());
+
+        if (it == names.end())
+        {
+            names.push_back(name);
+        }
+
+        return index;
+    }
+
+    void DisassemblyRange::AddSourceLine(int line, std::string const & file)
+    {
+        m_pending_lines.push_back(line);
+        m_pending_files.push_back(AddName(m_files, file));
+    }
+
+    bool DisassemblyRange::AddInstruction(uint64_t address, uint32_t offset, std::string const & text, std::string const & function)
+    {
+        if (!m_addresses.empty() && (address <= m_addresses.back()))
+        {
+            return false;
+        }
+
+        for (size_t index = 0; index < m_pending_lines.size(); ++index)
+        {
+            m_source_addresses.push_back(address);
+            m_source_lines.push_back(m_pending_lines[index]);
+            m_source_files.push_back(m_pending_files[index]);
+        }
+
+        m_pending_lines.clear();
+        m_pending_files.clear();
+
+        m_addresses.push_back(address);
+        m_offsets.push_back(offset);
+        m_functions.push_back(AddName(m_function_names, function));
+        m_texts += text;
+        m_text_ends.push_back(static_cast<uint32_t>(m_texts.length()));
+        return true;
+    }
+
+    void DisassemblyRange::Append(DisassemblyRange const & from, size_t index, size_t & source,
+                                  std::vector<uint32_t> const & functionRemap, std::vector<uint32_t> const & fileRemap)
+    {
+        uint64_t const address = from.m_addresses[index];
+
+        // The source lines of instructions that were skipped are skipped with them
+        for (; (source < from.m_source_addresses.size()) && (from.m_source_addresses[source] <= address); ++source)
+        {
+            if (from.m_source_addresses[source] == address)
+            {
+                m_source_addresses.push_back(address);
+                m_source_lines.push_back(from.m_source_lines[source]);
+                m_source_files.push_back(fileRemap[from.m_source_files[source]]);
+            }
+        }
+
+        uint32_t const start = (index > 0) ? from.m_text_ends[index - 1] : 0;
+        m_addresses.push_back(address);
+        m_offsets.push_back(from.m_offsets[index]);
+        m_functions.push_back(functionRemap[from.m_functions[index]]);
+        m_texts.append(from.m_texts, start, from.m_text_ends[index] - start);
+        m_text_ends.push_back(static_cast<uint32_t>(m_texts.length()));
+    }
+
+    void DisassemblyRange::Merge(DisassemblyRange const & other)
+    {
+        if (other.GetCount() == 0)
+        {
+            return;
+        }
+
+        DisassemblyRange merged;
+        merged.m_function_names = m_function_names;
+        merged.m_files = m_files;
+
+        // The names here keep their index, the ones of other are looked up once instead of per instruction
+        std::vector<uint32_t> functionRemap(m_function_names.size()), fileRemap(m_files.size());
+        std::vector<uint32_t> otherFunctionRemap, otherFileRemap;
+
+        for (size_t index = 0; index < functionRemap.size(); ++index)
+        {
+            functionRemap[index] = static_cast<uint32_t>(index);
+        }
+
+        for (size_t index = 0; index < fileRemap.size(); ++index)
+        {
+            fileRemap[index] = static_cast<uint32_t>(index);
+        }
+
+        for (std::vector<std::string>::const_iterator it = other.m_function_names.begin(); it != other.m_function_names.end(); ++it)
+        {
+            otherFunctionRemap.push_back(AddName(merged.m_function_names, *it));
+        }
+
+        for (std::vector<std::string>::const_iterator it = other.m_files.begin(); it != other.m_files.end(); ++it)
+        {
+            otherFileRemap.push_back(AddName(merged.m_files, *it));
+        }
+
+        merged.m_addresses.reserve(GetCount() + other.GetCount());
+        merged.m_offsets.reserve(GetCount() + other.GetCount());
+        merged.m_functions.reserve(GetCount() + other.GetCount());
+        merged.m_text_ends.reserve(GetCount() + other.GetCount());
+        merged.m_texts.reserve(m_texts.length() + other.m_texts.length());
+
+        size_t index = 0, otherIndex = 0, source = 0, otherSource = 0;
+
+        while ((index < GetCount()) || (otherIndex < other.GetCount()))
+        {
+            if ((otherIndex == other.GetCount()) || ((index < GetCount()) && (m_addresses[index] <= other.m_addresses[otherIndex])))
+            {
+                if ((otherIndex < other.GetCount()) && (m_addresses[index] == other.m_addresses[otherIndex]))
+                {
+                    otherIndex++;
+                }
+
+                merged.Append(*this, index++, source, functionRemap, fileRemap);
+            }
+            else
+            {
+                merged.Append(other, otherIndex++, otherSource, otherFunctionRemap, otherFileRemap);
+            }
+        }
+
+        merged.m_pending_lines.swap(m_pending_lines);
+        merged.m_pending_files.swap(m_pending_files);
+        Swap(merged);
+    }
+
+    void DisassemblyRange::Clear()
+    {
+        DisassemblyRange empty;
+        Swap(empty);
+    }
+
+    size_t DisassemblyRange::LowerBound(uint64_t address) const
+    {
+        return std::lower_bound(m_addresses.begin(), m_addresses.end(), address) - m_addresses.begin();
+    }
+
+    bool DisassemblyRange::Contains(uint64_t address) const
+    {
+        return std::binary_search(m_addresses.begin(), m_addresses.end(), address);
+    }
+
+    std::string DisassemblyRange::GetText(size_t index) const
+    {
+        uint32_t const start = (index > 0) ? m_text_ends[index - 1] : 0;
+        return m_texts.substr(start, m_text_ends[index] - start);
+    }
+
+    size_t DisassemblyRange::LowerBoundSourceLine(uint64_t address) const
+    {
+        return std::lower_bound(m_source_addresses.begin(), m_source_addresses.end(), address) - m_source_addresses.begin();
+    }
+
+    size_t DisassemblyRange::GetMemoryBytes() const
+    {
+        return sizeof(DisassemblyRange) + m_texts.capacity()
+               + (m_addresses.capacity() + m_source_addresses.capacity()) * sizeof(uint64_t)
+               + (m_offsets.capacity() + m_functions.capacity() + m_text_ends.capacity() + m_source_files.capacity()) * sizeof(uint32_t)
+               + m_source_lines.capacity() * sizeof(int32_t)
+               + NamesBytes(m_function_names) + NamesBytes(m_files);
+    }
+
+    void DisassemblyRange::Swap(DisassemblyRange & other)
+    {
+        m_addresses.swap(other.m_addresses);
+        m_offsets.swap(other.m_offsets);
+        m_functions.swap(other.m_functions);
+        m_text_ends.swap(other.m_text_ends);
+        m_texts.swap(other.m_texts);
+        m_function_names.swap(other.m_function_names);
+        m_source_addresses.swap(other.m_source_addresses);
+        m_source_lines.swap(other.m_source_lines);
+        m_source_files.swap(other.m_source_files);
+        m_files.swap(other.m_files);
+        m_pending_lines.swap(other.m_pending_lines);
+        m_pending_files.swap(other.m_pending_files);
+    }
+
+    DisassemblyCache::DisassemblyCache() :
+        m_hits(0),
+        m_misses(0)
+    {
+        m_shown.start = m_shown.end = 0;
+    }
+
+    void DisassemblyCache::SetKey(std::string const & key)
+    {
+        if (key != m_key)
+        {
+            Clear();
+            m_key = key;
+        }
+    }
+
+    MemorySpan DisassemblyCache::GetView(uint64_t pc) const
+    {
+        MemorySpan view;
+        view.start = (pc > WindowSize) ? pc - WindowSize : 0;
+        view.end = (pc < UINT64_MAX - WindowSize) ? pc + WindowSize : UINT64_MAX;
+
+        size_t const index = m_instructions.LowerBound(pc);
+
+        if ((index < m_instructions.GetCount()) && (m_instructions.GetAddress(index) == pc))
+        {
+            uint64_t const function = m_instructions.GetFunctionStart(index);
+
+            if ((function > view.start) && (function <= pc))
+            {
+                view.start = function;
+            }
+        }
+
+        return view;
+    }
+
+    MemorySpan const * DisassemblyCache::FindRead(uint64_t address) const
+    {
+        std::vector<MemorySpan>::const_iterator it = std::upper_bound(m_read.begin(), m_read.end(), address, AddressBeforeSpan);
+
+        if (it == m_read.begin())
+        {
+            return nullptr;
+        }
+
+        --it;
+        return (address < it->end) ? &*it : nullptr;
+    }
+
+    bool DisassemblyCache::IsRead(uint64_t start, uint64_t end) const
+    {
+        if (start >= end)
+        {
+            return true;
+        }
+
+        // The spans are merged, the whole range has to be inside a single one
+        MemorySpan const * read = FindRead(start);
+        return read && (read->end >= end);
+    }
+
+    bool DisassemblyCache::FindBoundary(uint64_t address, uint64_t & boundary) const
+    {
+        size_t const index = m_instructions.LowerBound(address);
+
+        if ((index < m_instructions.GetCount()) && (m_instructions.GetAddress(index) == address))
+        {
+            boundary = address;
+            return true;
+        }
+
+        if (index == 0)
+        {
+            return false;
+        }
+
+        // The instruction running into address, if the code up to address was read with it
+        uint64_t const previous = m_instructions.GetAddress(index - 1);
+        MemorySpan const * read = FindRead(previous);
+
+        if (read && (read->end >= address))
+        {
+            boundary = previous;
+            return true;
+        }
+
+        return false;
+    }
+
+    void DisassemblyCache::PlanWindows(uint64_t pc, uint64_t start, uint64_t end, std::vector<DisassemblyWindow> & windows) const
+    {
+        uint64_t function = 0;
+        size_t const pcIndex = m_instructions.LowerBound(pc);
+
+        if ((pcIndex < m_instructions.GetCount()) && (m_instructions.GetAddress(pcIndex) == pc))
+        {
+            function = m_instructions.GetFunctionStart(pcIndex);
+        }
+
+        uint64_t position = start;
+
+        while (position < end)
+        {
+            MemorySpan const * read = FindRead(position);
+
+            if (read)
+            {
+                position = read->end;
+                continue;
+            }
+
+            std::vector<MemorySpan>::const_iterator next = std::upper_bound(m_read.begin(), m_read.end(), position, AddressBeforeSpan);
+            uint64_t const gapEnd = ((next != m_read.end()) && (next->start < end)) ? next->start : end;
+            DisassemblyWindow window;
+            window.end = gapEnd;
+            window.landing = 0;
+
+            if (FindBoundary(position, window.start))
+            {
+                // Chained from the instruction read before, decoded in step with it
+                windows.push_back(window);
+            }
+            else if ((position == pc) || (position == function))
+            {
+                window.start = position;
+                windows.push_back(window);
+            }
+            else if ((position < pc) && (pc < gapEnd))
+            {
+                // Decoded from an unknown boundary up to pc, the rest starts at pc
+                window.start = position;
+                window.end = pc + 1;
+                window.landing = pc;
+                windows.push_back(window);
+
+                window.start = pc;
+                window.end = gapEnd;
+                window.landing = 0;
+                windows.push_back(window);
+            }
+            else
+            {
+                // Code below instructions already read, the decoding has to reach the first of them
+                size_t const landing = m_instructions.LowerBound(gapEnd);
+                window.start = position;
+
+                if (landing < m_instructions.GetCount())
+                {
+                    window.landing = m_instructions.GetAddress(landing);
+                    window.end = window.landing + 1;
+                }
+
+                windows.push_back(window);
+            }
+
+            position = gapEnd;
+        }
+    }
+
+    bool DisassemblyCache::Add(DisassemblyWindow const & window, DisassemblyRange const & range)
+    {
+        // Even a window that missed its landing is not asked again, it would miss it the next time as well
+        m_read.push_back(MemorySpan());
+        m_read.back().start = window.start;
+        m_read.back().end = window.end;
+        m_read = CoalesceSpans(m_read, 0);
+
+        if ((window.landing != 0) && !range.Contains(window.landing))
+        {
+            return false;
+        }
+
+        if (m_instructions.GetCount() + range.GetCount() > MaxInstructions)
+        {
+            std::vector<MemorySpan> read;
+            read.push_back(MemorySpan());
+            read.back().start = window.start;
+            read.back().end = window.end;
+            Clear();
+            m_read.swap(read);
+        }
+
+        size_t const shownBefore = m_instructions.LowerBound(m_shown.end) - m_instructions.LowerBound(m_shown.start);
+        m_instructions.Merge(range);
+
+        if (m_instructions.LowerBound(m_shown.end) - m_instructions.LowerBound(m_shown.start) != shownBefore)
+        {
+            // The dialog misses instructions of its view now
+            m_shown.start = m_shown.end = 0;
+        }
+
+        return true;
+    }
+
+    bool DisassemblyCache::IsShown(uint64_t pc) const
+    {
+        return (m_shown.start <= pc) && (pc + WindowSize / 2 <= m_shown.end) && m_instructions.Contains(pc);
+    }
+
+    void DisassemblyCache::Clear()
+    {
+        m_instructions.Clear();
+        m_read.clear();
+        m_shown.start = m_shown.end = 0;
+    }
+
+    size_t DisassemblyCache::GetMemoryBytes() const
+    {
+        return m_instructions.GetMemoryBytes() + m_read.capacity() * sizeof(MemorySpan) + m_key.capacity();
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,238 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_DISASSEMBLY_CACHE_H_
+#define _DEBUGGER_GDB_MI_DISASSEMBLY_CACHE_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GDB includes
+#include "memory_cache.h"
+
+namespace dbg_mi
+{
+    /** Disassembled instructions sorted by address.
+     *
+     * Stored as parallel arrays instead of one object per instruction: the texts share a single
+     * buffer, function and source file names are kept once in a table, so an instruction costs a
+     * few bytes on top of its text. Used for a single "-data-disassemble" reply as well as for
+     * all the instructions read in the session.
+     *
+     * Does not depend on wxWidgets, texts are UTF-8.
+     */
+    class DisassemblyRange
+    {
+        public:
+            /** Source line shown before the next instruction added (mixed mode), dropped if no instruction follows. */
+            void AddSourceLine(int line, std::string const & file);
+            /** Returns false, and ignores the instruction, unless it comes after the last one. */
+            bool AddInstruction(uint64_t address, uint32_t offset, std::string const & text, std::string const & function);
+
+            /** Add the instructions of other that are not here yet, the ones here win. */
+            void Merge(DisassemblyRange const & other);
+
+            void Clear();
+
+            size_t GetCount() const
+            {
+                return m_addresses.size();
+            }
+
+            /** Index of the first instruction at or after address, GetCount() if there is none. */
+            size_t LowerBound(uint64_t address) const;
+
+            /** True if an instruction starts at address. */
+            bool Contains(uint64_t address) const;
+
+            uint64_t GetAddress(size_t index) const
+            {
+                return m_addresses[index];
+            }
+
+            uint32_t GetOffset(size_t index) const
+            {
+                return m_offsets[index];
+            }
+
+            /** Start of the function of the instruction, from its offset. */
+            uint64_t GetFunctionStart(size_t index) const
+            {
+                return m_addresses[index] - m_offsets[index];
+            }
+
+            std::string const & GetFunction(size_t index) const
+            {
+                return m_function_names[m_functions[index]];
+            }
+
+            std::string GetText(size_t index) const;
+
+            size_t GetSourceLineCount() const
+            {
+                return m_source_addresses.size();
+            }
+
+            /** Index of the first source line shown before an instruction at or after address. */
+            size_t LowerBoundSourceLine(uint64_t address) const;
+
+            /** Address of the instruction the source line is shown before. */
+            uint64_t GetSourceLineAddress(size_t index) const
+            {
+                return m_source_addresses[index];
+            }
+
+            int GetSourceLine(size_t index) const
+            {
+                return m_source_lines[index];
+            }
+
+            std::string const & GetSourceFile(size_t index) const
+            {
+                return m_files[m_source_files[index]];
+            }
+
+            size_t GetMemoryBytes() const;
+
+            void Swap(DisassemblyRange & other);
+
+        private:
+            static uint32_t AddName(std::vector<std::string> & names, std::string const & name);
+            /** Append instruction index of from with its source lines, the names are mapped by the remap tables. */
+            void Append(DisassemblyRange const & from, size_t index, size_t & source,
+                        std::vector<uint32_t> const & functionRemap, std::vector<uint32_t> const & fileRemap);
+
+            std::vector<uint64_t> m_addresses;
+            std::vector<uint32_t> m_offsets;
+            std::vector<uint32_t> m_functions;      ///< index in m_function_names
+            std::vector<uint32_t> m_text_ends;      ///< end of each text in m_texts, it starts at the end of the previous one
+            std::string m_texts;
+            std::vector<std::string> m_function_names;
+
+            std::vector<uint64_t> m_source_addresses;
+            std::vector<int32_t> m_source_lines;
+            std::vector<uint32_t> m_source_files;   ///< index in m_files
+            std::vector<std::string> m_files;
+
+            std::vector<int32_t> m_pending_lines;   ///< source lines waiting for their instruction
+            std::vector<uint32_t> m_pending_files;
+    };
+
+    /** A "-data-disassemble -s start -e end" request. */
+    struct DisassemblyWindow
+    {
+        uint64_t start;
+        uint64_t end;
+        uint64_t landing;   ///< 0 if start is a known instruction boundary, else an instruction the decoding must reach
+    };
+
+    /** Disassembled code of the debug session.
+     *
+     * Code does not change while the debuggee runs, so every instruction read is kept in one
+     * listing with the address spans already read. For a stop the dialog shows a view of
+     * WindowSize bytes on each side of $pc, only the spans of it not read yet are asked to GDB.
+     * Windows start at a known instruction boundary when there is one (an instruction read
+     * before, the start of the function), so x86 code is decoded in step with the real
+     * instructions, and each read goes one window past the view so the next steps find their
+     * code cached. The cache also remembers the view the dialog shows, while $pc stays in it only
+     * the active line has to move.
+     *
+     * The listing is dropped when the settings that change GDB's output (mixed mode, flavor) change.
+     *
+     * Does not depend on wxWidgets.
+     */
+    class DisassemblyCache
+    {
+        public:
+            /** Bytes shown on each side of $pc, as well as the size of a window read ahead. */
+            static const uint64_t WindowSize = 256;
+            /** The listing is dropped beyond this. */
+            static const size_t MaxInstructions = 1 << 20;
+
+        public:
+            DisassemblyCache();
+
+            /** Mode and flavor of the next reads, the listing is dropped if they changed. */
+            void SetKey(std::string const & key);
+
+            /** Span shown for pc, not before the start of pc's function when it is known. */
+            MemorySpan GetView(uint64_t pc) const;
+
+            /** True if every byte of [start, end) was read. */
+            bool IsRead(uint64_t start, uint64_t end) const;
+
+            /** Windows to read so that [start, end) is in the listing, pc is a known instruction boundary. */
+            void PlanWindows(uint64_t pc, uint64_t start, uint64_t end, std::vector<DisassemblyWindow> & windows) const;
+
+            /** Merge the instructions read for window. Returns false, keeping none, if the decoding missed window.landing. */
+            bool Add(DisassemblyWindow const & window, DisassemblyRange const & range);
+
+            DisassemblyRange const & GetInstructions() const
+            {
+                return m_instructions;
+            }
+
+            /** The dialog shows view, nothing if view is empty. */
+            void SetShown(MemorySpan const & view)
+            {
+                m_shown = view;
+            }
+
+            /** True if the dialog lists pc with at least half a window of code after it. */
+            bool IsShown(uint64_t pc) const;
+
+            /** New debug session, the code may have been rebuilt. */
+            void Clear();
+
+            void CountLookup(bool hit)
+            {
+                if (hit)
+                {
+                    m_hits++;
+                }
+                else
+                {
+                    m_misses++;
+                }
+            }
+
+            size_t GetCount() const
+            {
+                return m_instructions.GetCount();
+            }
+
+            size_t GetMemoryBytes() const;
+
+            unsigned long GetHits() const
+            {
+                return m_hits;
+            }
+
+            unsigned long GetMisses() const
+            {
+                return m_misses;
+            }
+
+        private:
+            /** Known instruction boundary at or just below address, decoded without a gap up to address. */
+            bool FindBoundary(uint64_t address, uint64_t & boundary) const;
+            /** The read span holding address, nullptr if address was not read. */
+            MemorySpan const * FindRead(uint64_t address) const;
+
+            std::string m_key;
+            DisassemblyRange m_instructions;
+            std::vector<MemorySpan> m_read;         ///< sorted, merged
+            MemorySpan m_shown;
+            unsigned long m_hits;
+            unsigned long m_misses;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_DISASSEMBLY_CACHE_H_
@@ -204,9 +204,19 @@ namespace dbg_mi
                             return SignalReceived;
                         }
                         else
-                        {
-                            return Unknown;
-                        }
+                            if (str == "function-finished")
+                            {
+                                return FunctionFinished;
+                            }
+                            else
+                                if (str == "end-stepping-range")
+                                {
+                                    return EndSteppingRange;
+                                }
+                                else
+                                {
+                                    return Unknown;
+                                }
     }
 
 } // namespace dbg_mi
@@ -43,7 +43,7 @@ namespace dbg_mi
             {
                 return m_function;
             }
-            unsigned long int GetAddress() const
+            unsigned long long int GetAddress() const
             {
                 return m_address;
             }
@@ -90,10 +90,10 @@ namespace dbg_mi
                 //        WatchpointTrigger, // A watchpoint was triggered.
                 //        ReadWatchpointTrigger, // A read watchpoint was triggered.
                 //        AccessWatchpointTrigger, // An access watchpoint was triggered.
-                //        FunctionFinished, // An -exec-finish or similar CLI command was accomplished.
+                FunctionFinished, // An -exec-finish or similar CLI command was accomplished.
                 //        LocationReached // An -exec-until or similar CLI command was accomplished.
                 //        WatchpointScope, // A watchpoint has gone out of scope.
-                //        EndSteppingRange, // An -exec-next, -exec-next-instruction, -exec-step, -exec-step-instruction or similar CLI command was accomplished.
+                EndSteppingRange, // An -exec-next, -exec-next-instruction, -exec-step, -exec-step-instruction or similar CLI command was accomplished.
                 ExitedSignalled, // The inferior exited because of a signal.
                 Exited, // The inferior exited.
                 ExitedNormally, // The inferior exited normally.
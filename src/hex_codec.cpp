@@ -0,0 +1,369 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+    #define HEX_CODEC_SSE2 1
+    #include <emmintrin.h>
+
+    #if defined(__GNUC__)
+        // Compiled for AVX2 with a target attribute, only called when the CPU reports it
+        #define HEX_CODEC_AVX2 1
+        #include <immintrin.h>
+    #endif
+#endif
+
+// GDB includes
+#include "hex_codec.h"
+
+namespace dbg_mi
+{
+    namespace hex_codec
+    {
+        namespace
+        {
+            const int8_t InvalidDigit = -1;
+
+            struct Tables
+            {
+                int8_t digit[256];          ///< value of a hex digit character, InvalidDigit otherwise
+                char hex[256][2];           ///< the two hex digits of every byte value
+
+                Tables()
+                {
+                    static const char Digits[] = "0123456789abcdef";
+
+                    for (int c = 0; c < 256; ++c)
+                    {
+                        digit[c] = InvalidDigit;
+                        hex[c][0] = Digits[c >> 4];
+                        hex[c][1] = Digits[c & 0x0F];
+                    }
+
+                    for (int value = 0; value < 16; ++value)
+                    {
+                        digit[static_cast<unsigned char>(Digits[value])] = static_cast<int8_t>(value);
+                        digit[static_cast<unsigned char>("0123456789ABCDEF"[value])] = static_cast<int8_t>(value);
+                    }
+                }
+            };
+
+            Tables const & GetTables()
+            {
+                static const Tables tables;
+                return tables;
+            }
+
+            bool DecodeScalar(char const * hex, size_t length, uint8_t * out)
+            {
+                int8_t const * digit = GetTables().digit;
+
+                for (size_t i = 0; i < length; i += 2)
+                {
+                    int8_t const high = digit[static_cast<unsigned char>(hex[i])];
+                    int8_t const low = digit[static_cast<unsigned char>(hex[i + 1])];
+
+                    // Both are InvalidDigit (negative) or 0..15, a single test catches either one being bad
+                    if ((high | low) < 0)
+                    {
+                        return false;
+                    }
+
+                    *out++ = static_cast<uint8_t>((high << 4) | low);
+                }
+
+                return true;
+            }
+
+            void EncodeScalar(uint8_t const * bytes, size_t length, char * out)
+            {
+                Tables const & tables = GetTables();
+
+                for (size_t i = 0; i < length; ++i, out += 2)
+                {
+                    std::memcpy(out, tables.hex[bytes[i]], 2);
+                }
+            }
+
+#ifdef HEX_CODEC_SSE2
+            /** Value of 16 hex digit characters, valid has 0xFF for every character that is a hex digit. */
+            inline __m128i NibblesSSE2(__m128i c, __m128i & valid)
+            {
+                // Characters >= 0x80 are negative for the signed compares, so they are never valid
+                __m128i const lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+                __m128i const isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+                __m128i const isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+                valid = _mm_or_si128(isDigit, isAlpha);
+                return _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                                    _mm_and_si128(isAlpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+            }
+
+            /** Join the nibble pairs, every 16 bit lane ends up with one byte value. */
+            inline __m128i PairsSSE2(__m128i nibbles)
+            {
+                __m128i const high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+                return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+            }
+
+            /** Decode blocks of 32 characters, returns the number of characters done. Stops before an invalid block. */
+            size_t DecodeSSE2(char const * hex, size_t length, uint8_t * out)
+            {
+                size_t done = 0;
+
+                for (; done + 32 <= length; done += 32, out += 16)
+                {
+                    __m128i valid1, valid2;
+                    __m128i const nibbles1 = NibblesSSE2(_mm_loadu_si128(reinterpret_cast<__m128i const *>(hex + done)), valid1);
+                    __m128i const nibbles2 = NibblesSSE2(_mm_loadu_si128(reinterpret_cast<__m128i const *>(hex + done + 16)), valid2);
+
+                    if (_mm_movemask_epi8(_mm_and_si128(valid1, valid2)) != 0xFFFF)
+                    {
+                        break;
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(PairsSSE2(nibbles1), PairsSSE2(nibbles2)));
+                }
+
+                return done;
+            }
+
+            inline __m128i NibblesToASCIISSE2(__m128i nibbles)
+            {
+                __m128i const letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+                return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+            }
+
+            /** Encode blocks of 16 bytes, returns the number of bytes done. */
+            size_t EncodeSSE2(uint8_t const * bytes, size_t length, char * out)
+            {
+                size_t done = 0;
+                __m128i const mask = _mm_set1_epi8(0x0F);
+
+                for (; done + 16 <= length; done += 16, out += 32)
+                {
+                    __m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes + done));
+                    __m128i const high = NibblesToASCIISSE2(_mm_and_si128(_mm_srli_epi16(b, 4), mask));
+                    __m128i const low = NibblesToASCIISSE2(_mm_and_si128(b, mask));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(high, low));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm_unpackhi_epi8(high, low));
+                }
+
+                return done;
+            }
+#endif // HEX_CODEC_SSE2
+
+#ifdef HEX_CODEC_AVX2
+            __attribute__((target("avx2")))
+            inline __m256i NibblesAVX2(__m256i c, __m256i & valid)
+            {
+                __m256i const lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+                __m256i const isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+                __m256i const isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+                valid = _mm256_or_si256(isDigit, isAlpha);
+                return _mm256_or_si256(_mm256_and_si256(isDigit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                                       _mm256_and_si256(isAlpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+            }
+
+            __attribute__((target("avx2")))
+            inline __m256i PairsAVX2(__m256i nibbles)
+            {
+                __m256i const high = _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), 4);
+                return _mm256_or_si256(high, _mm256_srli_epi16(nibbles, 8));
+            }
+
+            /** Decode blocks of 64 characters, returns the number of characters done. Stops before an invalid block. */
+            __attribute__((target("avx2")))
+            size_t DecodeAVX2(char const * hex, size_t length, uint8_t * out)
+            {
+                size_t done = 0;
+
+                for (; done + 64 <= length; done += 64, out += 32)
+                {
+                    __m256i valid1, valid2;
+                    __m256i const nibbles1 = NibblesAVX2(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(hex + done)), valid1);
+                    __m256i const nibbles2 = NibblesAVX2(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(hex + done + 32)), valid2);
+
+                    if (_mm256_movemask_epi8(_mm256_and_si256(valid1, valid2)) != -1)
+                    {
+                        break;
+                    }
+
+                    // The pack works per 128 bit lane, put the four quarters back in memory order
+                    __m256i const packed = _mm256_packus_epi16(PairsAVX2(nibbles1), PairsAVX2(nibbles2));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permute4x64_epi64(packed, 0xD8));
+                }
+
+                return done;
+            }
+#endif // HEX_CODEC_AVX2
+
+            Implementation DetectImplementation()
+            {
+#if defined(HEX_CODEC_AVX2)
+                __builtin_cpu_init();
+
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    return AVX2;
+                }
+#endif
+#if defined(HEX_CODEC_SSE2)
+                return SSE2;
+#else
+                return Scalar;
+#endif
+            }
+        }
+
+        Implementation GetBestImplementation()
+        {
+            static const Implementation best = DetectImplementation();
+            return best;
+        }
+
+        char const * GetImplementationName(Implementation implementation)
+        {
+            switch (implementation)
+            {
+                case AVX2:
+                    return "AVX2";
+
+                case SSE2:
+                    return "SSE2";
+
+                default:
+                    return "scalar";
+            }
+        }
+
+        bool Decode(char const * hex, size_t length, std::vector<uint8_t> & bytes)
+        {
+            return Decode(hex, length, bytes, GetBestImplementation());
+        }
+
+        bool Decode(char const * hex, size_t length, std::vector<uint8_t> & bytes, Implementation implementation)
+        {
+            if (length % 2 != 0)
+            {
+                return false;
+            }
+
+            size_t const start = bytes.size();
+            bytes.resize(start + length / 2);
+
+            if (!Decode(hex, length, bytes.data() + start, implementation))
+            {
+                bytes.resize(start);
+                return false;
+            }
+
+            return true;
+        }
+
+        bool Decode(char const * hex, size_t length, uint8_t * out)
+        {
+            return Decode(hex, length, out, GetBestImplementation());
+        }
+
+        bool Decode(char const * hex, size_t length, uint8_t * out, Implementation implementation)
+        {
+            if (length % 2 != 0)
+            {
+                return false;
+            }
+
+            if (implementation > GetBestImplementation())
+            {
+                implementation = GetBestImplementation();
+            }
+
+            size_t done = 0;
+
+            // Each wider step stops before an invalid block, the scalar loop finishes the tail and reports errors
+#ifdef HEX_CODEC_AVX2
+            if (implementation >= AVX2)
+            {
+                done += DecodeAVX2(hex, length, out);
+            }
+#endif
+#ifdef HEX_CODEC_SSE2
+            if (implementation >= SSE2)
+            {
+                done += DecodeSSE2(hex + done, length - done, out + done / 2);
+            }
+#endif
+
+            return DecodeScalar(hex + done, length - done, out + done / 2);
+        }
+
+        void Encode(uint8_t const * bytes, size_t length, std::string & hex)
+        {
+            Encode(bytes, length, hex, GetBestImplementation());
+        }
+
+        void Encode(uint8_t const * bytes, size_t length, std::string & hex, Implementation implementation)
+        {
+            if (implementation > GetBestImplementation())
+            {
+                implementation = GetBestImplementation();
+            }
+
+            size_t const start = hex.size();
+            hex.resize(start + length * 2);
+            char * out = &hex[start];
+            size_t done = 0;
+
+            // Encoding is bound by the stores, SSE2 is already as fast as the memory
+#ifdef HEX_CODEC_SSE2
+            if (implementation >= SSE2)
+            {
+                done = EncodeSSE2(bytes, length, out);
+            }
+#endif
+
+            EncodeScalar(bytes + done, length - done, out + done * 2);
+        }
+
+        InputResult DecodeInput(std::string const & text, uint64_t max_length, std::vector<uint8_t> & bytes)
+        {
+            std::string hex;
+            hex.reserve(text.length());
+
+            for (std::string::const_iterator it = text.begin(); it != text.end(); ++it)
+            {
+                if (*it != ' ')
+                {
+                    hex += *it;
+                }
+            }
+
+            std::vector<uint8_t> decoded;
+
+            if (!Decode(hex.data(), hex.length(), decoded) || decoded.empty())
+            {
+                return InputInvalid;
+            }
+
+            // Bytes past the range would overwrite memory the watch does not show
+            if (decoded.size() > max_length)
+            {
+                return InputTooLong;
+            }
+
+            bytes.swap(decoded);
+            return InputOk;
+        }
+
+        char const * ByteToHex(uint8_t value)
+        {
+            return GetTables().hex[value];
+        }
+
+    } // namespace hex_codec
+
+} // namespace dbg_mi
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_HEX_CODEC_H_
+#define _DEBUGGER_GDB_MI_HEX_CODEC_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dbg_mi
+{
+    /** Conversion between the hex strings of the GDB memory commands and raw bytes.
+     *
+     * -data-read-memory-bytes reports the memory as one "contents" string with two hex digits per
+     * byte, -data-write-memory-bytes takes the same format. Both directions run over whole blocks:
+     * SSE2 or AVX2 on x86 when the CPU has it (checked once), a lookup table otherwise. Results are
+     * appended to caller owned buffers, so a buffer kept between calls is not reallocated.
+     *
+     * Does not depend on wxWidgets.
+     */
+    namespace hex_codec
+    {
+        enum Implementation
+        {
+            Scalar = 0,
+            SSE2,
+            AVX2
+        };
+
+        /** The fastest implementation supported by this CPU. */
+        Implementation GetBestImplementation();
+        char const * GetImplementationName(Implementation implementation);
+
+        /** Decode length hex characters into length / 2 bytes appended to bytes.
+         *
+         * Returns false, leaving bytes unchanged, if length is odd or a character is not a hex digit.
+         */
+        bool Decode(char const * hex, size_t length, std::vector<uint8_t> & bytes);
+
+        /** Same as Decode() with a given implementation, lowered to what the CPU supports. For tests and benchmarks. */
+        bool Decode(char const * hex, size_t length, std::vector<uint8_t> & bytes, Implementation implementation);
+
+        /** Decode length hex characters into the length / 2 bytes at out, e.g. a mapped file.
+         *
+         * Returns false if length is odd or a character is not a hex digit, out is then partly written.
+         */
+        bool Decode(char const * hex, size_t length, uint8_t * out);
+        bool Decode(char const * hex, size_t length, uint8_t * out, Implementation implementation);
+
+        /** Append two lower case hex digits per byte to hex. */
+        void Encode(uint8_t const * bytes, size_t length, std::string & hex);
+        void Encode(uint8_t const * bytes, size_t length, std::string & hex, Implementation implementation);
+
+        enum InputResult
+        {
+            InputOk = 0,
+            InputInvalid,   ///< empty, odd number of digits or not a hex digit
+            InputTooLong    ///< more bytes than max_length
+        };
+
+        /** Decode hex bytes typed by the user, spaces between the digits allowed, for a write of
+         * at most max_length bytes. bytes is only filled when InputOk is returned.
+         */
+        InputResult DecodeInput(std::string const & text, uint64_t max_length, std::vector<uint8_t> & bytes);
+
+        /** The two lower case hex digits of value, not null terminated. */
+        char const * ByteToHex(uint8_t value);
+
+    } // namespace hex_codec
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_HEX_CODEC_H_
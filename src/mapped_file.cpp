@@ -0,0 +1,240 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// GDB includes
+#include "mapped_file.h"
+
+namespace dbg_mi
+{
+    MappedFile::MappedFile() :
+        m_data(nullptr),
+        m_size(0),
+#ifdef _WIN32
+        m_file(INVALID_HANDLE_VALUE),
+        m_mapping(nullptr)
+#else
+        m_fd(-1)
+#endif
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+#ifdef _WIN32
+    static std::string LastErrorString(char const * what)
+    {
+        return std::string(what) + " failed, error " + std::to_string(static_cast<unsigned long>(::GetLastError()));
+    }
+
+    bool MappedFile::Open(std::string const & path, OpenMode mode, uint64_t size, std::string & error)
+    {
+        Close();
+        bool const writable = (mode == CreateReadWrite);
+        HANDLE file = ::CreateFileA(path.c_str(),
+                                    writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                                    writable ? FILE_SHARE_READ : (FILE_SHARE_READ | FILE_SHARE_WRITE),
+                                    nullptr,
+                                    writable ? CREATE_ALWAYS : OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL,
+                                    nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            error = LastErrorString("CreateFile");
+            return false;
+        }
+
+        if (!writable)
+        {
+            LARGE_INTEGER fileSize;
+
+            if (!::GetFileSizeEx(file, &fileSize))
+            {
+                error = LastErrorString("GetFileSizeEx");
+                ::CloseHandle(file);
+                return false;
+            }
+
+            size = static_cast<uint64_t>(fileSize.QuadPart);
+        }
+
+        if (size == 0)
+        {
+            error = "cannot map an empty file";
+            ::CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = ::CreateFileMappingA(file,
+                                              nullptr,
+                                              writable ? PAGE_READWRITE : PAGE_READONLY,
+                                              static_cast<DWORD>(size >> 32),
+                                              static_cast<DWORD>(size & 0xFFFFFFFFu),
+                                              nullptr);
+
+        if (!mapping)
+        {
+            error = LastErrorString("CreateFileMapping");
+            ::CloseHandle(file);
+            return false;
+        }
+
+        void * view = ::MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(size));
+
+        if (!view)
+        {
+            error = LastErrorString("MapViewOfFile");
+            ::CloseHandle(mapping);
+            ::CloseHandle(file);
+            return false;
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<uint8_t *>(view);
+        m_size = size;
+        m_path = path;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+        {
+            ::UnmapViewOfFile(m_data);
+            m_data = nullptr;
+        }
+
+        if (m_mapping)
+        {
+            ::CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+
+        m_size = 0;
+        m_path.clear();
+    }
+
+    bool MappedFile::Flush()
+    {
+        return m_data && ::FlushViewOfFile(m_data, static_cast<SIZE_T>(m_size));
+    }
+#else
+    static std::string LastErrorString(char const * what)
+    {
+        return std::string(what) + " failed: " + std::strerror(errno);
+    }
+
+    bool MappedFile::Open(std::string const & path, OpenMode mode, uint64_t size, std::string & error)
+    {
+        Close();
+        bool const writable = (mode == CreateReadWrite);
+        int fd = writable ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)
+                          : ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            error = LastErrorString("open");
+            return false;
+        }
+
+        if (writable)
+        {
+            if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+            {
+                error = LastErrorString("ftruncate");
+                ::close(fd);
+                return false;
+            }
+        }
+        else
+        {
+            struct stat st;
+
+            if (::fstat(fd, &st) != 0)
+            {
+                error = LastErrorString("fstat");
+                ::close(fd);
+                return false;
+            }
+
+            size = static_cast<uint64_t>(st.st_size);
+        }
+
+        if (size == 0)
+        {
+            error = "cannot map an empty file";
+            ::close(fd);
+            return false;
+        }
+
+        void * view = ::mmap(nullptr,
+                             static_cast<size_t>(size),
+                             writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                             MAP_SHARED,
+                             fd,
+                             0);
+
+        if (view == MAP_FAILED)
+        {
+            error = LastErrorString("mmap");
+            ::close(fd);
+            return false;
+        }
+
+        m_fd = fd;
+        m_data = static_cast<uint8_t *>(view);
+        m_size = size;
+        m_path = path;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+        {
+            ::munmap(m_data, static_cast<size_t>(m_size));
+            m_data = nullptr;
+        }
+
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+
+        m_size = 0;
+        m_path.clear();
+    }
+
+    bool MappedFile::Flush()
+    {
+        return m_data && ::msync(m_data, static_cast<size_t>(m_size), MS_ASYNC) == 0;
+    }
+#endif
+
+} // namespace dbg_mi
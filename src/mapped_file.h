@@ -0,0 +1,81 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_MAPPED_FILE_H_
+#define _DEBUGGER_GDB_MI_MAPPED_FILE_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dbg_mi
+{
+    /** Fixed size read/write memory mapping of a file.
+     *
+     * Kept free of wxWidgets so the MI traffic recorder and its dump tool can share it.
+     */
+    class MappedFile
+    {
+        public:
+            enum OpenMode
+            {
+                ReadOnly,
+                CreateReadWrite     ///< Create or truncate the file and resize it to the requested size
+            };
+
+        public:
+            MappedFile();
+            ~MappedFile();
+
+            bool Open(std::string const & path, OpenMode mode, uint64_t size, std::string & error);
+            void Close();
+            bool Flush();
+
+            bool IsOpen() const
+            {
+                return m_data != nullptr;
+            }
+
+            uint8_t * GetData()
+            {
+                return m_data;
+            }
+
+            uint8_t const * GetData() const
+            {
+                return m_data;
+            }
+
+            uint64_t GetSize() const
+            {
+                return m_size;
+            }
+
+            std::string const & GetPath() const
+            {
+                return m_path;
+            }
+
+        private:
+            MappedFile(MappedFile const &);
+            MappedFile & operator=(MappedFile const &);
+
+        private:
+            uint8_t * m_data;
+            uint64_t m_size;
+            std::string m_path;
+#ifdef _WIN32
+            void * m_file;
+            void * m_mapping;
+#else
+            int m_fd;
+#endif
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_MAPPED_FILE_H_
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// GDB includes
+#include "memory_accounting.h"
+
+namespace dbg_mi
+{
+    void MemoryAccounting::Add(wxString const & name, long long count, long long bytes)
+    {
+        Entry entry;
+        entry.name = name;
+        entry.count = count;
+        entry.bytes = bytes;
+        m_entries.push_back(entry);
+    }
+
+    void MemoryAccounting::MeasureWatchTree(cb::shared_ptr<const cbWatch> const & watch, size_t objectSize, long long & count, long long & bytes)
+    {
+        if (!watch)
+        {
+            return;
+        }
+
+        wxString symbol, value, type;
+        watch->GetSymbol(symbol);
+        watch->GetValue(value);
+        watch->GetType(type);
+        count++;
+        bytes += objectSize + StringBytes(symbol) + StringBytes(value) + StringBytes(type);
+        int const childCount = watch->GetChildCount();
+        bytes += childCount * sizeof(cb::shared_ptr<cbWatch>);
+
+        for (int child = 0; child < childCount; ++child)
+        {
+            MeasureWatchTree(watch->GetChild(child), objectSize, count, bytes);
+        }
+    }
+
+    long long MemoryAccounting::GetTotalBytes() const
+    {
+        long long total = 0;
+
+        for (Entries::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            total += it->bytes;
+        }
+
+        return total;
+    }
+
+    wxString MemoryAccounting::Format() const
+    {
+        wxString text = "Debugger state memory (approximate)\n";
+        text += wxString::Format("  %-28s %12s %14s\n", "container", "objects", "bytes");
+
+        for (Entries::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            text += wxString::Format("  %-28s %12lld %14lld\n", it->name, it->count, it->bytes);
+        }
+
+        text += wxString::Format("  %-28s %12s %14lld\n", "total", "", GetTotalBytes());
+        return text;
+    }
+
+    wxString MemoryAccounting::FormatShort() const
+    {
+        wxString text = wxString::Format("Debugger state memory %lld bytes:", GetTotalBytes());
+
+        for (Entries::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            text += wxString::Format(" %s=%lld/%lldB", it->name, it->count, it->bytes);
+        }
+
+        return text;
+    }
+
+} // namespace dbg_mi
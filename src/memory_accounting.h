@@ -0,0 +1,63 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_MEMORY_ACCOUNTING_H_
+#define _DEBUGGER_GDB_MI_MEMORY_ACCOUNTING_H_
+
+// System and library includes
+#include <vector>
+#include <wx/string.h>
+
+// CB includes
+#include <debuggermanager.h>
+
+namespace dbg_mi
+{
+    /** Snapshot of the live objects and approximate bytes held by the debugger state.
+     *
+     * The byte counts are estimates: object sizes plus the characters of the strings they own.
+     * They are meant to show which part of the state grows during a long session, not to match RSS.
+     */
+    class MemoryAccounting
+    {
+        public:
+            struct Entry
+            {
+                wxString name;
+                long long count;
+                long long bytes;
+            };
+
+            typedef std::vector<Entry> Entries;
+
+        public:
+            void Add(wxString const & name, long long count, long long bytes);
+
+            /** Add the node count and bytes of a watch and all of its children to count and bytes. */
+            static void MeasureWatchTree(cb::shared_ptr<const cbWatch> const & watch, size_t objectSize, long long & count, long long & bytes);
+
+            static long long StringBytes(wxString const & text)
+            {
+                return static_cast<long long>(text.length() * sizeof(wxChar));
+            }
+
+            Entries const & GetEntries() const
+            {
+                return m_entries;
+            }
+
+            long long GetTotalBytes() const;
+            wxString Format() const;
+            /** One line summary for the log. */
+            wxString FormatShort() const;
+
+        private:
+            Entries m_entries;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_MEMORY_ACCOUNTING_H_
@@ -0,0 +1,197 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <algorithm>
+#include <cstring>
+
+// GDB includes
+#include "memory_cache.h"
+
+namespace dbg_mi
+{
+    namespace
+    {
+        inline uint64_t PageStart(uint64_t address)
+        {
+            return address & ~(MemoryPageCache::PageSize - 1);
+        }
+
+        bool SpanStartsBefore(MemorySpan const & a, MemorySpan const & b)
+        {
+            return a.start < b.start;
+        }
+    }
+
+    MemoryPageCache::MemoryPageCache() :
+        m_readers(0),
+        m_hits(0),
+        m_misses(0),
+        m_saved_reads(0),
+        m_epoch(0)
+    {
+    }
+
+    bool MemoryPageCache::Read(uint64_t address, size_t size, std::vector<uint8_t> & bytes)
+    {
+        if (!Copy(address, size, bytes))
+        {
+            m_misses++;
+            return false;
+        }
+
+        m_hits++;
+        return true;
+    }
+
+    bool MemoryPageCache::Copy(uint64_t address, size_t size, std::vector<uint8_t> & bytes) const
+    {
+        uint64_t start, end;
+
+        if ((size == 0) || GetMissingSpan(address, size, start, end))
+        {
+            return false;
+        }
+
+        bytes.resize(size);
+        size_t done = 0;
+
+        while (done < size)
+        {
+            uint64_t const current = address + done;
+            std::vector<uint8_t> const & page = m_pages.find(PageStart(current))->second;
+            size_t const offset = static_cast<size_t>(current - PageStart(current));
+            size_t const count = (size - done < PageSize - offset) ? (size - done) : static_cast<size_t>(PageSize - offset);
+            std::memcpy(bytes.data() + done, page.data() + offset, count);
+            done += count;
+        }
+
+        return true;
+    }
+
+    void MemoryPageCache::Store(uint64_t address, uint8_t const * data, size_t size)
+    {
+        uint64_t page = PageStart(address);
+
+        if (page < address)
+        {
+            // The first page is not covered completely
+            page += PageSize;
+        }
+
+        for (; page + PageSize <= address + size; page += PageSize)
+        {
+            uint8_t const * source = data + (page - address);
+            m_pages[page].assign(source, source + PageSize);
+        }
+    }
+
+    bool MemoryPageCache::GetMissingSpan(uint64_t address, size_t size, uint64_t & start, uint64_t & end) const
+    {
+        bool missing = false;
+        uint64_t const last = PageStart(address + (size ? size - 1 : 0));
+
+        // Counted loop, the last page of the address space would wrap page + PageSize around to 0
+        for (uint64_t page = PageStart(address), count = (last - PageStart(address)) / PageSize + 1; count > 0; page += PageSize, --count)
+        {
+            if (m_pages.find(page) == m_pages.end())
+            {
+                if (!missing)
+                {
+                    start = page;
+                    missing = true;
+                }
+
+                end = page + PageSize;
+            }
+        }
+
+        return missing;
+    }
+
+    void MemoryPageCache::Invalidate()
+    {
+        m_epoch++;
+        m_pages.clear();
+    }
+
+    void MemoryPageCache::Invalidate(uint64_t address, size_t size)
+    {
+        m_epoch++;
+        uint64_t const last = PageStart(address + (size ? size - 1 : 0));
+
+        for (uint64_t page = PageStart(address), count = (last - PageStart(address)) / PageSize + 1; count > 0; page += PageSize, --count)
+        {
+            m_pages.erase(page);
+        }
+    }
+
+    size_t MemoryPageCache::GetMemoryBytes() const
+    {
+        size_t bytes = m_pages.bucket_count() * sizeof(void *);
+
+        for (Pages::const_iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        {
+            bytes += sizeof(Pages::value_type) + it->second.capacity();
+        }
+
+        return bytes;
+    }
+
+    std::vector<MemorySpan> CoalesceSpans(std::vector<MemorySpan> spans, uint64_t gap)
+    {
+        std::sort(spans.begin(), spans.end(), SpanStartsBefore);
+
+        std::vector<MemorySpan> merged;
+
+        for (std::vector<MemorySpan>::const_iterator it = spans.begin(); it != spans.end(); ++it)
+        {
+            // Compared as a distance, end + gap could wrap at the top of the address space
+            if (!merged.empty() && ((it->start <= merged.back().end) || (it->start - merged.back().end <= gap)))
+            {
+                merged.back().end = std::max(merged.back().end, it->end);
+            }
+            else
+            {
+                merged.push_back(*it);
+            }
+        }
+
+        return merged;
+    }
+
+    std::vector<MemorySpan> FindUncovered(std::vector<MemorySpan> const & spans, uint64_t start, uint64_t end)
+    {
+        std::vector<MemorySpan> const covered = CoalesceSpans(spans, 0);
+        std::vector<MemorySpan> uncovered;
+        uint64_t position = start;
+
+        for (std::vector<MemorySpan>::const_iterator it = covered.begin(); (it != covered.end()) && (position < end); ++it)
+        {
+            if (it->end <= position)
+            {
+                continue;
+            }
+
+            if (it->start > position)
+            {
+                MemorySpan const hole = {position, std::min(it->start, end)};
+                uncovered.push_back(hole);
+            }
+
+            position = std::max(position, it->end);
+        }
+
+        if (position < end)
+        {
+            MemorySpan const hole = {position, end};
+            uncovered.push_back(hole);
+        }
+
+        return uncovered;
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,140 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_MEMORY_CACHE_H_
+#define _DEBUGGER_GDB_MI_MEMORY_CACHE_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dbg_mi
+{
+    /** Address range [start, end). */
+    struct MemorySpan
+    {
+        uint64_t start;
+        uint64_t end;
+    };
+
+    /** Sort the spans and merge the ones that overlap or are at most gap bytes apart. */
+    std::vector<MemorySpan> CoalesceSpans(std::vector<MemorySpan> spans, uint64_t gap);
+
+    /** The parts of [start, end) that none of the spans cover, in address order. */
+    std::vector<MemorySpan> FindUncovered(std::vector<MemorySpan> const & spans, uint64_t start, uint64_t end);
+
+    /** Target memory read while the debuggee is stopped, shared by all the memory views.
+     *
+     * Memory is kept in pages of PageSize bytes keyed by their address. A view first looks in the
+     * cache, on a miss it reads the page aligned span of the missing pages with a single
+     * -data-read-memory-bytes and stores it, so the next view over the same memory is served
+     * without asking GDB. Everything is dropped when the debuggee resumes, pages are dropped when
+     * the plugin writes to them.
+     *
+     * Does not depend on wxWidgets.
+     */
+    class MemoryPageCache
+    {
+        public:
+            static const uint64_t PageSize = 4096;
+
+        public:
+            MemoryPageCache();
+
+            /** Copy size bytes at address to bytes. Returns false, and counts a miss, unless every page is cached. */
+            bool Read(uint64_t address, size_t size, std::vector<uint8_t> & bytes);
+            /** Same as Read() without counting, used once the missing pages were just read. */
+            bool Copy(uint64_t address, size_t size, std::vector<uint8_t> & bytes) const;
+
+            /** Store memory read from GDB, only the pages it covers completely are kept. */
+            void Store(uint64_t address, uint8_t const * data, size_t size);
+
+            /** Page aligned span [start, end) covering the pages of address..address+size that are not cached.
+             *
+             * Returns false if every page is cached.
+             */
+            bool GetMissingSpan(uint64_t address, size_t size, uint64_t & start, uint64_t & end) const;
+
+            /** Changes whenever cached memory is invalidated, memory read in the same epoch is still valid. */
+            unsigned long GetEpoch() const
+            {
+                return m_epoch;
+            }
+
+            /** The debuggee ran, nothing cached is valid anymore. */
+            void Invalidate();
+            /** Memory was written, drop the pages it touches. */
+            void Invalidate(uint64_t address, size_t size);
+
+            /** Memory read actions queued or running. A new one waits for them, so it finds their pages in the cache.
+             *
+             * The read actions call AddReader() in their constructor: ask HasReaders() before making
+             * the new one, or the first reader would wait for itself and for no reason.
+             */
+            void AddReader()
+            {
+                m_readers++;
+            }
+
+            void RemoveReader()
+            {
+                m_readers--;
+            }
+
+            bool HasReaders() const
+            {
+                return m_readers > 0;
+            }
+
+            int GetReaderCount() const
+            {
+                return m_readers;
+            }
+
+            size_t GetPageCount() const
+            {
+                return m_pages.size();
+            }
+
+            unsigned long GetHits() const
+            {
+                return m_hits;
+            }
+
+            unsigned long GetMisses() const
+            {
+                return m_misses;
+            }
+
+            /** Reads not sent to GDB because the ranges were merged with others. */
+            void AddSavedReads(unsigned long count)
+            {
+                m_saved_reads += count;
+            }
+
+            unsigned long GetSavedReads() const
+            {
+                return m_saved_reads;
+            }
+
+            size_t GetMemoryBytes() const;
+
+        private:
+            typedef std::unordered_map<uint64_t, std::vector<uint8_t>> Pages;
+
+            Pages m_pages;
+            int m_readers;
+            unsigned long m_hits;
+            unsigned long m_misses;
+            unsigned long m_saved_reads;
+            unsigned long m_epoch;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_MEMORY_CACHE_H_
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+    #define MEMORY_DIFF_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+// GDB includes
+#include "memory_diff.h"
+
+namespace dbg_mi
+{
+    namespace
+    {
+        /** Offset of the first byte from start on that differs, length if there is none. */
+        size_t NextDifference(uint8_t const * before, uint8_t const * after, size_t start, size_t length)
+        {
+#ifdef MEMORY_DIFF_SSE2
+            for (; start + 16 <= length; start += 16)
+            {
+                __m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(before + start));
+                __m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(after + start));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF)
+                {
+                    // The scalar loop below finds the byte inside this block
+                    break;
+                }
+            }
+#endif // MEMORY_DIFF_SSE2
+
+            for (; start < length; ++start)
+            {
+                if (before[start] != after[start])
+                {
+                    return start;
+                }
+            }
+
+            return length;
+        }
+    }
+
+    void FindChangedSpans(uint8_t const * before, uint8_t const * after, size_t length, std::vector<MemorySpan> & spans)
+    {
+        size_t offset = NextDifference(before, after, 0, length);
+
+        while (offset < length)
+        {
+            size_t end = offset + 1;
+
+            while ((end < length) && (before[end] != after[end]))
+            {
+                ++end;
+            }
+
+            MemorySpan const span = {offset, end};
+            spans.push_back(span);
+            offset = NextDifference(before, after, end, length);
+        }
+    }
+
+    bool MemorySnapshot::Update(uint64_t address, std::vector<uint8_t> const & bytes, std::vector<MemorySpan> & changed)
+    {
+        bool const comparable = m_valid && (m_address == address) && (m_bytes.size() == bytes.size());
+
+        if (comparable)
+        {
+            FindChangedSpans(m_bytes.data(), bytes.data(), bytes.size(), changed);
+        }
+
+        // Copied into the existing buffer, a range viewed at every stop is not reallocated
+        m_bytes.assign(bytes.begin(), bytes.end());
+        m_address = address;
+        m_valid = true;
+        return comparable;
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,66 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_MEMORY_DIFF_H_
+#define _DEBUGGER_GDB_MI_MEMORY_DIFF_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GDB includes
+#include "memory_cache.h"
+
+namespace dbg_mi
+{
+    /** Append the runs of bytes that differ between before and after as offset spans [start, end).
+     *
+     * Equal memory is skipped 16 bytes at a time with SSE2 on x86, so a view of several MB with a
+     * few changes costs about a memcmp.
+     *
+     * Does not depend on wxWidgets.
+     */
+    void FindChangedSpans(uint8_t const * before, uint8_t const * after, size_t length, std::vector<MemorySpan> & spans);
+
+    /** The memory a view showed at the previous stop. */
+    class MemorySnapshot
+    {
+        public:
+            MemorySnapshot() :
+                m_address(0),
+                m_valid(false)
+            {
+            }
+
+            /** Keep bytes read at address as the new snapshot.
+             *
+             * Returns true, with the changed bytes as offset spans, if the previous snapshot was of
+             * the same range. Returns false for a first or a different range, all of it is new then.
+             */
+            bool Update(uint64_t address, std::vector<uint8_t> const & bytes, std::vector<MemorySpan> & changed);
+
+            /** Forget the snapshot, e.g. when the view showed an error instead. */
+            void Clear()
+            {
+                m_bytes.clear();
+                m_valid = false;
+            }
+
+            size_t GetSize() const
+            {
+                return m_bytes.capacity();
+            }
+
+        private:
+            uint64_t m_address;
+            std::vector<uint8_t> m_bytes;
+            bool m_valid;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_MEMORY_DIFF_H_
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <cstring>
+
+// GDB includes
+#include "mapped_file.h"
+#include "memory_dump.h"
+
+namespace dbg_mi
+{
+    void MemoryDumpRegistry::Add(MemoryDump const & dump)
+    {
+        for (std::vector<MemoryDump>::iterator it = m_dumps.begin(); it != m_dumps.end(); ++it)
+        {
+            if (it->path == dump.path)
+            {
+                m_dumps.erase(it);
+                break;
+            }
+        }
+
+        m_dumps.push_back(dump);
+    }
+
+    namespace
+    {
+        bool HasUnreadable(MemoryDump const & dump, uint64_t address, uint64_t size)
+        {
+            for (std::vector<MemorySpan>::const_iterator it = dump.unreadable.begin(); it != dump.unreadable.end(); ++it)
+            {
+                // The zeros written for the hole are not the target memory
+                if ((it->start - address < size) || (address - it->start < it->end - it->start))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    MemoryDump const * MemoryDumpRegistry::Find(uint64_t address, uint64_t size, unsigned long epoch) const
+    {
+        for (std::vector<MemoryDump>::const_reverse_iterator it = m_dumps.rbegin(); it != m_dumps.rend(); ++it)
+        {
+            // Compared as offsets, address + size could wrap at the top of the address space
+            if ((it->epoch == epoch) && (address >= it->address) && (size <= it->size) && (address - it->address <= it->size - size)
+                && !HasUnreadable(*it, address, size))
+            {
+                return &*it;
+            }
+        }
+
+        return nullptr;
+    }
+
+    uint64_t MemoryDumpRegistry::GetUnreadableBytes(MemoryDump const & dump)
+    {
+        uint64_t bytes = 0;
+
+        for (std::vector<MemorySpan>::const_iterator it = dump.unreadable.begin(); it != dump.unreadable.end(); ++it)
+        {
+            bytes += it->end - it->start;
+        }
+
+        return bytes;
+    }
+
+    bool MemoryDumpRegistry::Read(MemoryDump const & dump, uint64_t address, size_t size, std::vector<uint8_t> & bytes, std::string & error)
+    {
+        if ((address < dump.address) || (size > dump.size) || (address - dump.address > dump.size - size))
+        {
+            error = "the range is not part of the dump";
+            return false;
+        }
+
+        MappedFile file;
+
+        if (!file.Open(dump.path, MappedFile::ReadOnly, 0, error))
+        {
+            return false;
+        }
+
+        if (file.GetSize() != dump.size)
+        {
+            error = "the file was changed after the dump";
+            return false;
+        }
+
+        bytes.resize(size);
+
+        if (size > 0)
+        {
+            std::memcpy(bytes.data(), file.GetData() + (address - dump.address), size);
+        }
+
+        return true;
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_MEMORY_DUMP_H_
+#define _DEBUGGER_GDB_MI_MEMORY_DUMP_H_
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GDB includes
+#include "memory_cache.h"
+
+namespace dbg_mi
+{
+    /** Target memory written to a file by "Dump memory to file", the file holds the raw bytes. */
+    struct MemoryDump
+    {
+        std::string path;       ///< UTF-8
+        uint64_t address;
+        uint64_t size;
+        unsigned long epoch;    ///< MemoryPageCache::GetEpoch() when the dump finished
+        std::vector<MemorySpan> unreadable; ///< target memory GDB could not read, zero in the file
+    };
+
+    /** The dumps written in this Code::Blocks session.
+     *
+     * A dump of the current epoch still matches the target, memory views read it from the file
+     * instead of asking GDB again. Older dumps can be opened explicitly.
+     *
+     * Does not depend on wxWidgets.
+     */
+    class MemoryDumpRegistry
+    {
+        public:
+            /** Register a finished dump, it replaces an older dump written to the same file. */
+            void Add(MemoryDump const & dump);
+
+            /** The newest dump of epoch holding address..address+size, nullptr if there is none.
+             *
+             * A dump is only used if GDB could read all of address..address+size when it was written.
+             */
+            MemoryDump const * Find(uint64_t address, uint64_t size, unsigned long epoch) const;
+
+            std::vector<MemoryDump> const & GetDumps() const
+            {
+                return m_dumps;
+            }
+
+            /** Bytes of the dump GDB could not read. */
+            static uint64_t GetUnreadableBytes(MemoryDump const & dump);
+
+            /** Copy size bytes at address out of the dump file. */
+            static bool Read(MemoryDump const & dump, uint64_t address, size_t size, std::vector<uint8_t> & bytes, std::string & error);
+
+        private:
+            std::vector<MemoryDump> m_dumps;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_MEMORY_DUMP_H_
@@ -0,0 +1,369 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <cstdio>
+#include <cstring>
+
+// GDB includes
+#include "mi_recorder.h"
+
+namespace dbg_mi
+{
+    namespace
+    {
+        const char RecorderMagic[8] = {'G', 'D', 'B', 'M', 'I', 'R', 'E', 'C'};
+        const uint32_t RecorderVersion = 1;
+        const uint16_t RecordSync = 0x4D52;
+        const uint64_t RecordAlignment = 8;
+        const uint64_t MinimumCapacity = 64 * 1024;
+
+        inline uint64_t AlignUp(uint64_t value)
+        {
+            return (value + RecordAlignment - 1) & ~(RecordAlignment - 1);
+        }
+
+        bool IsValidRecord(MIRecorder::RecordHeader const & rec, uint64_t available)
+        {
+            return rec.sync == RecordSync
+                   && rec.kind >= MIRecorder::KindSend
+                   && rec.kind <= MIRecorder::KindNote
+                   && sizeof(MIRecorder::RecordHeader) + AlignUp(rec.payload_length) <= available;
+        }
+
+        void WriteJSONString(std::ostream & out, char const * data, size_t length)
+        {
+            out << '"';
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                unsigned char c = static_cast<unsigned char>(data[i]);
+
+                switch (c)
+                {
+                    case '"':
+                        out << "\\\"";
+                        break;
+
+                    case '\\':
+                        out << "\\\\";
+                        break;
+
+                    case '\n':
+                        out << "\\n";
+                        break;
+
+                    case '\r':
+                        out << "\\r";
+                        break;
+
+                    case '\t':
+                        out << "\\t";
+                        break;
+
+                    default:
+                        if (c < 0x20)
+                        {
+                            char buffer[8];
+                            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                            out << buffer;
+                        }
+                        else
+                        {
+                            out << static_cast<char>(c);
+                        }
+                }
+            }
+
+            out << '"';
+        }
+
+        char const * KindName(uint8_t kind)
+        {
+            switch (kind)
+            {
+                case MIRecorder::KindSend:
+                    return "send";
+
+                case MIRecorder::KindReceive:
+                    return "recv";
+
+                case MIRecorder::KindNote:
+                    return "note";
+
+                default:
+                    return "pad";
+            }
+        }
+    }
+
+    MIRecorder::MIRecorder() :
+        m_max_payload(0)
+    {
+    }
+
+    MIRecorder::~MIRecorder()
+    {
+        Close();
+
+        // The recording is a scratch file, it only has to outlive the debug session for the export menu
+        if (!m_path.empty())
+        {
+            std::remove(m_path.c_str());
+        }
+    }
+
+    MIRecorder::FileHeader * MIRecorder::GetHeader()
+    {
+        return reinterpret_cast<FileHeader *>(m_file.GetData());
+    }
+
+    bool MIRecorder::Open(std::string const & path, uint64_t capacity, std::string & error)
+    {
+        Close();
+
+        if (capacity < MinimumCapacity)
+        {
+            capacity = MinimumCapacity;
+        }
+
+        capacity = AlignUp(capacity);
+
+        if (!m_file.Open(path, MappedFile::CreateReadWrite, sizeof(FileHeader) + capacity, error))
+        {
+            return false;
+        }
+
+        FileHeader * header = GetHeader();
+        std::memset(header, 0, sizeof(FileHeader));
+        std::memcpy(header->magic, RecorderMagic, sizeof(RecorderMagic));
+        header->version = RecorderVersion;
+        header->header_size = sizeof(FileHeader);
+        header->capacity = capacity;
+        header->start_wall_clock_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        m_path = path;
+        m_start = std::chrono::steady_clock::now();
+        // A single record never takes more than 1/16 of the ring, so one huge reply cannot flush the history
+        m_max_payload = capacity / 16;
+        return true;
+    }
+
+    void MIRecorder::Close()
+    {
+        if (m_file.IsOpen())
+        {
+            m_file.Flush();
+            m_file.Close();
+        }
+    }
+
+    uint64_t MIRecorder::GetRecordCount() const
+    {
+        return m_file.IsOpen() ? reinterpret_cast<FileHeader const *>(m_file.GetData())->record_count : 0;
+    }
+
+    uint64_t MIRecorder::GetBytesWritten() const
+    {
+        return m_file.IsOpen() ? reinterpret_cast<FileHeader const *>(m_file.GetData())->write_offset : 0;
+    }
+
+    void MIRecorder::WritePadding(uint64_t position, uint64_t length)
+    {
+        uint8_t * data = m_file.GetData() + sizeof(FileHeader);
+
+        if (length >= sizeof(RecordHeader))
+        {
+            RecordHeader pad;
+            std::memset(&pad, 0, sizeof(pad));
+            pad.sync = RecordSync;
+            pad.kind = KindPadding;
+            pad.payload_length = static_cast<uint32_t>(length - sizeof(RecordHeader));
+            std::memcpy(data + position, &pad, sizeof(pad));
+        }
+        else
+        {
+            std::memset(data + position, 0, static_cast<size_t>(length));
+        }
+    }
+
+    void MIRecorder::Record(RecordKind kind, int32_t action, int32_t command, char const * payload, size_t length)
+    {
+        if (!m_file.IsOpen())
+        {
+            return;
+        }
+
+        FileHeader * header = GetHeader();
+        RecordHeader rec;
+        rec.sync = RecordSync;
+        rec.kind = static_cast<uint8_t>(kind);
+        rec.flags = 0;
+
+        if (length > m_max_payload)
+        {
+            length = static_cast<size_t>(m_max_payload);
+            rec.flags |= FlagTruncated;
+        }
+
+        rec.payload_length = static_cast<uint32_t>(length);
+        rec.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        rec.action = action;
+        rec.command = command;
+
+        uint64_t const recordSize = sizeof(RecordHeader) + AlignUp(length);
+        uint64_t position = header->write_offset % header->capacity;
+
+        // Records never straddle the end of the ring, pad the tail and start over at the beginning
+        if (position + recordSize > header->capacity)
+        {
+            uint64_t tail = header->capacity - position;
+            WritePadding(position, tail);
+            header->write_offset += tail;
+            position = 0;
+        }
+
+        uint8_t * dest = m_file.GetData() + sizeof(FileHeader) + position;
+        std::memcpy(dest, &rec, sizeof(rec));
+        std::memcpy(dest + sizeof(rec), payload, length);
+
+        if (AlignUp(length) != length)
+        {
+            std::memset(dest + sizeof(rec) + length, 0, static_cast<size_t>(AlignUp(length) - length));
+        }
+
+        header->write_offset += recordSize;
+        header->record_count++;
+    }
+
+    bool MIRecorder::Dump(std::string const & path, DumpFormat format, std::ostream & out, std::string & error)
+    {
+        MappedFile file;
+
+        if (!file.Open(path, MappedFile::ReadOnly, 0, error))
+        {
+            return false;
+        }
+
+        if (file.GetSize() < sizeof(FileHeader))
+        {
+            error = "file is too small to be a MI recording";
+            return false;
+        }
+
+        FileHeader header;
+        std::memcpy(&header, file.GetData(), sizeof(header));
+
+        if (std::memcmp(header.magic, RecorderMagic, sizeof(RecorderMagic)) != 0 || header.version != RecorderVersion)
+        {
+            error = "not a MI recording or unsupported version";
+            return false;
+        }
+
+        if (header.capacity == 0 || header.header_size + header.capacity > file.GetSize())
+        {
+            error = "corrupt MI recording header";
+            return false;
+        }
+
+        uint8_t const * data = file.GetData() + header.header_size;
+        bool const wrapped = header.write_offset > header.capacity;
+        // Oldest byte still present in the ring, and how many bytes of history there are
+        uint64_t position = wrapped ? header.write_offset % header.capacity : 0;
+        uint64_t remaining = wrapped ? header.capacity : header.write_offset;
+        bool synced = !wrapped;
+        bool first = true;
+
+        if (format == DumpJSON)
+        {
+            out << "{\"start_wall_clock_ms\":" << header.start_wall_clock_ms
+                << ",\"records_total\":" << header.record_count
+                << ",\"wrapped\":" << (wrapped ? "true" : "false")
+                << ",\"records\":[\n";
+        }
+        else
+        {
+            out << "# MI recording, start wall clock (ms since epoch) " << header.start_wall_clock_ms
+                << ", " << header.record_count << " records written" << (wrapped ? ", oldest records overwritten" : "") << "\n";
+        }
+
+        while (remaining >= sizeof(RecordHeader))
+        {
+            uint64_t const untilEnd = header.capacity - position;
+
+            if (untilEnd < sizeof(RecordHeader))
+            {
+                // Zero filled tail shorter than a record header
+                remaining -= (untilEnd < remaining) ? untilEnd : remaining;
+                position = 0;
+                continue;
+            }
+
+            RecordHeader rec;
+            std::memcpy(&rec, data + position, sizeof(rec));
+            uint64_t const limit = (untilEnd < remaining) ? untilEnd : remaining;
+
+            if (!IsValidRecord(rec, limit))
+            {
+                if (synced)
+                {
+                    error = "corrupt record in MI recording";
+                    break;
+                }
+
+                // After a wrap the oldest record may be partially overwritten, look for the next one
+                position = (position + RecordAlignment) % header.capacity;
+                remaining -= RecordAlignment;
+                continue;
+            }
+
+            synced = true;
+            uint64_t const recordSize = sizeof(RecordHeader) + AlignUp(rec.payload_length);
+
+            if (rec.kind != KindPadding)
+            {
+                char const * payload = reinterpret_cast<char const *>(data + position + sizeof(RecordHeader));
+
+                if (format == DumpJSON)
+                {
+                    out << (first ? "" : ",\n")
+                        << "{\"t_ns\":" << rec.timestamp_ns
+                        << ",\"dir\":\"" << KindName(rec.kind) << "\""
+                        << ",\"action\":" << rec.action
+                        << ",\"command\":" << rec.command
+                        << ",\"truncated\":" << ((rec.flags & FlagTruncated) ? "true" : "false")
+                        << ",\"data\":";
+                    WriteJSONString(out, payload, rec.payload_length);
+                    out << "}";
+                }
+                else
+                {
+                    char prefix[96];
+                    std::snprintf(prefix, sizeof(prefix), "[%14.6f] %s %6d:%-6d ",
+                                  static_cast<double>(rec.timestamp_ns) / 1e9,
+                                  (rec.kind == KindSend) ? ">>" : ((rec.kind == KindReceive) ? "<<" : "--"),
+                                  rec.action,
+                                  rec.command);
+                    out << prefix;
+                    out.write(payload, rec.payload_length);
+                    out << ((rec.flags & FlagTruncated) ? " <truncated>\n" : "\n");
+                }
+
+                first = false;
+            }
+
+            position = (position + recordSize) % header.capacity;
+            remaining -= recordSize;
+        }
+
+        if (format == DumpJSON)
+        {
+            out << "\n]}\n";
+        }
+
+        return error.empty();
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_MI_RECORDER_H_
+#define _DEBUGGER_GDB_MI_MI_RECORDER_H_
+
+// System and library includes
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// GDB includes
+#include "mapped_file.h"
+
+namespace dbg_mi
+{
+    /** Always-on recorder of the MI traffic exchanged with GDB.
+     *
+     * Every command sent and every record received is appended to a memory mapped binary file
+     * together with a monotonic timestamp and the CommandID. The file has a fixed size and is used
+     * as a ring, so the newest traffic overwrites the oldest. Writing a record is a single copy into
+     * the mapping, there is no system call per record.
+     *
+     * File layout (little endian):
+     *   FileHeader   - 64 bytes, see below
+     *   data region  - capacity bytes, a sequence of 8 byte aligned records
+     *   record       - RecordHeader (24 bytes) followed by the UTF-8 payload padded to 8 bytes
+     *
+     * The recorder and MIRecorder::Dump() do not depend on wxWidgets, so the same code is used by
+     * the stand alone tools/mi_recorder_dump converter.
+     */
+    class MIRecorder
+    {
+        public:
+            enum RecordKind
+            {
+                KindSend = 1,       ///< command written to GDB
+                KindReceive = 2,    ///< line read from GDB
+                KindPadding = 3,    ///< filler up to the end of the data region
+                KindNote = 4        ///< plugin annotation, e.g. session start
+            };
+
+            enum RecordFlags
+            {
+                FlagTruncated = 0x01
+            };
+
+            enum DumpFormat
+            {
+                DumpText,
+                DumpJSON
+            };
+
+            struct FileHeader
+            {
+                char magic[8];
+                uint32_t version;
+                uint32_t header_size;
+                uint64_t capacity;
+                uint64_t write_offset;      ///< logical number of bytes written, wraps modulo capacity
+                uint64_t record_count;
+                uint64_t start_wall_clock_ms;
+                uint64_t reserved[2];
+            };
+
+            struct RecordHeader
+            {
+                uint16_t sync;
+                uint8_t kind;
+                uint8_t flags;
+                uint32_t payload_length;
+                uint64_t timestamp_ns;      ///< monotonic, relative to the start of the recording
+                int32_t action;
+                int32_t command;
+            };
+
+            static const uint64_t DefaultCapacity = 16 * 1024 * 1024;
+
+        public:
+            MIRecorder();
+            /** Closes and deletes the recording file. */
+            ~MIRecorder();
+
+            bool Open(std::string const & path, uint64_t capacity, std::string & error);
+            void Close();
+
+            bool IsOpen() const
+            {
+                return m_file.IsOpen();
+            }
+
+            std::string const & GetPath() const
+            {
+                return m_path;
+            }
+
+            void Record(RecordKind kind, int32_t action, int32_t command, char const * data, size_t length);
+
+            uint64_t GetRecordCount() const;
+            uint64_t GetBytesWritten() const;
+
+            /** Convert a recording into text or JSON. Works on a closed file or on a copy. */
+            static bool Dump(std::string const & path, DumpFormat format, std::ostream & out, std::string & error);
+
+        private:
+            MIRecorder(MIRecorder const &);
+            MIRecorder & operator=(MIRecorder const &);
+
+            FileHeader * GetHeader();
+            void WritePadding(uint64_t position, uint64_t length);
+
+        private:
+            MappedFile m_file;
+            std::string m_path;
+            std::chrono::steady_clock::time_point m_start;
+            uint64_t m_max_payload;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_MI_RECORDER_H_
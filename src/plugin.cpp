@@ -6,7 +6,12 @@
 
 // System include files
 #include <algorithm>
+#include <fstream>
 #include <tinyxml2.h>
+#include <wx/choicdlg.h>
+#include <wx/filedlg.h>
+#include <wx/filename.h>
+#include <wx/textdlg.h>
 #include <wx/xrc/xmlres.h>
 #include <wx/wxscintilla.h>
 #ifndef __WX_MSW__
@@ -35,8 +40,10 @@
 // GDB include files
 #include "actions.h"
 #include "cmd_result_parser.h"
+#include "commandstreamdlg.h"
 #include "escape.h"
 #include "frame.h"
+#include "hex_codec.h"
 #include "debuggeroptionsdlg.h"
 #include "gdb_logger.h"
 #include "databreakpointdlg.h"
@@ -52,7 +59,18 @@ namespace
 {
     int const id_gdb_process = wxNewId();
     int const id_gdb_poll_timer = wxNewId();
+    int const id_gdb_tooltip_timer = wxNewId();
     int const id_menu_info_command_stream = wxNewId();
+    int const id_menu_export_mi_traffic = wxNewId();
+    int const id_menu_export_pipeline_trace = wxNewId();
+    int const id_menu_show_statistics = wxNewId();
+    int const id_menu_dump_memory = wxNewId();
+    int const id_menu_open_memory_dump = wxNewId();
+
+    // How often the memory accounting snapshot is written to the log while a session runs
+    long const MemorySnapshotIntervalMs = 60 * 1000;
+    // Hover requests closer together than this are merged, only the last one is evaluated
+    int const TooltipDebounceMs = 150;
 
     // Register the plugin with Code::Blocks.
     // We are using an anonymous namespace so we don't litter the global one.
@@ -88,6 +106,21 @@ namespace
         }
     }
 
+    bool HasFrozenChild(cb::shared_ptr<dbg_mi::GDBWatch> const & watch)
+    {
+        for (int child = 0; child < watch->GetChildCount(); ++child)
+        {
+            cb::shared_ptr<dbg_mi::GDBWatch> gdbChild = cb::static_pointer_cast<dbg_mi::GDBWatch>(watch->GetChild(child));
+
+            if (gdbChild->IsFrozen() || HasFrozenChild(gdbChild))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
 } // anonymous namespace
 
 // events handling
@@ -99,8 +132,14 @@ BEGIN_EVENT_TABLE(Debugger_GDB_MI, cbDebuggerPlugin)
 
     EVT_IDLE(Debugger_GDB_MI::OnIdle)
     EVT_TIMER(id_gdb_poll_timer, Debugger_GDB_MI::OnTimer)
+    EVT_TIMER(id_gdb_tooltip_timer, Debugger_GDB_MI::OnTooltipTimer)
 
     EVT_MENU(id_menu_info_command_stream, Debugger_GDB_MI::OnMenuInfoCommandStream)
+    EVT_MENU(id_menu_export_mi_traffic, Debugger_GDB_MI::OnMenuExportMITraffic)
+    EVT_MENU(id_menu_export_pipeline_trace, Debugger_GDB_MI::OnMenuExportPipelineTrace)
+    EVT_MENU(id_menu_show_statistics, Debugger_GDB_MI::OnMenuShowStatistics)
+    EVT_MENU(id_menu_dump_memory, Debugger_GDB_MI::OnMenuDumpMemory)
+    EVT_MENU(id_menu_open_memory_dump, Debugger_GDB_MI::OnMenuOpenMemoryDump)
 END_EVENT_TABLE()
 
 // constructor
@@ -108,6 +147,8 @@ Debugger_GDB_MI::Debugger_GDB_MI() :
     cbDebuggerPlugin("GDB/MI", "gdbmi_debugger"),
     m_pProject(nullptr),
     m_command_stream_dialog(nullptr),
+    m_statistics_dialog(nullptr),
+    m_memory_snapshot_ms(0),
     m_console_pid(-1),
     m_pid_attached(0)
 {
@@ -121,6 +162,7 @@ Debugger_GDB_MI::Debugger_GDB_MI() :
 
     m_pLogger = new dbg_mi::LogPaneLogger(this);
     m_executor.SetLogger(m_pLogger);
+    m_executor.SetRecorder(&m_mi_recorder);
 }
 
 // destructor
@@ -131,6 +173,7 @@ Debugger_GDB_MI::~Debugger_GDB_MI()
 void Debugger_GDB_MI::OnAttachReal()
 {
     m_timer_poll_debugger.SetOwner(this, id_gdb_poll_timer);
+    m_timer_tooltip.SetOwner(this, id_gdb_tooltip_timer);
     DebuggerManager & dbg_manager = *Manager::Get()->GetDebuggerManager();
     dbg_manager.RegisterDebugger(this);
 
@@ -150,11 +193,22 @@ void Debugger_GDB_MI::OnReleaseReal(bool appShutDown)
         m_command_stream_dialog->Destroy();
         m_command_stream_dialog = nullptr;
     }
+
+    if (m_statistics_dialog)
+    {
+        m_statistics_dialog->Destroy();
+        m_statistics_dialog = nullptr;
+    }
 }
 
 void Debugger_GDB_MI::SetupToolsMenu(wxMenu & menu)
 {
     menu.Append(id_menu_info_command_stream, _("Show command stream"));
+    menu.Append(id_menu_export_mi_traffic, _("Export MI traffic recording..."));
+    menu.Append(id_menu_export_pipeline_trace, _("Export pipeline trace..."));
+    menu.Append(id_menu_show_statistics, _("Show debugger statistics"));
+    menu.Append(id_menu_dump_memory, _("Dump memory to file..."));
+    menu.Append(id_menu_open_memory_dump, _("Open memory dump..."));
 }
 
 bool Debugger_GDB_MI::SupportsFeature(cbDebuggerFeature::Flags flag)
@@ -246,7 +300,10 @@ bool Debugger_GDB_MI::SelectCompiler(cbProject & project, Compiler *& compiler,
 
 void Debugger_GDB_MI::OnGDBOutput(wxCommandEvent & event)
 {
+    dbg_mi::TraceSpan span("OnGDBOutput");
+    dbg_mi::StallScope stallScope(dbg_mi::StallWatchdog::EntryOnGDBOutput, &m_executor);
     wxString const & msg = event.GetString();
+    stallScope.SetReplySize(msg.length());
 
     if (!msg.IsEmpty() &&
             !msg.IsSameAs("(gdb) ") &&
@@ -299,8 +356,18 @@ void Debugger_GDB_MI::OnGDBTerminated(wxCommandEvent & /*event*/)
     ClearActiveMarkFromAllEditors();
     m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("debugger terminated!")), dbg_mi::LogPaneLogger::LineType::Warning);
     m_timer_poll_debugger.Stop();
+    m_timer_tooltip.Stop();
+    // First, the pending actions still refer to the caches below
     m_actions.Clear();
+    m_tooltip_cache.Clear();
+    m_memory_cache.Invalidate();
+    m_examine_snapshot.Clear();
+    m_disassembly_cache.Clear();
+    m_register_cache.Clear();
+    m_backtrace_cache.Clear();
+    m_watches.ClearLocals();
     m_executor.Clear();
+    m_mi_recorder.Close();
 
     // Notify debugger plugins for end of debug session
     PluginManager * plm = Manager::Get()->GetPluginManager();
@@ -331,11 +398,15 @@ void Debugger_GDB_MI::OnGDBTerminated(wxCommandEvent & /*event*/)
 
 void Debugger_GDB_MI::OnIdle(wxIdleEvent & event)
 {
+    dbg_mi::StallScope stallScope(dbg_mi::StallWatchdog::EntryOnIdle, &m_executor);
+
     if (m_executor.IsStopped() && m_executor.IsRunning())
     {
         m_actions.Run(m_executor);
     }
 
+    dbg_mi::FlushWatchUpdates(m_pLogger);
+
     if (m_executor.ProcessHasInput())
     {
         event.RequestMore();
@@ -348,31 +419,361 @@ void Debugger_GDB_MI::OnIdle(wxIdleEvent & event)
 
 void Debugger_GDB_MI::OnTimer(wxTimerEvent & /*event*/)
 {
-    RunQueue();
+    {
+        dbg_mi::StallScope stallScope(dbg_mi::StallWatchdog::EntryOnTimer, &m_executor);
+        RunQueue();
+    }
+
+    wxLongLong const now = wxGetUTCTimeMillis();
+
+    if (now - m_memory_snapshot_ms >= MemorySnapshotIntervalMs)
+    {
+        m_memory_snapshot_ms = now;
+        dbg_mi::MemoryAccounting stats;
+        CollectMemoryStatistics(stats);
+        dbg_mi::LogPaneLogger::LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, stats.FormatShort(), dbg_mi::LogPaneLogger::LineType::Debug);
+    }
+
     wxWakeUpIdle();
 }
 
 void Debugger_GDB_MI::OnMenuInfoCommandStream(wxCommandEvent & /*event*/)
 {
-    wxString full;
+    if (m_command_stream_dialog)
+    {
+        m_command_stream_dialog->Reload();
+        m_command_stream_dialog->Show();
+    }
+    else
+    {
+        m_command_stream_dialog = new dbg_mi::CommandStreamDlg(Manager::Get()->GetAppWindow(), m_executor.GetCommandHistory());
+        m_command_stream_dialog->Show();
+    }
+}
+
+void Debugger_GDB_MI::CollectMemoryStatistics(dbg_mi::MemoryAccounting & stats)
+{
+    stats.Add("MI result nodes", dbg_mi::ResultValue::GetLiveCount(), dbg_mi::ResultValue::GetLiveBytes());
+    stats.Add("pending results", m_executor.GetPendingResultsCount(), m_executor.GetPendingResultsBytes());
+    dbg_mi::CommandHistory const & history = m_executor.GetCommandHistory();
+    stats.Add("command history", history.GetCount(),
+              history.GetCapacity() * sizeof(dbg_mi::CommandHistory::Entry) + history.GetInternedBytes());
+    long long watchCount = 0, watchBytes = 0;
+    long long tooltipCount = 0, tooltipBytes = 0;
 
-    for (int ii = 0; ii < m_executor.GetCommandQueueCount(); ++ii)
+    for (dbg_mi::GDBWatchesContainer::const_iterator it = m_watches.begin(); it != m_watches.end(); ++it)
     {
-        full += m_executor.GetQueueCommand(ii) + "\n";
+        if ((*it)->ForTooltip())
+        {
+            dbg_mi::MemoryAccounting::MeasureWatchTree(*it, sizeof(dbg_mi::GDBWatch), tooltipCount, tooltipBytes);
+        }
+        else
+        {
+            dbg_mi::MemoryAccounting::MeasureWatchTree(*it, sizeof(dbg_mi::GDBWatch), watchCount, watchBytes);
+        }
     }
 
-    if (m_command_stream_dialog)
+    stats.Add("watches", watchCount, watchBytes);
+    stats.Add("tooltip watches", tooltipCount, tooltipBytes);
+    long long localsCount = 0, localsBytes = 0;
+    dbg_mi::MemoryAccounting::MeasureWatchTree(m_WatchLocalsandArgs, sizeof(dbg_mi::GDBWatch), localsCount, localsBytes);
+    stats.Add("locals and arguments", localsCount, localsBytes);
+    long long rangeBytes = 0;
+
+    for (dbg_mi::GDBMemoryRangeWatchesContainer::const_iterator it = m_memoryRanges.begin(); it != m_memoryRanges.end(); ++it)
     {
-        m_command_stream_dialog->SetText(full);
-        m_command_stream_dialog->Show();
+        wxString value;
+        (*it)->GetValue(value);
+        rangeBytes += sizeof(dbg_mi::GDBMemoryRangeWatch) + dbg_mi::MemoryAccounting::StringBytes((*it)->GetSymbol()) + dbg_mi::MemoryAccounting::StringBytes(value)
+                      + (*it)->GetSnapshot().GetSize();
+    }
+
+    stats.Add("memory range buffers", m_memoryRanges.size(), rangeBytes);
+    stats.Add("examine memory snapshot", 1, m_examine_snapshot.GetSize());
+    stats.Add("memory page cache", m_memory_cache.GetPageCount(), m_memory_cache.GetMemoryBytes());
+    stats.Add("disassembly cache", m_disassembly_cache.GetCount(), m_disassembly_cache.GetMemoryBytes());
+    stats.Add("registers", m_register_cache.GetCount(), m_register_cache.GetMemoryBytes());
+    long long backtraceBytes = 0;
+
+    for (dbg_mi::GDBBacktraceContainer::const_iterator it = m_backtrace.begin(); it != m_backtrace.end(); ++it)
+    {
+        backtraceBytes += sizeof(cbStackFrame)
+                          + dbg_mi::MemoryAccounting::StringBytes((*it)->GetSymbol())
+                          + dbg_mi::MemoryAccounting::StringBytes((*it)->GetFilename())
+                          + dbg_mi::MemoryAccounting::StringBytes((*it)->GetLine());
+    }
+
+    stats.Add("backtrace", m_backtrace.size(), backtraceBytes);
+    stats.Add("backtrace frame keys", m_backtrace_cache.GetCount(), m_backtrace_cache.GetMemoryBytes());
+    long long threadBytes = 0;
+
+    for (dbg_mi::GDBThreadsContainer::const_iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+    {
+        threadBytes += sizeof(cbThread) + dbg_mi::MemoryAccounting::StringBytes((*it)->GetInfo());
+    }
+
+    stats.Add("threads", m_threads.size(), threadBytes);
+}
+
+wxString Debugger_GDB_MI::GetStatisticsText()
+{
+    dbg_mi::MemoryAccounting stats;
+    CollectMemoryStatistics(stats);
+    wxString const & tooltips = wxString::Format("Tooltip cache: %lu hit(s), %lu miss(es), %d watch(es) in stop epoch %u\n",
+                                                 m_tooltip_cache.GetHits(),
+                                                 m_tooltip_cache.GetMisses(),
+                                                 int(m_tooltip_cache.GetCount()),
+                                                 m_tooltip_cache.GetEpoch());
+    wxString const & memory = wxString::Format("Memory page cache: %lu hit(s), %lu miss(es), %d page(s) of %llu bytes, %lu read(s) saved by merging, %d reader(s) pending\n",
+                                               m_memory_cache.GetHits(),
+                                               m_memory_cache.GetMisses(),
+                                               int(m_memory_cache.GetPageCount()),
+                                               static_cast<unsigned long long>(dbg_mi::MemoryPageCache::PageSize),
+                                               m_memory_cache.GetSavedReads(),
+                                               m_memory_cache.GetReaderCount());
+    wxString const & disassembly = wxString::Format("Disassembly cache: %lu hit(s), %lu miss(es), %d instruction(s)\n",
+                                                    m_disassembly_cache.GetHits(),
+                                                    m_disassembly_cache.GetMisses(),
+                                                    int(m_disassembly_cache.GetCount()));
+    wxString const & registers = wxString::Format("Registers: %lu read, %lu reused from the previous stop\n",
+                                                  m_register_cache.GetReads(),
+                                                  m_register_cache.GetReused());
+    wxString const & backtrace = wxString::Format("Backtrace: %lu frame(s) listed, %lu reused from the previous stop\n",
+                                                  m_backtrace_cache.GetRead(),
+                                                  m_backtrace_cache.GetReused());
+    return dbg_mi::StallWatchdog::GetStatistics() + "\n" + tooltips + memory + disassembly + registers + backtrace + "\n" + stats.Format();
+}
+
+void Debugger_GDB_MI::OnMenuDumpMemory(wxCommandEvent & /*event*/)
+{
+    if (!IsRunning() || !IsStopped())
+    {
+        cbMessageBox(_("The debuggee has to be paused to dump its memory."), _("Dump memory to file"), wxICON_INFORMATION);
+        return;
+    }
+
+    cbExamineMemoryDlg * dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+    wxString const start = wxGetTextFromUser(_("Start address or expression:"), _("Dump memory to file"), dialog ? dialog->GetBaseAddress() : wxString(), Manager::Get()->GetAppWindow());
+
+    if (start.IsEmpty())
+    {
+        return;
+    }
+
+    wxString const sSize = wxGetTextFromUser(_("Number of bytes (decimal, or hex with 0x):"), _("Dump memory to file"), wxEmptyString, Manager::Get()->GetAppWindow());
+    uint64_t llSize;
+
+    if (sSize.IsEmpty())
+    {
+        return;
+    }
+
+    if (!sSize.ToULongLong(&llSize, 0) || (llSize == 0))
+    {
+        cbMessageBox(wxString::Format(_("\"%s\" is not a valid number of bytes."), sSize), _("Dump memory to file"), wxICON_ERROR);
+        return;
+    }
+
+    wxFileDialog dlg(Manager::Get()->GetAppWindow(),
+                     _("Dump memory to file"),
+                     wxEmptyString,
+                     "memory_dump.bin",
+                     _("Binary files (*.bin)|*.bin|All files (*.*)|*.*"),
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    PlaceWindow(&dlg);
+
+    if (dlg.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+
+    m_actions.Add(new dbg_mi::GDBMemoryDumpAction(start, llSize, static_cast<const char *>(dlg.GetPath().utf8_str()), m_pLogger, m_memory_cache, m_memory_dumps));
+}
+
+void Debugger_GDB_MI::OnMenuOpenMemoryDump(wxCommandEvent & /*event*/)
+{
+    std::vector<dbg_mi::MemoryDump> const & dumps = m_memory_dumps.GetDumps();
+
+    if (dumps.empty())
+    {
+        cbMessageBox(_("No memory has been dumped in this Code::Blocks session."), _("Open memory dump"), wxICON_INFORMATION);
+        return;
+    }
+
+    wxArrayString choices;
+
+    for (std::vector<dbg_mi::MemoryDump>::const_iterator it = dumps.begin(); it != dumps.end(); ++it)
+    {
+        wxString choice = wxString::Format("%#018llx, %llu bytes: %s", it->address, it->size, wxString::FromUTF8(it->path.c_str()));
+        uint64_t const unreadable = dbg_mi::MemoryDumpRegistry::GetUnreadableBytes(*it);
+
+        if (unreadable > 0)
+        {
+            choice += wxString::Format(_(" (%llu bytes could not be read)"), unreadable);
+        }
+
+        choices.Add(choice);
+    }
+
+    int const index = wxGetSingleChoiceIndex(_("Show a memory dump in the Examine Memory window:"), _("Open memory dump"), choices, Manager::Get()->GetAppWindow());
+
+    if (index < 0)
+    {
+        return;
+    }
+
+    // As much of the dump as the Examine Memory window shows, read from the file and not from GDB
+    dbg_mi::MemoryDump const & dump = dumps[index];
+    cbExamineMemoryDlg * dialog = Manager::Get()->GetDebuggerManager()->GetExamineMemoryDialog();
+    uint64_t const shown = (dialog->GetBytes() > 0) ? std::min<uint64_t>(dump.size, dialog->GetBytes()) : dump.size;
+    std::vector<uint8_t> bytes;
+    std::string error;
+
+    if (!dbg_mi::MemoryDumpRegistry::Read(dump, dump.address, static_cast<size_t>(shown), bytes, error))
+    {
+        m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                 __LINE__,
+                                 wxString::Format(_("Could not open the memory dump \"%s\": %s"), wxString::FromUTF8(dump.path.c_str()), wxString::FromUTF8(error.c_str())),
+                                 dbg_mi::LogPaneLogger::LineType::Error);
+        return;
+    }
+
+    dialog->SetBaseAddress(wxString::Format("%#018llx", dump.address));
+    dbg_mi::ShowExamineMemory(dump.address, bytes);
+    // The window no longer shows what the last refresh read
+    m_examine_snapshot.Clear();
+}
+
+void Debugger_GDB_MI::OnMenuShowStatistics(wxCommandEvent & /*event*/)
+{
+    wxString const & text = GetStatisticsText();
+
+    if (m_statistics_dialog)
+    {
+        m_statistics_dialog->SetText(text);
+        m_statistics_dialog->Show();
     }
     else
     {
-        m_command_stream_dialog = new dbg_mi::GDBTextInfoWindow(Manager::Get()->GetAppWindow(), _T("Command stream"), full);
-        m_command_stream_dialog->Show();
+        m_statistics_dialog = new dbg_mi::GDBTextInfoWindow(Manager::Get()->GetAppWindow(), _T("Debugger statistics"), text);
+        m_statistics_dialog->Show();
     }
 }
 
+void Debugger_GDB_MI::OnMenuExportMITraffic(wxCommandEvent & /*event*/)
+{
+    wxString const & recording = wxString::FromUTF8(m_mi_recorder.GetPath().c_str());
+
+    if (recording.IsEmpty() || !wxFileExists(recording))
+    {
+        cbMessageBox(_("No MI traffic has been recorded in this Code::Blocks session."), _("Export MI traffic recording"), wxICON_INFORMATION);
+        return;
+    }
+
+    wxFileDialog dlg(Manager::Get()->GetAppWindow(),
+                     _("Export MI traffic recording"),
+                     wxEmptyString,
+                     "gdb_mi_traffic.txt",
+                     _("Text files (*.txt)|*.txt|JSON files (*.json)|*.json"),
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    PlaceWindow(&dlg);
+
+    if (dlg.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+
+    dbg_mi::MIRecorder::DumpFormat format = dlg.GetPath().Lower().EndsWith(".json") ? dbg_mi::MIRecorder::DumpJSON : dbg_mi::MIRecorder::DumpText;
+    std::ofstream out(static_cast<const char *>(dlg.GetPath().mb_str(wxConvFile)), std::ios::out | std::ios::binary);
+    std::string error;
+
+    if (!out || !dbg_mi::MIRecorder::Dump(m_mi_recorder.GetPath(), format, out, error))
+    {
+        m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                 __LINE__,
+                                 wxString::Format(_("Could not export MI traffic recording \"%s\" to \"%s\": %s"), recording, dlg.GetPath(), wxString::FromUTF8(error.c_str())),
+                                 dbg_mi::LogPaneLogger::LineType::Error);
+        return;
+    }
+
+    m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                             __LINE__,
+                             wxString::Format(_("MI traffic recording exported to \"%s\""), dlg.GetPath()),
+                             dbg_mi::LogPaneLogger::LineType::UserDisplay);
+}
+
+void Debugger_GDB_MI::OnMenuExportPipelineTrace(wxCommandEvent & /*event*/)
+{
+    if (dbg_mi::SpanTracer::GetCount() == 0)
+    {
+        cbMessageBox(_("No pipeline spans have been recorded yet, check that \"Trace the command pipeline\" is enabled in the debugger settings."), _("Export pipeline trace"), wxICON_INFORMATION);
+        return;
+    }
+
+    wxFileDialog dlg(Manager::Get()->GetAppWindow(),
+                     _("Export pipeline trace"),
+                     wxEmptyString,
+                     "gdb_mi_trace.json",
+                     _("Chrome trace files (*.json)|*.json"),
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    PlaceWindow(&dlg);
+
+    if (dlg.ShowModal() != wxID_OK)
+    {
+        return;
+    }
+
+    std::ofstream out(static_cast<const char *>(dlg.GetPath().mb_str(wxConvFile)), std::ios::out | std::ios::binary);
+
+    if (!out)
+    {
+        m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                 __LINE__,
+                                 wxString::Format(_("Could not create pipeline trace file \"%s\""), dlg.GetPath()),
+                                 dbg_mi::LogPaneLogger::LineType::Error);
+        return;
+    }
+
+    dbg_mi::SpanTracer::ExportChromeTrace(out);
+    m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                             __LINE__,
+                             wxString::Format(_("Pipeline trace with %lu spans exported to \"%s\", open it in chrome://tracing or ui.perfetto.dev"),
+                                              static_cast<unsigned long>(dbg_mi::SpanTracer::GetCount()),
+                                              dlg.GetPath()),
+                             dbg_mi::LogPaneLogger::LineType::UserDisplay);
+}
+
+void Debugger_GDB_MI::StartMIRecorder(wxString const & cmd)
+{
+    dbg_mi::DebuggerConfiguration & active_config = GetActiveConfigEx();
+    m_mi_recorder.Close();
+
+    if (!active_config.GetFlag(dbg_mi::DebuggerConfiguration::RecordMITraffic))
+    {
+        return;
+    }
+
+    wxFileName recording(wxFileName::GetTempDir(), wxString::Format("cb_gdbmi_traffic_%lu.bin", wxGetProcessId()));
+    uint64_t capacity = static_cast<uint64_t>(active_config.GetMIRecorderSizeMB()) * 1024 * 1024;
+    std::string error;
+
+    if (!m_mi_recorder.Open(static_cast<const char *>(recording.GetFullPath().utf8_str()), capacity, error))
+    {
+        m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                                 __LINE__,
+                                 wxString::Format(_("MI traffic recorder disabled, cannot create \"%s\": %s"), recording.GetFullPath(), wxString::FromUTF8(error.c_str())),
+                                 dbg_mi::LogPaneLogger::LineType::Warning);
+        return;
+    }
+
+    wxScopedCharBuffer const & utf8 = cmd.utf8_str();
+    m_mi_recorder.Record(dbg_mi::MIRecorder::KindNote, -1, -1, utf8.data(), utf8.length());
+    m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__,
+                             __LINE__,
+                             wxString::Format(_("Recording MI traffic to \"%s\""), recording.GetFullPath()),
+                             dbg_mi::LogPaneLogger::LineType::Debug);
+}
+
 void Debugger_GDB_MI::AddStringCommand(wxString const & command)
 {
     //-    dbg_mi::Command *cmd = new dbg_mi::Command();
@@ -405,6 +806,7 @@ struct Notifications
             if (m_simple_mode)
             {
                 m_plugin->GetGDBLogger()->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("notification event received: ==>%s<=="), parser.MakeDebugString()), dbg_mi::LogPaneLogger::LineType::Receive);
+                m_plugin->SetStoppedReason(dbg_mi::StoppedReason::Parse(result_value).GetType());
                 ParseStateInfo(result_value);
                 m_plugin->UpdateWhenStopped();
             }
@@ -420,6 +822,7 @@ struct Notifications
                     {
                         dbg_mi::StoppedReason reason = dbg_mi::StoppedReason::Parse(result_value);
                         dbg_mi::StoppedReason::Type stopType = reason.GetType();
+                        m_plugin->SetStoppedReason(stopType);
 
                         switch (stopType)
                         {
@@ -507,6 +910,7 @@ struct Notifications
 
             if (frame.ParseOutput(result_value))
             {
+                m_plugin->GetGDBCurrentFrame().SetAddress(frame.GetAddress());
                 dbg_mi::ResultValue const * thread_id_value;
                 thread_id_value = result_value.GetTupleValue(m_simple_mode ? "new-thread-id" : "thread-id");
 
@@ -578,6 +982,8 @@ struct Notifications
                                                         __LINE__,
                                                         wxString::Format(_("Found child pid: %d"), pid),
                                                         dbg_mi::LogPaneLogger::LineType::Receive_NoLine);
+                // A new process, e.g. after a restart, may load its code at other addresses
+                m_plugin->ClearDisassemblyCache();
                 dbg_mi::GDBExecutor & exec = m_plugin->GetGDBExecutor();
 
                 if (!exec.HasChildPID())
@@ -585,8 +991,10 @@ struct Notifications
                     exec.SetChildPID(pid);
                 }
             }
-            else if (notifyType.IsSameAs("library-loaded"))
+            else if (notifyType.IsSameAs("library-loaded") || notifyType.IsSameAs("library-unloaded"))
             {
+                // Another library can now be mapped where the listed code was
+                m_plugin->ClearDisassemblyCache();
                 wxString  targetName;
                 dbg_mi::Lookup(parser.GetResultValue(), "target-name", targetName);
                 m_plugin->GetGDBLogger()->LogGDBMsgType(__PRETTY_FUNCTION__,
@@ -633,16 +1041,25 @@ void Debugger_GDB_MI::UpdateOnFrameChanged(bool wait)
 
     DebuggerManager * dbg_manager = Manager::Get()->GetDebuggerManager();
 
-    if (IsWindowReallyShown(dbg_manager->GetWatchesDialog()->GetWindow()) && !m_watches.empty())
+    // The locals are var-objects too, their values are only refreshed by the update
+    if (IsWindowReallyShown(dbg_manager->GetWatchesDialog()->GetWindow()) && (!m_watches.empty() || !m_watches.GetLocals().empty()))
     {
+        std::vector<cb::shared_ptr<dbg_mi::GDBWatch>> new_watches;
+
         for (dbg_mi::GDBWatchesContainer::iterator it = m_watches.begin(); it != m_watches.end(); ++it)
         {
             if ((*it)->GetID().empty() && !(*it)->ForTooltip())
             {
-                m_actions.Add(new dbg_mi::GDBWatchCreateAction(*it, m_watches, m_pLogger, true));
+                new_watches.push_back(*it);
             }
         }
 
+        if (!new_watches.empty())
+        {
+            // One action for all of them, e.g. the watches of a project are all created at the first stop
+            m_actions.Add(new dbg_mi::GDBWatchesCreateAction(new_watches, m_watches, m_pLogger));
+        }
+
         m_actions.Add(new dbg_mi::GDBWatchesUpdateAction(m_watches, m_pLogger));
     }
 }
@@ -651,6 +1068,14 @@ void Debugger_GDB_MI::UpdateWhenStopped()
 {
     DebuggerManager * dbg_manager = Manager::Get()->GetDebuggerManager();
 
+    // New stop, the memory read at the previous one may have changed
+    m_memory_cache.Invalidate();
+
+    if (!m_memoryRanges.empty())
+    {
+        RequestUpdate(MemoryRange);
+    }
+
     if (dbg_manager->UpdateBacktrace())
     {
         RequestUpdate(Backtrace);
@@ -676,6 +1101,19 @@ void Debugger_GDB_MI::UpdateWhenStopped()
         RequestUpdate(Watches);
     }
 
+    // The cached tooltips are for the previous stop, delete their var-objects in one go while GDB is stopped
+    std::vector<cb::shared_ptr<dbg_mi::GDBWatch>> stale;
+    m_tooltip_cache.NewEpoch(stale);
+
+    for (std::vector<cb::shared_ptr<dbg_mi::GDBWatch>>::const_iterator it = stale.begin(); it != stale.end(); ++it)
+    {
+        // A tooltip still shown keeps its var-object, it is deleted when the tooltip is closed
+        if (!(*it)->GetID().empty() && (std::find(m_watches.begin(), m_watches.end(), *it) == m_watches.end()))
+        {
+            AddStringCommand("-var-delete " + (*it)->GetID());
+        }
+    }
+
     UpdateOnFrameChanged(false);
 }
 
@@ -690,11 +1128,16 @@ void Debugger_GDB_MI::RunQueue()
         {
             m_actions.Run(m_executor);
         }
+
+        // One refresh per window for everything the dispatched actions changed
+        dbg_mi::FlushWatchUpdates(m_pLogger);
     }
 }
 
 void Debugger_GDB_MI::ParseOutput(wxString const & str)
 {
+    dbg_mi::TraceSpan span("ParseOutput");
+
     if (!str.IsEmpty())
     {
         bool bProcessedOutput = false;
@@ -1023,6 +1466,9 @@ int Debugger_GDB_MI::LaunchDebugger(cbProject * project,
         m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("Working dir: %s"), working_dir), dbg_mi::LogPaneLogger::LineType::UserDisplay);
     }
 
+    StartMIRecorder(cmd);
+    dbg_mi::SpanTracer::SetEnabled(GetActiveConfigEx().GetFlag(dbg_mi::DebuggerConfiguration::TracePipeline));
+    dbg_mi::StallWatchdog::SetThresholdMs(GetActiveConfigEx().GetStallThresholdMs());
     int ret = m_executor.LaunchProcess(cmd, working_dir, id_gdb_process, this, m_pLogger);
 
     if (ret != 0)
@@ -1055,6 +1501,15 @@ int Debugger_GDB_MI::LaunchDebugger(cbProject * project,
         m_actions.Add(new dbg_mi::GDBSimpleAction("-enable-pretty-printing"));
     }
 
+    // Keep GDB from producing huge values, the rest of the budget is applied by the watch actions
+    dbg_mi::WatchBudget & budget = dbg_mi::WatchBudget::Get();
+    budget.max_children = active_config.GetWatchMaxChildren();
+    budget.max_depth = active_config.GetWatchMaxDepth();
+    budget.max_string_chars = active_config.GetWatchMaxStringChars();
+    budget.time_budget_ms = active_config.GetWatchTimeBudgetMs();
+    m_actions.Add(new dbg_mi::GDBSimpleAction(wxString::Format("-gdb-set print elements %d", budget.max_string_chars)));
+    m_actions.Add(new dbg_mi::GDBSimpleAction(wxString::Format("-gdb-set print max-depth %d", budget.max_depth)));
+
 #ifdef __WXMSW__
     if (console)
     {
@@ -1778,7 +2233,12 @@ cb::shared_ptr<cbWatch> Debugger_GDB_MI::AddMemoryRange(uint64_t llAddress, uint
     if (IsRunning())
     {
         m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format("Adding watch for: address: %#018llx  size:%lld", llAddress, llSize), dbg_mi::LogPaneLogger::LineType::Warning);
-        m_actions.Add(new dbg_mi::GDBMemoryRangeWatchCreateAction(watch, m_pLogger));
+        // Wait for the pending reads to fill the cache, an overlapping range is then served from it.
+        // Asked before the action is made, it registers itself as a reader.
+        bool const wait = m_memory_cache.HasReaders();
+        dbg_mi::Action * read_action = new dbg_mi::GDBMemoryRangeWatchCreateAction(watch, m_pLogger, m_memory_cache);
+        read_action->SetWaitPrevious(wait);
+        m_actions.Add(read_action);
     }
 
     return watch;
@@ -1791,7 +2251,8 @@ void Debugger_GDB_MI::AddTooltipWatch(const wxString & symbol, wxRect const & re
 
     if (IsRunning())
     {
-        m_actions.Add(new dbg_mi::GDBWatchCreateTooltipAction(w, m_watches, m_pLogger, rect));
+        m_actions.Add(new dbg_mi::GDBWatchCreateTooltipAction(w, m_watches, m_pLogger, rect, m_tooltip_cache,
+                                                              m_current_frame.GetThreadId(), m_current_frame.GetStackFrame()));
     }
 }
 
@@ -1805,6 +2266,13 @@ void Debugger_GDB_MI::DeleteWatch(cb::shared_ptr<cbWatch> watch)
         return;
     }
 
+    if ((*it)->ForTooltip() && m_tooltip_cache.Contains(*it))
+    {
+        // Kept for the next hover, the var-object is deleted when the debuggee stops again
+        m_watches.erase(it);
+        return;
+    }
+
     if (IsRunning())
     {
         if (IsStopped())
@@ -1854,11 +2322,27 @@ void Debugger_GDB_MI::ShowWatchProperties(cb::shared_ptr<cbWatch> watch)
     }
 
     cb::shared_ptr<dbg_mi::GDBWatch> real_watch = cb::static_pointer_cast<dbg_mi::GDBWatch>(watch);
+    wxString const oldSymbol = real_watch->GetSymbol();
+    bool const oldIsArray = real_watch->GetIsArray();
+    long const oldArrayStart = real_watch->GetRangeArrayStart();
+    long const oldArrayEnd = real_watch->GetRangeArrayEnd();
+
     dbg_mi::EditWatchDlg dlg(real_watch, nullptr);
     PlaceWindow(&dlg);
     if (dlg.ShowModal() == wxID_OK)
     {
-        DoWatches();
+        if ((real_watch->GetSymbol() == oldSymbol) && (real_watch->GetIsArray() == oldIsArray)
+            && (real_watch->GetRangeArrayStart() == oldArrayStart) && (real_watch->GetRangeArrayEnd() == oldArrayEnd))
+        {
+            // Only the format changed, values are formatted by the plugin so GDB is not involved
+            CodeBlocksEvent event(cbEVT_DEBUGGER_UPDATED);
+            event.SetInt(int(cbDebuggerPlugin::DebugWindows::Watches));
+            Manager::Get()->ProcessEvent(event);
+        }
+        else
+        {
+            DoWatches();
+        }
     }
 }
 
@@ -1869,6 +2353,50 @@ bool Debugger_GDB_MI::SetWatchValue(cb::shared_ptr<cbWatch> watch, const wxStrin
         return false;
     }
 
+    if (IsMemoryRangeWatch(watch))
+    {
+        // The new contents are entered as hex bytes, spaces between the bytes are allowed
+        cb::shared_ptr<dbg_mi::GDBMemoryRangeWatch> range_watch = cb::static_pointer_cast<dbg_mi::GDBMemoryRangeWatch>(watch);
+        std::vector<uint8_t> bytes;
+
+        switch (dbg_mi::hex_codec::DecodeInput(value.ToStdString(), range_watch->GetSize(), bytes))
+        {
+            case dbg_mi::hex_codec::InputOk:
+                break;
+
+            case dbg_mi::hex_codec::InputTooLong:
+                m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, wxString::Format(_("At most %llu bytes can be written to this memory range"), (unsigned long long)range_watch->GetSize()), dbg_mi::LogPaneLogger::LineType::Error);
+                return false;
+
+            case dbg_mi::hex_codec::InputInvalid:
+            default:
+                m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("Memory is written as hex bytes, e.g. \"01 ff 7a\""), dbg_mi::LogPaneLogger::LineType::Error);
+                return false;
+        }
+
+        std::string encoded;
+        dbg_mi::hex_codec::Encode(bytes.data(), bytes.size(), encoded);
+        // A symbol is evaluated again, e.g. &local moves with the frame, the address of the last read may be stale
+        wxString const symbol = range_watch->GetSymbol();
+        wxString const address = symbol.IsEmpty() ? wxString::Format("%#018llx", range_watch->GetAddress()) : symbol;
+        AddStringCommand(wxString::Format("-data-write-memory-bytes %s %s", address, wxString(encoded)));
+
+        if (symbol.IsEmpty())
+        {
+            m_memory_cache.Invalidate(range_watch->GetAddress(), bytes.size());
+        }
+        else
+        {
+            // Where the symbol points to now is only known to GDB
+            m_memory_cache.Invalidate();
+        }
+
+        dbg_mi::Action * read_action = new dbg_mi::GDBMemoryRangeWatchCreateAction(range_watch, m_pLogger, m_memory_cache);
+        read_action->SetWaitPrevious(true);
+        m_actions.Add(read_action);
+        return true;
+    }
+
     cb::shared_ptr<cbWatch> root_watch = cbGetRootWatch(watch);
     dbg_mi::GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), root_watch);
 
@@ -1879,6 +2407,8 @@ bool Debugger_GDB_MI::SetWatchValue(cb::shared_ptr<cbWatch> watch, const wxStrin
 
     cb::shared_ptr<dbg_mi::GDBWatch> real_watch = cb::static_pointer_cast<dbg_mi::GDBWatch>(watch);
     AddStringCommand("-var-assign " + real_watch->GetID() + " " + value);
+    // The variable can be anywhere in memory, nothing read before is known to be valid
+    m_memory_cache.Invalidate();
     //    m_actions.Add(new dbg_mi::GDBWatchSetValueAction(*it, static_cast<dbg_mi::GDBWatch*>(watch), value, m_pLogger));
     dbg_mi::Action * update_action = new dbg_mi::GDBWatchesUpdateAction(m_watches, m_pLogger);
     update_action->SetWaitPrevious(true);
@@ -1893,16 +2423,20 @@ void Debugger_GDB_MI::ExpandWatch(cb::shared_ptr<cbWatch> watch)
         return;
     }
 
-    cb::shared_ptr<cbWatch> root_watch = cbGetRootWatch(watch);
-    dbg_mi::GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), root_watch);
+    cb::shared_ptr<dbg_mi::GDBWatch> root_watch = FindVarObjectRoot(watch);
 
-    if (it != m_watches.end())
+    if (root_watch)
     {
         cb::shared_ptr<dbg_mi::GDBWatch> real_watch = cb::static_pointer_cast<dbg_mi::GDBWatch>(watch);
 
         if (!real_watch->HasBeenExpanded())
         {
-            m_actions.Add(new dbg_mi::GDBWatchExpandedAction(*it, real_watch, m_watches, m_pLogger));
+            m_actions.Add(new dbg_mi::GDBWatchExpandedAction(root_watch, real_watch, m_watches, m_pLogger));
+        }
+        else if (HasFrozenChild(real_watch))
+        {
+            // Collapsing froze the children, the steps since then did not update them
+            m_actions.Add(new dbg_mi::GDBWatchesUpdateAction(m_watches, m_pLogger, real_watch));
         }
     }
 }
@@ -1914,22 +2448,50 @@ void Debugger_GDB_MI::CollapseWatch(cb::shared_ptr<cbWatch> watch)
         return;
     }
 
-    cb::shared_ptr<cbWatch> root_watch = cbGetRootWatch(watch);
-    dbg_mi::GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), root_watch);
+    cb::shared_ptr<dbg_mi::GDBWatch> root_watch = FindVarObjectRoot(watch);
 
-    if (it != m_watches.end())
+    if (root_watch)
     {
         cb::shared_ptr<dbg_mi::GDBWatch> real_watch = cb::static_pointer_cast<dbg_mi::GDBWatch>(watch);
 
         if (real_watch->HasBeenExpanded() && real_watch->DeleteOnCollapse())
         {
-            m_actions.Add(new dbg_mi::GDBWatchCollapseAction(*it, real_watch, m_watches, m_pLogger));
+            m_actions.Add(new dbg_mi::GDBWatchCollapseAction(root_watch, real_watch, m_watches, m_pLogger));
         }
     }
 }
 
+cb::shared_ptr<dbg_mi::GDBWatch> Debugger_GDB_MI::FindVarObjectRoot(cb::shared_ptr<cbWatch> watch)
+{
+    cb::shared_ptr<cbWatch> root_watch = cbGetRootWatch(watch);
+
+    if (m_WatchLocalsandArgs && (root_watch == m_WatchLocalsandArgs))
+    {
+        // The locals pseudo watch has no var-object, each local below it is a root of its own
+        while (watch->GetParent() && (watch->GetParent() != root_watch))
+        {
+            watch = watch->GetParent();
+        }
+
+        return (watch != root_watch) ? cb::static_pointer_cast<dbg_mi::GDBWatch>(watch) : cb::shared_ptr<dbg_mi::GDBWatch>();
+    }
+
+    dbg_mi::GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), root_watch);
+    return (it != m_watches.end()) ? *it : cb::shared_ptr<dbg_mi::GDBWatch>();
+}
+
 void Debugger_GDB_MI::UpdateWatch(cb_unused cb::shared_ptr<cbWatch> watch)
 {
+    // Memory range watches are not GDBWatch, only look at watches backed by a var-object
+    cb::shared_ptr<dbg_mi::GDBWatch> real_watch = FindVarObjectRoot(watch) ? cb::static_pointer_cast<dbg_mi::GDBWatch>(watch) : cb::shared_ptr<dbg_mi::GDBWatch>();
+
+    if (real_watch && IsRunning() && IsStopped() && real_watch->IsValueTruncated() && !real_watch->GetID().empty())
+    {
+        // The value was cut to the string budget, fetch all of it on request
+        m_actions.Add(new dbg_mi::GDBWatchFetchFullValueAction(real_watch, m_watches, m_pLogger));
+        return;
+    }
+
     dbg_mi::GDBWatchesContainer::iterator it = std::find(m_watches.begin(), m_watches.end(), watch);
 
     if (it == m_watches.end())
@@ -1965,7 +2527,7 @@ void Debugger_GDB_MI::DoWatches()
         }
     }
 
-    m_actions.Add(new dbg_mi::GDBStackVariables(m_pLogger, m_WatchLocalsandArgs, bWatchFuncLocalsArgs));
+    m_actions.Add(new dbg_mi::GDBStackVariables(m_pLogger, m_WatchLocalsandArgs, bWatchFuncLocalsArgs, m_watches, m_current_frame.GetThreadId()));
 
     // Update watches now
     CodeBlocksEvent event(cbEVT_DEBUGGER_UPDATED);
@@ -1993,6 +2555,8 @@ void Debugger_GDB_MI::SendCommand(const wxString & cmd, bool debugLog)
         return;
     }
 
+    // A user command can write memory
+    m_memory_cache.Invalidate();
     DoSendCommand(cmd);
 }
 
@@ -2072,7 +2636,8 @@ void Debugger_GDB_MI::RequestUpdate(DebugWindows window)
                     dbg_mi::ActionsMap & m_actions;
                 };
                 Switcher * switcher = new Switcher(this, m_actions);
-                m_actions.Add(new dbg_mi::GDBGenerateBacktrace(switcher, m_backtrace, m_current_frame, m_pLogger));
+                m_backtrace_cache.SetThread(m_current_frame.GetThreadId());
+                m_actions.Add(new dbg_mi::GDBGenerateBacktrace(switcher, m_backtrace, m_current_frame, m_backtrace_cache, m_pLogger));
             }
             break;
 
@@ -2082,14 +2647,15 @@ void Debugger_GDB_MI::RequestUpdate(DebugWindows window)
 
         case CPURegisters:
             {
-                m_actions.Add(new dbg_mi::GDBGenerateCPUInfoRegisters(m_pLogger));
+                bool showVector = GetActiveConfigEx().GetFlag(dbg_mi::DebuggerConfiguration::ShowVectorRegisters);
+                m_actions.Add(new dbg_mi::GDBGenerateCPUInfoRegisters(m_pLogger, m_register_cache, showVector));
             }
             break;
 
         case Disassembly:
             {
                 wxString flavour = GetActiveConfigEx().GetDisassemblyFlavorCommand();
-                m_actions.Add(new dbg_mi::GDBDisassemble(flavour, m_pLogger));
+                m_actions.Add(new dbg_mi::GDBDisassemble(flavour, m_current_frame.GetSelectedFrameAddress(), m_pLogger, m_disassembly_cache));
             }
             break;
 
@@ -2101,19 +2667,23 @@ void Debugger_GDB_MI::RequestUpdate(DebugWindows window)
                 // Check for blank memory string
                 if (!memaddress.IsEmpty())
                 {
-                    m_actions.Add(new dbg_mi::GDBGenerateExamineMemory(m_pLogger));
+                    // Wait for the pending reads to fill the cache, an overlapping dump is then served from it
+                    bool const wait = m_memory_cache.HasReaders();
+                    dbg_mi::Action * read_action = new dbg_mi::GDBGenerateExamineMemory(m_pLogger, m_memory_cache, m_examine_snapshot, m_memory_dumps);
+                    read_action->SetWaitPrevious(wait);
+                    m_actions.Add(read_action);
                 }
             }
             break;
 
         case MemoryRange:
-            m_pLogger->LogGDBMsgType(__PRETTY_FUNCTION__, __LINE__, _("DebugWindows MemoryRange called!!"), dbg_mi::LogPaneLogger::LineType::Error);
-#ifdef __MINGW32__
-            if (IsDebuggerPresent())
+            if (!m_memoryRanges.empty())
             {
-                DebugBreak();
+                bool const wait = m_memory_cache.HasReaders();
+                dbg_mi::Action * read_action = new dbg_mi::GDBMemoryRangeWatchesUpdateAction(m_memoryRanges, GetActiveConfigEx().GetMemoryMergeGap(), m_pLogger, m_memory_cache);
+                read_action->SetWaitPrevious(wait);
+                m_actions.Add(read_action);
             }
-#endif // __MINGW32__
             break;
 
         case Watches:
@@ -2144,7 +2714,37 @@ void Debugger_GDB_MI::KillConsole()
 
 void Debugger_GDB_MI::OnValueTooltip(const wxString & token, const wxRect & evalRect)
 {
-    AddTooltipWatch(token, evalRect);
+    // Any tooltip evaluation still queued is for an older hover and is cancelled
+    m_tooltip_cache.NextRequest();
+    cb::shared_ptr<dbg_mi::GDBWatch> cached = m_tooltip_cache.Find(token, m_current_frame.GetThreadId(), m_current_frame.GetStackFrame());
+
+    if (cached)
+    {
+        m_timer_tooltip.Stop();
+
+        if (std::find(m_watches.begin(), m_watches.end(), cached) == m_watches.end())
+        {
+            m_watches.push_back(cached);
+        }
+
+        Manager::Get()->GetDebuggerManager()->GetInterfaceFactory()->ShowValueTooltip(cached, evalRect);
+        return;
+    }
+
+    // Only evaluate once the mouse has settled
+    m_tooltip_symbol = token;
+    m_tooltip_rect = evalRect;
+    m_timer_tooltip.Start(TooltipDebounceMs, wxTIMER_ONE_SHOT);
+}
+
+void Debugger_GDB_MI::OnTooltipTimer(wxTimerEvent & /*event*/)
+{
+    if (IsRunning() && IsStopped() && !m_tooltip_symbol.empty())
+    {
+        AddTooltipWatch(m_tooltip_symbol, m_tooltip_rect);
+    }
+
+    m_tooltip_symbol.clear();
 }
 
 bool Debugger_GDB_MI::ShowValueTooltip(int style)
@@ -20,12 +20,21 @@
 #include <cbplugin.h> // for "class cbPlugin"
 
 // GDB includes
+#include "backtrace_cache.h"
 #include "cmd_queue.h"
 #include "definitions.h"
+#include "disassembly_cache.h"
 #include "events.h"
+#include "frame.h"
 #include "gdb_executor.h"
 #include "gdb_logger.h"
+#include "memory_accounting.h"
+#include "memory_cache.h"
+#include "memory_dump.h"
+#include "mi_recorder.h"
+#include "register_cache.h"
 #include "remotedebugging.h"
+#include "tooltip_cache.h"
 
 class TextCtrlLogger;
 class Compiler;
@@ -33,6 +42,7 @@ class Compiler;
 namespace dbg_mi
 {
 
+    class CommandStreamDlg;
     class DebuggerConfiguration;
 
 } // namespace dbg_mi
@@ -186,6 +196,18 @@ class Debugger_GDB_MI : public cbDebuggerPlugin
         {
             return m_pLogger;
         }
+
+        /** The backtrace after a step or a finish reuses the callers listed at the previous stop. */
+        void SetStoppedReason(dbg_mi::StoppedReason::Type type)
+        {
+            m_backtrace_cache.SetStepped((type == dbg_mi::StoppedReason::EndSteppingRange) || (type == dbg_mi::StoppedReason::FunctionFinished));
+        }
+
+        /** The code mapped in the debuggee changed, listings of the old code must not be shown. */
+        void ClearDisassemblyCache()
+        {
+            m_disassembly_cache.Clear();
+        }
     private:
         DECLARE_EVENT_TABLE();
 
@@ -193,8 +215,17 @@ class Debugger_GDB_MI : public cbDebuggerPlugin
         void OnGDBError(wxCommandEvent & event);
         void OnGDBTerminated(wxCommandEvent & event);
         void OnTimer(wxTimerEvent & event);
+        void OnTooltipTimer(wxTimerEvent & event);
         void OnIdle(wxIdleEvent & event);
         void OnMenuInfoCommandStream(wxCommandEvent & event);
+        void OnMenuExportMITraffic(wxCommandEvent & event);
+        void OnMenuExportPipelineTrace(wxCommandEvent & event);
+        void OnMenuShowStatistics(wxCommandEvent & event);
+        void OnMenuDumpMemory(wxCommandEvent & event);
+        void OnMenuOpenMemoryDump(wxCommandEvent & event);
+        wxString GetStatisticsText();
+        void CollectMemoryStatistics(dbg_mi::MemoryAccounting & stats);
+        void StartMIRecorder(wxString const & cmd);
         int LaunchDebugger(cbProject * project, wxString const & debugger, wxString const & debuggee, wxString const & args,
                            wxString const & working_dir, int pid, bool console, StartType start_type);
         void AddStringCommand(wxString const & command);
@@ -212,12 +243,23 @@ class Debugger_GDB_MI : public cbDebuggerPlugin
         bool SaveStateToFile(cbProject* prj);
         bool LoadStateFromFile(cbProject* prj);
         void DoWatches();
+        /** The watch with the var-object the given watch belongs to, a user watch or a local. */
+        cb::shared_ptr<dbg_mi::GDBWatch> FindVarObjectRoot(cb::shared_ptr<cbWatch> watch);
 
     private:
         wxTimer m_timer_poll_debugger;
+        wxTimer m_timer_tooltip;
         cbProject * m_pProject;
 
         dbg_mi::GDBExecutor m_executor;
+        dbg_mi::MIRecorder m_mi_recorder;
+        dbg_mi::TooltipCache m_tooltip_cache;   // Before m_actions, queued tooltip actions refer to it
+        dbg_mi::MemoryPageCache m_memory_cache; // Before m_actions, queued memory read actions refer to it
+        dbg_mi::MemorySnapshot m_examine_snapshot;  // Before m_actions, the Examine Memory action refers to it
+        dbg_mi::MemoryDumpRegistry m_memory_dumps;  // Before m_actions, dump actions register their file in it
+        dbg_mi::DisassemblyCache m_disassembly_cache;   // Before m_actions, the disassembly action refers to it
+        dbg_mi::RegisterCache m_register_cache;         // Before m_actions, the registers action refers to it
+        dbg_mi::BacktraceCache m_backtrace_cache;       // Before m_actions, the backtrace action refers to it
         dbg_mi::ActionsMap  m_actions;
         dbg_mi::LogPaneLogger * m_pLogger;
         dbg_mi::GDBBreakpointsContainer m_breakpoints;
@@ -228,9 +270,14 @@ class Debugger_GDB_MI : public cbDebuggerPlugin
 
         cb::shared_ptr<dbg_mi::GDBWatch> m_WatchLocalsandArgs;
 
+        wxString m_tooltip_symbol;      // Last hovered expression, evaluated when m_timer_tooltip fires
+        wxRect m_tooltip_rect;
+
         dbg_mi::GDBMemoryRangeWatchesContainer m_memoryRanges;
         dbg_mi::GDBMapWatchesToType m_mapWatchesToType;
-        dbg_mi::GDBTextInfoWindow * m_command_stream_dialog;
+        dbg_mi::CommandStreamDlg * m_command_stream_dialog;
+        dbg_mi::GDBTextInfoWindow * m_statistics_dialog;
+        wxLongLong m_memory_snapshot_ms;
         dbg_mi::GDBCurrentFrame m_current_frame;
         int m_exit_code;
         int m_console_pid;
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <cstring>
+
+// GDB includes
+#include "register_cache.h"
+
+namespace dbg_mi
+{
+    namespace
+    {
+        bool HasNumberAfter(std::string const & name, char const * prefix)
+        {
+            size_t const length = std::strlen(prefix);
+
+            if ((name.length() <= length) || (name.compare(0, length, prefix) != 0))
+            {
+                return false;
+            }
+
+            return name.find_first_not_of("0123456789", length) == std::string::npos;
+        }
+    }
+
+    bool IsVectorRegisterName(std::string const & name)
+    {
+        // x86 SSE/AVX/AVX-512. Names like v0 are vectors on AArch64 but not on MIPS, other
+        // architectures are recognised by their union value once read
+        static char const * const Prefixes[] = {"xmm", "ymm", "zmm"};
+
+        for (size_t index = 0; index < sizeof(Prefixes) / sizeof(Prefixes[0]); ++index)
+        {
+            if (HasNumberAfter(name, Prefixes[index]))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    RegisterCache::RegisterCache() :
+        m_reads(0),
+        m_reused(0)
+    {
+    }
+
+    void RegisterCache::SetNames(std::vector<std::string> const & names)
+    {
+        m_registers.resize(names.size());
+
+        for (size_t number = 0; number < names.size(); ++number)
+        {
+            Register & reg = m_registers[number];
+            reg.name = names[number];
+            reg.value.clear();
+            reg.vector = IsVectorRegisterName(reg.name);
+            reg.valid = false;
+        }
+    }
+
+    bool RegisterCache::SetValue(size_t number, std::string const & value)
+    {
+        if ((number >= m_registers.size()) || m_registers[number].name.empty())
+        {
+            return false;
+        }
+
+        Register & reg = m_registers[number];
+        reg.value = value;
+        reg.valid = true;
+
+        // A union the names did not tell about, it is not read again unless asked for
+        if (!value.empty() && (value[0] == '{'))
+        {
+            reg.vector = true;
+        }
+
+        m_reads++;
+        return true;
+    }
+
+    void RegisterCache::Invalidate(std::vector<size_t> const & numbers)
+    {
+        for (std::vector<size_t>::const_iterator it = numbers.begin(); it != numbers.end(); ++it)
+        {
+            if (*it < m_registers.size())
+            {
+                m_registers[*it].valid = false;
+            }
+        }
+    }
+
+    void RegisterCache::Invalidate()
+    {
+        for (std::vector<Register>::iterator it = m_registers.begin(); it != m_registers.end(); ++it)
+        {
+            it->valid = false;
+        }
+    }
+
+    void RegisterCache::GetStale(bool showVector, std::vector<size_t> & numbers) const
+    {
+        numbers.clear();
+
+        for (size_t number = 0; number < m_registers.size(); ++number)
+        {
+            Register const & reg = m_registers[number];
+
+            if (!reg.name.empty() && !reg.valid && (showVector || !reg.vector))
+            {
+                numbers.push_back(number);
+            }
+        }
+    }
+
+    void RegisterCache::Clear()
+    {
+        m_registers.clear();
+    }
+
+    size_t RegisterCache::GetMemoryBytes() const
+    {
+        size_t bytes = m_registers.capacity() * sizeof(Register);
+
+        for (std::vector<Register>::const_iterator it = m_registers.begin(); it != m_registers.end(); ++it)
+        {
+            bytes += it->name.capacity() + it->value.capacity();
+        }
+
+        return bytes;
+    }
+
+} // namespace dbg_mi
@@ -0,0 +1,115 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_REGISTER_CACHE_H_
+#define _DEBUGGER_GDB_MI_REGISTER_CACHE_H_
+
+// System and library includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace dbg_mi
+{
+    /** CPU registers of the debug session, indexed by GDB's register number.
+     *
+     * The names are asked to GDB once, the architecture does not change during a session. At a
+     * stop "-data-list-changed-registers" tells which values are stale, only those are read
+     * again. Vector registers (xmm, ymm, ...) are reported by GDB as big unions, they are only
+     * read when the user wants to see them.
+     *
+     * Does not depend on wxWidgets.
+     */
+    class RegisterCache
+    {
+        public:
+            RegisterCache();
+
+            /** Names from "-data-list-register-names", an empty name is a number without register. */
+            void SetNames(std::vector<std::string> const & names);
+
+            bool HasNames() const
+            {
+                return !m_registers.empty();
+            }
+
+            size_t GetCount() const
+            {
+                return m_registers.size();
+            }
+
+            std::string const & GetName(size_t number) const
+            {
+                return m_registers[number].name;
+            }
+
+            bool IsVector(size_t number) const
+            {
+                return m_registers[number].vector;
+            }
+
+            bool HasValue(size_t number) const
+            {
+                return m_registers[number].valid;
+            }
+
+            std::string const & GetValue(size_t number) const
+            {
+                return m_registers[number].value;
+            }
+
+            /** Store a value read from GDB. Returns false if there is no register with the number. */
+            bool SetValue(size_t number, std::string const & value);
+
+            /** The registers changed since the values were read. */
+            void Invalidate(std::vector<size_t> const & numbers);
+            /** Every value is stale, e.g. GDB could not tell which ones changed. */
+            void Invalidate();
+
+            /** Numbers of the registers shown without a valid value, vector registers only if showVector. */
+            void GetStale(bool showVector, std::vector<size_t> & numbers) const;
+
+            /** New debug session, the target may be another architecture. */
+            void Clear();
+
+            size_t GetMemoryBytes() const;
+
+            /** Register values read from GDB and values still valid from the previous stop. */
+            unsigned long GetReads() const
+            {
+                return m_reads;
+            }
+
+            unsigned long GetReused() const
+            {
+                return m_reused;
+            }
+
+            void CountReused(unsigned long count)
+            {
+                m_reused += count;
+            }
+
+        private:
+            struct Register
+            {
+                std::string name;
+                std::string value;
+                bool vector;
+                bool valid;
+            };
+
+            std::vector<Register> m_registers;
+            unsigned long m_reads;
+            unsigned long m_reused;
+    };
+
+    /** True for the registers GDB shows as unions of vectors, by their name. */
+    bool IsVectorRegisterName(std::string const & name);
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_REGISTER_CACHE_H_
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#ifdef __GNUC__
+    #include <cxxabi.h>
+#endif
+
+// GDB includes
+#include "span_tracer.h"
+
+namespace dbg_mi
+{
+    bool SpanTracer::s_enabled = true;
+    std::vector<SpanTracer::Span> SpanTracer::s_spans;
+    size_t SpanTracer::s_next = 0;
+    size_t SpanTracer::s_count = 0;
+
+    std::string DemangleTypeName(char const * type_name)
+    {
+        std::string result(type_name ? type_name : "");
+#ifdef __GNUC__
+        int status = 0;
+        char * demangled = abi::__cxa_demangle(type_name, nullptr, nullptr, &status);
+
+        if (demangled)
+        {
+            if (status == 0)
+            {
+                result = demangled;
+            }
+
+            std::free(demangled);
+        }
+#endif
+        return result;
+    }
+
+    void SpanTracer::SetEnabled(bool enabled)
+    {
+        s_enabled = enabled;
+    }
+
+    void SpanTracer::Add(Span const & span)
+    {
+        if (s_spans.empty())
+        {
+            s_spans.resize(DefaultCapacity);
+        }
+
+        s_spans[s_next] = span;
+        s_next = (s_next + 1) % s_spans.size();
+
+        if (s_count < s_spans.size())
+        {
+            ++s_count;
+        }
+    }
+
+    void SpanTracer::Clear()
+    {
+        s_next = 0;
+        s_count = 0;
+    }
+
+    size_t SpanTracer::GetCount()
+    {
+        return s_count;
+    }
+
+    void SpanTracer::ExportChromeTrace(std::ostream & out)
+    {
+        size_t const oldest = (s_count == s_spans.size()) ? s_next : 0;
+        uint64_t origin = UINT64_MAX;
+        char buffer[64];
+
+        // Spans are stored when they end, so a parent is stored after its children
+        for (size_t ii = 0; ii < s_count; ++ii)
+        {
+            if (s_spans[ii].start_ns < origin)
+            {
+                origin = s_spans[ii].start_ns;
+            }
+        }
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        for (size_t ii = 0; ii < s_count; ++ii)
+        {
+            Span const & span = s_spans[(oldest + ii) % s_spans.size()];
+            std::string name;
+
+            if (span.type_name)
+            {
+                name = DemangleTypeName(span.type_name) + "::" + span.name;
+            }
+            else
+            {
+                name = span.name;
+            }
+
+            out << (ii ? ",\n" : "") << "{\"name\":\"";
+
+            for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+            {
+                if ((*it == '"') || (*it == '\\'))
+                {
+                    out << '\\';
+                }
+
+                out << *it;
+            }
+
+            // Chrome trace timestamps are in micro seconds
+            std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(span.start_ns - origin) / 1000.0);
+            out << "\",\"cat\":\"gdbmi\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << buffer;
+            std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(span.duration_ns) / 1000.0);
+            out << ",\"dur\":" << buffer;
+
+            if (span.action >= 0)
+            {
+                out << ",\"args\":{\"action\":" << span.action << ",\"command\":" << span.command << "}";
+            }
+
+            out << "}";
+        }
+
+        out << "\n]}\n";
+    }
+
+} // namespace dbg_mi
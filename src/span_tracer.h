@@ -0,0 +1,113 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_SPAN_TRACER_H_
+#define _DEBUGGER_GDB_MI_SPAN_TRACER_H_
+
+// System and library includes
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dbg_mi
+{
+    /** Collects timed spans of the debugger pipeline (GDB output -> parse -> dispatch -> UI update).
+     *
+     * Spans are kept in a preallocated ring, recording one is two clock reads and a copy of a few
+     * integers. Names must be string literals or other strings with static storage (e.g. typeid names),
+     * they are only formatted when the trace is exported as Chrome trace-event JSON, which can be
+     * opened in chrome://tracing or https://ui.perfetto.dev.
+     * All spans are recorded from the UI thread, the tracer is not thread safe.
+     */
+    class SpanTracer
+    {
+        public:
+            struct Span
+            {
+                char const * name;
+                char const * type_name;     ///< mangled typeid name, or nullptr
+                uint64_t start_ns;
+                uint64_t duration_ns;
+                int32_t action;
+                int32_t command;
+            };
+
+            static const size_t DefaultCapacity = 65536;
+
+        public:
+            static uint64_t Now()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            static void SetEnabled(bool enabled);
+            static bool IsEnabled()
+            {
+                return s_enabled;
+            }
+
+            static void Add(Span const & span);
+            static void Clear();
+            static size_t GetCount();
+
+            static void ExportChromeTrace(std::ostream & out);
+
+        private:
+            static bool s_enabled;
+            static std::vector<Span> s_spans;
+            static size_t s_next;
+            static size_t s_count;
+    };
+
+    /** Scoped span, recorded into SpanTracer when it goes out of scope. */
+    class TraceSpan
+    {
+        public:
+            explicit TraceSpan(char const * name, int32_t action = -1, int32_t command = -1, char const * type_name = nullptr) :
+                m_active(SpanTracer::IsEnabled())
+            {
+                if (m_active)
+                {
+                    m_span.name = name;
+                    m_span.type_name = type_name;
+                    m_span.action = action;
+                    m_span.command = command;
+                    m_span.start_ns = SpanTracer::Now();
+                }
+            }
+
+            ~TraceSpan()
+            {
+                if (m_active)
+                {
+                    m_span.duration_ns = SpanTracer::Now() - m_span.start_ns;
+                    SpanTracer::Add(m_span);
+                }
+            }
+
+            void SetCommand(int32_t action, int32_t command)
+            {
+                m_span.action = action;
+                m_span.command = command;
+            }
+
+        private:
+            TraceSpan(TraceSpan const &);
+            TraceSpan & operator=(TraceSpan const &);
+
+        private:
+            SpanTracer::Span m_span;
+            bool m_active;
+    };
+
+    /** Readable name of a typeid() name, demangled when the compiler supports it. */
+    std::string DemangleTypeName(char const * type_name);
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_SPAN_TRACER_H_
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// GDB includes
+#include "cmd_queue.h"
+#include "gdb_logger.h"
+#include "stall_watchdog.h"
+
+namespace dbg_mi
+{
+    uint64_t StallWatchdog::s_threshold_ns = StallWatchdog::DefaultThresholdMs * 1000000ULL;
+    StallWatchdog::Counters StallWatchdog::s_counters[StallWatchdog::EntryPointCount] = {};
+    StallWatchdog::Attribution StallWatchdog::s_slowest;
+    int StallWatchdog::s_depth = 0;
+
+    char const * StallWatchdog::GetEntryName(EntryPoint entry)
+    {
+        switch (entry)
+        {
+            case EntryOnGDBOutput:
+                return "OnGDBOutput";
+
+            case EntryOnTimer:
+                return "OnTimer/RunQueue";
+
+            case EntryOnIdle:
+                return "OnIdle";
+
+            case EntryOnCommandOutput:
+                return "OnCommandOutput";
+
+            default:
+                return "unknown";
+        }
+    }
+
+    void StallWatchdog::SetThresholdMs(long threshold)
+    {
+        s_threshold_ns = static_cast<uint64_t>(threshold > 0 ? threshold : DefaultThresholdMs) * 1000000ULL;
+    }
+
+    long StallWatchdog::GetThresholdMs()
+    {
+        return static_cast<long>(s_threshold_ns / 1000000ULL);
+    }
+
+    void StallWatchdog::NoteCommandOutput(Attribution const & attribution)
+    {
+        if (attribution.elapsed_ns >= s_slowest.elapsed_ns)
+        {
+            s_slowest = attribution;
+        }
+    }
+
+    void StallWatchdog::Report(EntryPoint entry, uint64_t elapsed_ns, Attribution const & attribution, CommandExecutor const * executor)
+    {
+        Counters & counters = s_counters[entry];
+        ++counters.calls;
+
+        if (elapsed_ns > counters.max_ns)
+        {
+            counters.max_ns = elapsed_ns;
+        }
+
+        if (elapsed_ns < s_threshold_ns)
+        {
+            return;
+        }
+
+        ++counters.stalls;
+        counters.stalled_ns += elapsed_ns;
+
+        wxString culprit;
+
+        if (attribution.action >= 0)
+        {
+            wxString verb = "?";
+            wxString command;
+
+            if (executor && executor->GetCommandHistory().Find(attribution.action, attribution.command, command))
+            {
+                verb = command.BeforeFirst(' ');
+            }
+
+            culprit = wxString::Format(" in %s, id %s, MI verb %s, reply %lu bytes (%.1f ms)",
+                                       wxString(DemangleTypeName(attribution.type_name)),
+                                       CommandID(attribution.action, attribution.command).ToString(),
+                                       verb,
+                                       static_cast<unsigned long>(attribution.reply_size),
+                                       attribution.elapsed_ns / 1e6);
+        }
+        else if (attribution.reply_size > 0)
+        {
+            culprit = wxString::Format(", %lu bytes of GDB output", static_cast<unsigned long>(attribution.reply_size));
+        }
+
+        LogPaneLogger::LogGDBMsgType(__PRETTY_FUNCTION__,
+                                     __LINE__,
+                                     wxString::Format("UI thread stalled for %.1f ms in %s%s", elapsed_ns / 1e6, GetEntryName(entry), culprit),
+                                     LogPaneLogger::LineType::Warning);
+    }
+
+    wxString StallWatchdog::GetStatistics()
+    {
+        wxString text = wxString::Format("UI thread stalls (threshold %ld ms)\n", GetThresholdMs());
+        text += wxString::Format("  %-20s %12s %8s %10s %12s\n", "entry point", "calls", "stalls", "max ms", "stalled ms");
+
+        for (int entry = 0; entry < EntryPointCount; ++entry)
+        {
+            Counters const & counters = s_counters[entry];
+            text += wxString::Format("  %-20s %12llu %8llu %10.1f %12.1f\n",
+                                     GetEntryName(static_cast<EntryPoint>(entry)),
+                                     counters.calls,
+                                     counters.stalls,
+                                     counters.max_ns / 1e6,
+                                     counters.stalled_ns / 1e6);
+        }
+
+        return text;
+    }
+
+    void StallWatchdog::Reset()
+    {
+        for (int entry = 0; entry < EntryPointCount; ++entry)
+        {
+            s_counters[entry] = Counters();
+        }
+    }
+
+} // namespace dbg_mi
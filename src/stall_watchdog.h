@@ -0,0 +1,163 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_STALL_WATCHDOG_H_
+#define _DEBUGGER_GDB_MI_STALL_WATCHDOG_H_
+
+// System and library includes
+#include <cstdint>
+#include <wx/string.h>
+
+// GDB includes
+#include "span_tracer.h"
+
+namespace dbg_mi
+{
+    class CommandExecutor;
+
+    /** Measures how long the UI thread entry points of the plugin hold the event loop.
+     *
+     * A handler running longer than the threshold is logged as a warning, attributed to the action
+     * type, CommandID, MI verb and reply size of the slowest command output handled inside it, and
+     * counted per entry point for the statistics view.
+     */
+    class StallWatchdog
+    {
+        public:
+            enum EntryPoint
+            {
+                EntryOnGDBOutput = 0,
+                EntryOnTimer,
+                EntryOnIdle,
+                EntryOnCommandOutput,
+                EntryPointCount
+            };
+
+            struct Attribution
+            {
+                Attribution() :
+                    type_name(nullptr),
+                    action(-1),
+                    command(-1),
+                    reply_size(0),
+                    elapsed_ns(0)
+                {
+                }
+
+                char const * type_name;     ///< mangled typeid name of the action, or nullptr
+                int32_t action;
+                int32_t command;
+                size_t reply_size;
+                uint64_t elapsed_ns;
+            };
+
+            static const long DefaultThresholdMs = 50;
+
+        public:
+            static void SetThresholdMs(long threshold);
+            static long GetThresholdMs();
+
+            /** Called by StallScope when an entry point returns. */
+            static void Report(EntryPoint entry, uint64_t elapsed_ns, Attribution const & attribution, CommandExecutor const * executor);
+
+            /** Remember the slowest command output handled by the entry point currently running. */
+            static void NoteCommandOutput(Attribution const & attribution);
+
+            /** The slowest command output noted since the outermost entry point started. */
+            static Attribution const & GetSlowest()
+            {
+                return s_slowest;
+            }
+
+            static unsigned long long GetCalls(EntryPoint entry)
+            {
+                return s_counters[entry].calls;
+            }
+
+            static unsigned long long GetStalls(EntryPoint entry)
+            {
+                return s_counters[entry].stalls;
+            }
+
+            static wxString GetStatistics();
+            static void Reset();
+
+        private:
+            struct Counters
+            {
+                unsigned long long calls;
+                unsigned long long stalls;
+                uint64_t max_ns;
+                uint64_t stalled_ns;
+            };
+
+            static char const * GetEntryName(EntryPoint entry);
+
+            static uint64_t s_threshold_ns;
+            static Counters s_counters[EntryPointCount];
+            static Attribution s_slowest;
+            static int s_depth;
+
+            friend class StallScope;
+    };
+
+    /** Scoped measurement of one UI thread entry point. */
+    class StallScope
+    {
+        public:
+            StallScope(StallWatchdog::EntryPoint entry, CommandExecutor const * executor) :
+                m_entry(entry),
+                m_executor(executor),
+                m_start(SpanTracer::Now())
+            {
+                if (StallWatchdog::s_depth++ == 0)
+                {
+                    StallWatchdog::s_slowest = StallWatchdog::Attribution();
+                }
+            }
+
+            ~StallScope()
+            {
+                uint64_t const elapsed = SpanTracer::Now() - m_start;
+                m_attribution.elapsed_ns = elapsed;
+
+                if (m_attribution.action >= 0)
+                {
+                    StallWatchdog::NoteCommandOutput(m_attribution);
+                }
+
+                bool const own = (m_attribution.action >= 0) || (StallWatchdog::s_slowest.action < 0);
+                StallWatchdog::Report(m_entry, elapsed, own ? m_attribution : StallWatchdog::s_slowest, m_executor);
+                --StallWatchdog::s_depth;
+            }
+
+            void SetReplySize(size_t reply_size)
+            {
+                m_attribution.reply_size = reply_size;
+            }
+
+            void Attribute(char const * type_name, int32_t action, int32_t command, size_t reply_size)
+            {
+                m_attribution.type_name = type_name;
+                m_attribution.action = action;
+                m_attribution.command = command;
+                m_attribution.reply_size = reply_size;
+            }
+
+        private:
+            StallScope(StallScope const &);
+            StallScope & operator=(StallScope const &);
+
+        private:
+            StallWatchdog::EntryPoint m_entry;
+            CommandExecutor const * m_executor;
+            StallWatchdog::Attribution m_attribution;
+            uint64_t m_start;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_STALL_WATCHDOG_H_
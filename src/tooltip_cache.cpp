@@ -0,0 +1,89 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// GDB includes
+#include "tooltip_cache.h"
+
+namespace dbg_mi
+{
+    TooltipCache::TooltipCache() :
+        m_epoch(0),
+        m_latest_request(0),
+        m_hits(0),
+        m_misses(0)
+    {
+    }
+
+    cb::shared_ptr<GDBWatch> TooltipCache::Find(wxString const & expression, int thread, int frame)
+    {
+        // Only a handful of expressions are hovered between two stops, a linear search is enough
+        for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if ((it->epoch == m_epoch) && (it->frame == frame) && (it->thread == thread) && (it->expression == expression))
+            {
+                m_hits++;
+                return it->watch;
+            }
+        }
+
+        m_misses++;
+        return cb::shared_ptr<GDBWatch>();
+    }
+
+    void TooltipCache::Add(wxString const & expression, int thread, int frame, unsigned epoch, cb::shared_ptr<GDBWatch> const & watch)
+    {
+        if (epoch != m_epoch)
+        {
+            // Evaluated for a stop that is already gone, only the var-object has to be cleaned up
+            m_stale.push_back(watch);
+            return;
+        }
+
+        Entry entry;
+        entry.expression = expression;
+        entry.thread = thread;
+        entry.frame = frame;
+        entry.epoch = epoch;
+        entry.watch = watch;
+        m_entries.push_back(entry);
+    }
+
+    bool TooltipCache::Contains(cb::shared_ptr<GDBWatch> const & watch) const
+    {
+        for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->watch == watch)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void TooltipCache::NewEpoch(std::vector<cb::shared_ptr<GDBWatch>> & stale)
+    {
+        m_epoch++;
+        stale.insert(stale.end(), m_stale.begin(), m_stale.end());
+        m_stale.clear();
+
+        for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            stale.push_back(it->watch);
+        }
+
+        m_entries.clear();
+    }
+
+    void TooltipCache::Clear()
+    {
+        m_entries.clear();
+        m_stale.clear();
+        m_epoch++;
+        m_latest_request++;
+    }
+
+} // namespace dbg_mi
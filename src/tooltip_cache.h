@@ -0,0 +1,92 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_TOOLTIP_CACHE_H_
+#define _DEBUGGER_GDB_MI_TOOLTIP_CACHE_H_
+
+// System and library includes
+#include <vector>
+#include <wx/string.h>
+
+// GDB includes
+#include "definitions.h"
+
+namespace dbg_mi
+{
+    /** Tooltip watches evaluated while the debuggee is stopped.
+     *
+     * A tooltip watch is kept per (expression, thread, frame) for the current stop epoch, the epoch
+     * changes every time the debuggee stops. Hovering the same expression again shows the cached
+     * watch without sending anything to GDB. The var-objects of the previous epoch are handed back
+     * by NewEpoch() so they can be deleted together while GDB is stopped.
+     *
+     * Hover requests are numbered, only the latest one is allowed to run, the older ones are cancelled.
+     */
+    class TooltipCache
+    {
+        public:
+            TooltipCache();
+
+            cb::shared_ptr<GDBWatch> Find(wxString const & expression, int thread, int frame);
+            void Add(wxString const & expression, int thread, int frame, unsigned epoch, cb::shared_ptr<GDBWatch> const & watch);
+            bool Contains(cb::shared_ptr<GDBWatch> const & watch) const;
+
+            /** Start a new stop epoch, the watches of the previous epochs are moved to stale. */
+            void NewEpoch(std::vector<cb::shared_ptr<GDBWatch>> & stale);
+            void Clear();
+
+            unsigned GetEpoch() const
+            {
+                return m_epoch;
+            }
+
+            /** Number a new hover request, this supersedes all the previous ones. */
+            int NextRequest()
+            {
+                return ++m_latest_request;
+            }
+
+            bool IsLatestRequest(int request) const
+            {
+                return request == m_latest_request;
+            }
+
+            size_t GetCount() const
+            {
+                return m_entries.size();
+            }
+
+            unsigned long GetHits() const
+            {
+                return m_hits;
+            }
+
+            unsigned long GetMisses() const
+            {
+                return m_misses;
+            }
+
+        private:
+            struct Entry
+            {
+                wxString expression;
+                int thread;
+                int frame;
+                unsigned epoch;
+                cb::shared_ptr<GDBWatch> watch;
+            };
+
+            std::vector<Entry> m_entries;
+            std::vector<cb::shared_ptr<GDBWatch>> m_stale;
+            unsigned m_epoch;
+            int m_latest_request;
+            unsigned long m_hits;
+            unsigned long m_misses;
+    };
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_TOOLTIP_CACHE_H_
@@ -0,0 +1,447 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// System and library includes
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// GDB includes
+#include "value_format.h"
+
+namespace dbg_mi
+{
+    namespace value_format
+    {
+        namespace
+        {
+            struct NamedType
+            {
+                char const * name;
+                int size;
+                bool is_signed;
+            };
+
+            // Fixed width typedefs GDB reports without resolving them
+            const NamedType NamedTypes[] =
+            {
+                {"int8_t", 1, true},
+                {"uint8_t", 1, false},
+                {"int16_t", 2, true},
+                {"uint16_t", 2, false},
+                {"int32_t", 4, true},
+                {"uint32_t", 4, false},
+                {"int64_t", 8, true},
+                {"uint64_t", 8, false},
+                {"size_t", sizeof(size_t), false},
+                {"ssize_t", sizeof(size_t), true},
+                {"ptrdiff_t", sizeof(ptrdiff_t), true},
+                {"intptr_t", sizeof(intptr_t), true},
+                {"uintptr_t", sizeof(uintptr_t), false},
+                {"wchar_t", sizeof(wchar_t), true},
+                {"char16_t", 2, false},
+                {"char32_t", 4, false},
+                {"char8_t", 1, false},
+                {"bool", 1, false},
+                {"_Bool", 1, false}
+            };
+
+            std::string Trim(std::string const & s)
+            {
+                size_t const first = s.find_first_not_of(" \t");
+
+                if (first == std::string::npos)
+                {
+                    return std::string();
+                }
+
+                return s.substr(first, s.find_last_not_of(" \t") - first + 1);
+            }
+
+            int HexDigit(char c)
+            {
+                if (c >= '0' && c <= '9')
+                {
+                    return c - '0';
+                }
+
+                if (c >= 'a' && c <= 'f')
+                {
+                    return c - 'a' + 10;
+                }
+
+                if (c >= 'A' && c <= 'F')
+                {
+                    return c - 'A' + 10;
+                }
+
+                return -1;
+            }
+
+            /** Parse an integer in GDB natural format: "-12", "0x1f", "97 'a'", "true". */
+            bool ParseInteger(std::string const & raw, uint64_t & bits)
+            {
+                if (raw == "true" || raw == "false")
+                {
+                    bits = (raw == "true") ? 1 : 0;
+                    return true;
+                }
+
+                size_t pos = 0;
+                bool const negative = !raw.empty() && raw[0] == '-';
+
+                if (negative)
+                {
+                    pos++;
+                }
+
+                uint64_t value = 0;
+                size_t digits = 0;
+
+                if (raw.compare(pos, 2, "0x") == 0)
+                {
+                    for (pos += 2; pos < raw.length() && HexDigit(raw[pos]) >= 0; ++pos, ++digits)
+                    {
+                        value = (value << 4) | HexDigit(raw[pos]);
+                    }
+                }
+                else
+                {
+                    for (; pos < raw.length() && raw[pos] >= '0' && raw[pos] <= '9'; ++pos, ++digits)
+                    {
+                        value = value * 10 + (raw[pos] - '0');
+                    }
+                }
+
+                if (digits == 0)
+                {
+                    return false;
+                }
+
+                // Characters are reported as "97 'a'", anything else after the number is not a scalar
+                if (pos != raw.length() && raw.compare(pos, 2, " '") != 0)
+                {
+                    return false;
+                }
+
+                bits = negative ? (~value + 1) : value;
+                return true;
+            }
+
+            bool ParseFloat(std::string const & raw, double & value)
+            {
+                if (raw.empty())
+                {
+                    return false;
+                }
+
+                char * end = nullptr;
+                value = std::strtod(raw.c_str(), &end);
+                return end && *end == '\0';
+            }
+
+            uint64_t Mask(uint64_t bits, int size)
+            {
+                return (size > 0 && size < 8) ? (bits & ((uint64_t(1) << (size * 8)) - 1)) : bits;
+            }
+
+            int64_t SignExtend(uint64_t bits, int size)
+            {
+                if (size > 0 && size < 8)
+                {
+                    uint64_t const sign = uint64_t(1) << (size * 8 - 1);
+                    bits = Mask(bits, size);
+                    return static_cast<int64_t>((bits ^ sign) - sign);
+                }
+
+                return static_cast<int64_t>(bits);
+            }
+
+            std::string ToHex(uint64_t bits)
+            {
+                char buffer[24];
+                std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(bits));
+                return buffer;
+            }
+
+            std::string ToBinary(uint64_t bits)
+            {
+                if (bits == 0)
+                {
+                    return "0";
+                }
+
+                std::string result;
+
+                for (; bits; bits >>= 1)
+                {
+                    result.insert(result.begin(), (bits & 1) ? '1' : '0');
+                }
+
+                return result;
+            }
+
+            /** Same rendering as GDB's /c: "97 'a'", "10 '\n'", "-1 '\377'". */
+            std::string ToChar(uint64_t bits)
+            {
+                int const value = static_cast<int>(SignExtend(bits, 1));
+                unsigned char const c = static_cast<unsigned char>(bits & 0xFF);
+                char buffer[16];
+
+                char const * escapes = "\a" "a" "\b" "b" "\f" "f" "\n" "n" "\r" "r" "\t" "t" "\v" "v" "'" "'" "\\" "\\";
+                char const * escape = (c != 0) ? std::strchr(escapes, c) : nullptr;
+
+                // Escapes are stored as pairs, only the first character of a pair is a match
+                if (escape && ((escape - escapes) % 2) == 0)
+                {
+                    std::snprintf(buffer, sizeof(buffer), "%d '\\%c'", value, escape[1]);
+                }
+                else if (c >= 0x20 && c < 0x7F)
+                {
+                    std::snprintf(buffer, sizeof(buffer), "%d '%c'", value, c);
+                }
+                else
+                {
+                    std::snprintf(buffer, sizeof(buffer), "%d '\\%03o'", value, c);
+                }
+
+                return buffer;
+            }
+
+            /** Reinterpret the bits as a float of the same size, like GDB's /f. */
+            bool ToFloat(uint64_t bits, int size, std::string & out)
+            {
+                char buffer[40];
+
+                if (size == 4)
+                {
+                    uint32_t const bits32 = static_cast<uint32_t>(bits);
+                    float f;
+                    std::memcpy(&f, &bits32, sizeof(f));
+                    std::snprintf(buffer, sizeof(buffer), "%.9g", f);
+                }
+                else if (size == 8)
+                {
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    std::snprintf(buffer, sizeof(buffer), "%.17g", d);
+                }
+                else
+                {
+                    return false;
+                }
+
+                out = buffer;
+                return true;
+            }
+        }
+
+        bool ClassifyType(std::string const & type, TypeInfo & info)
+        {
+            std::istringstream words(type);
+            std::string word;
+            int longs = 0;
+            bool has_unsigned = false, has_signed = false, has_char = false, has_short = false;
+            bool has_int = false, has_float = false, has_double = false;
+            std::string named;
+
+            while (words >> word)
+            {
+                if (word == "const" || word == "volatile")
+                {
+                    continue;
+                }
+                else if (word == "unsigned")
+                {
+                    has_unsigned = true;
+                }
+                else if (word == "signed")
+                {
+                    has_signed = true;
+                }
+                else if (word == "char")
+                {
+                    has_char = true;
+                }
+                else if (word == "short")
+                {
+                    has_short = true;
+                }
+                else if (word == "int")
+                {
+                    has_int = true;
+                }
+                else if (word == "long")
+                {
+                    longs++;
+                }
+                else if (word == "float")
+                {
+                    has_float = true;
+                }
+                else if (word == "double")
+                {
+                    has_double = true;
+                }
+                else if (named.empty())
+                {
+                    // Pointers, references, arrays and qualified names end up here as well
+                    named = word;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            if (!named.empty())
+            {
+                if (has_unsigned || has_signed || has_char || has_short || has_int || longs || has_float || has_double)
+                {
+                    return false;
+                }
+
+                for (size_t i = 0; i < sizeof(NamedTypes) / sizeof(NamedTypes[0]); ++i)
+                {
+                    if (named == NamedTypes[i].name)
+                    {
+                        info.size = NamedTypes[i].size;
+                        info.is_signed = NamedTypes[i].is_signed;
+                        info.is_float = false;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            info.is_float = has_float || has_double;
+
+            if (info.is_float)
+            {
+                info.size = has_float ? 4 : ((longs > 0) ? 16 : 8);
+                info.is_signed = true;
+                return !(has_unsigned || has_signed || has_char || has_short || has_int);
+            }
+
+            // The sizes are the ones of the host, the debuggee is normally built for the same data model
+            if (has_char)
+            {
+                info.size = 1;
+            }
+            else if (has_short)
+            {
+                info.size = 2;
+            }
+            else if (longs == 1)
+            {
+                info.size = sizeof(long);
+            }
+            else if (longs >= 2)
+            {
+                info.size = 8;
+            }
+            else if (has_int || has_unsigned || has_signed)
+            {
+                info.size = 4;
+            }
+            else
+            {
+                return false;
+            }
+
+            info.is_signed = !has_unsigned;
+            return true;
+        }
+
+        bool FormatValue(std::string const & raw, TypeInfo const & type, Format format, std::string & out)
+        {
+            if (format == Natural)
+            {
+                return false;
+            }
+
+            std::string const value = Trim(raw);
+            uint64_t bits;
+
+            if (type.is_float)
+            {
+                double d;
+
+                if (!ParseFloat(value, d))
+                {
+                    return false;
+                }
+
+                if (format == Float || format == Decimal)
+                {
+                    return false;
+                }
+
+                // Integer formats show the representation of the value
+                if (type.size == 4)
+                {
+                    float const f = static_cast<float>(d);
+                    uint32_t bits32;
+                    std::memcpy(&bits32, &f, sizeof(bits32));
+                    bits = bits32;
+                }
+                else if (type.size == 8)
+                {
+                    std::memcpy(&bits, &d, sizeof(bits));
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else if (!ParseInteger(value, bits))
+            {
+                return false;
+            }
+
+            switch (format)
+            {
+                case Decimal:
+                    out = std::to_string(SignExtend(bits, type.size));
+                    return true;
+
+                case Unsigned:
+                    out = std::to_string(Mask(bits, type.size));
+                    return true;
+
+                case Hex:
+                    out = ToHex(Mask(bits, type.size));
+                    return true;
+
+                case Binary:
+                    out = ToBinary(Mask(bits, type.size));
+                    return true;
+
+                case Char:
+                    out = ToChar(bits);
+                    return true;
+
+                case Float:
+                    if (ToFloat(Mask(bits, type.size), type.size, out))
+                    {
+                        return true;
+                    }
+
+                    out = type.is_signed ? std::to_string(SignExtend(bits, type.size)) : std::to_string(Mask(bits, type.size));
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
+
+    } // namespace value_format
+
+} // namespace dbg_mi
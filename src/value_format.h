@@ -0,0 +1,62 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+#ifndef _DEBUGGER_GDB_MI_VALUE_FORMAT_H_
+#define _DEBUGGER_GDB_MI_VALUE_FORMAT_H_
+
+// System and library includes
+#include <string>
+
+namespace dbg_mi
+{
+    /** Client side formatting of scalar watch values.
+     *
+     * GDB reports every value in its natural format once, the watch keeps that raw text and the
+     * display format (hex, binary, ...) is applied here when the value is shown. Changing the
+     * format of a watch, or of an array with thousands of elements, does not send anything to GDB.
+     *
+     * Does not depend on wxWidgets.
+     */
+    namespace value_format
+    {
+        /** Same order as GDBWatch::WatchFormat. */
+        enum Format
+        {
+            Natural = 0,
+            Decimal,
+            Unsigned,
+            Hex,
+            Binary,
+            Char,
+            Float
+        };
+
+        struct TypeInfo
+        {
+            int size;           ///< size in bytes
+            bool is_signed;
+            bool is_float;
+        };
+
+        /** Size and signedness of a builtin scalar type, from the type name reported by GDB.
+         *
+         * Returns false for aggregates, pointers and typedefs that are not known here, their values
+         * are shown as GDB reported them.
+         */
+        bool ClassifyType(std::string const & type, TypeInfo & info);
+
+        /** Format the natural value reported by GDB.
+         *
+         * Returns false if the value cannot be reformatted (not a scalar, or Natural format), the
+         * raw value is shown unchanged in that case.
+         */
+        bool FormatValue(std::string const & raw, TypeInfo const & type, Format format, std::string & out);
+
+    } // namespace value_format
+
+} // namespace dbg_mi
+
+#endif // _DEBUGGER_GDB_MI_VALUE_FORMAT_H_
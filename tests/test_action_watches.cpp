@@ -70,3 +70,75 @@ TEST(UpdateSimple)
     CHECK_EQUAL(wxT("a=5"), *watches[0]);
     CHECK(watches[0]->IsChanged());
 }
+
+TEST(WatchesUpdate_CollapseStepExpand)
+{
+    dbg_mi::GDBWatchesContainer watches;
+    cb::shared_ptr<dbg_mi::GDBWatch> root(new dbg_mi::GDBWatch(nullptr, nullptr, wxT("s"), false));
+    root->SetID(wxT("var1"));
+    watches.push_back(root);
+    watches.IndexWatch(root);
+
+    cb::shared_ptr<dbg_mi::GDBWatch> child(new dbg_mi::GDBWatch(nullptr, nullptr, wxT("a"), false));
+    child->SetID(wxT("var1.a"));
+    cbWatch::AddChild(root, child);
+    watches.IndexChildAdded(root, child);
+    root->SetHasBeenExpanded(true);
+
+    // Collapsed, the step freezes the child
+    root->Expand(false);
+    dbg_mi::GDBWatchesUpdateAction step(watches, nullptr);
+    step.SetID(1);
+    step.Start();
+
+    dbg_mi::CommandID id;
+    CHECK_EQUAL(wxString(wxT("-var-set-frozen var1.a 1")), step.PopPendingCommand(id));
+    CHECK_EQUAL(wxString(wxT("-var-update 1 *")), step.PopPendingCommand(id));
+    CHECK(child->IsFrozen());
+
+    // Expanded again, the child is thawed and updated with its parent, nothing else is
+    root->Expand(true);
+    dbg_mi::GDBWatchesUpdateAction expand(watches, nullptr, root);
+    expand.SetID(2);
+    expand.Start();
+
+    CHECK_EQUAL(wxString(wxT("-var-set-frozen var1.a 0")), expand.PopPendingCommand(id));
+    CHECK_EQUAL(wxString(wxT("-var-update 1 var1")), expand.PopPendingCommand(id));
+    CHECK(!expand.HasPendingCommands());
+    CHECK(!child->IsFrozen());
+}
+
+TEST(WatchesUpdate_ExpandKeepsNoAutoUpdateChildFrozen)
+{
+    dbg_mi::GDBWatchesContainer watches;
+    cb::shared_ptr<dbg_mi::GDBWatch> root(new dbg_mi::GDBWatch(nullptr, nullptr, wxT("s"), false));
+    root->SetID(wxT("var1"));
+    watches.push_back(root);
+    watches.IndexWatch(root);
+
+    cb::shared_ptr<dbg_mi::GDBWatch> manual(new dbg_mi::GDBWatch(nullptr, nullptr, wxT("a"), false));
+    manual->SetID(wxT("var1.a"));
+    cbWatch::AddChild(root, manual);
+    watches.IndexChildAdded(root, manual);
+    cb::shared_ptr<dbg_mi::GDBWatch> automatic(new dbg_mi::GDBWatch(nullptr, nullptr, wxT("b"), false));
+    automatic->SetID(wxT("var1.b"));
+    cbWatch::AddChild(root, automatic);
+    watches.IndexChildAdded(root, automatic);
+    root->SetHasBeenExpanded(true);
+
+    manual->AutoUpdate(false);
+    manual->SetFrozen(true);
+    automatic->SetFrozen(true);
+
+    root->Expand(true);
+    dbg_mi::GDBWatchesUpdateAction expand(watches, nullptr, root);
+    expand.SetID(1);
+    expand.Start();
+
+    dbg_mi::CommandID id;
+    CHECK_EQUAL(wxString(wxT("-var-set-frozen var1.b 0")), expand.PopPendingCommand(id));
+    CHECK_EQUAL(wxString(wxT("-var-update 1 var1")), expand.PopPendingCommand(id));
+    CHECK(!expand.HasPendingCommands());
+    CHECK(manual->IsFrozen());
+    CHECK(!automatic->IsFrozen());
+}
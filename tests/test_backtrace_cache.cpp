@@ -0,0 +1,202 @@
+#include "common.h"
+
+#include <string>
+#include <vector>
+
+#include "backtrace_cache.h"
+
+namespace
+{
+    dbg_mi::BacktraceFrameKey Key(uint64_t address, std::string const & function)
+    {
+        dbg_mi::BacktraceFrameKey key;
+        key.address = address;
+        key.function = function;
+        return key;
+    }
+
+    /** main -> run -> step, stopped in step. */
+    std::vector<dbg_mi::BacktraceFrameKey> Stack()
+    {
+        std::vector<dbg_mi::BacktraceFrameKey> frames;
+        frames.push_back(Key(0x1010, "step"));
+        frames.push_back(Key(0x2020, "run"));
+        frames.push_back(Key(0x3030, "loop"));
+        frames.push_back(Key(0x4040, "main"));
+        return frames;
+    }
+}
+
+TEST(BacktraceCache_StepKeepsCallers)
+{
+    dbg_mi::BacktraceCache cache;
+    cache.SetThread(1);
+    cache.SetStepped(true);
+    cache.Set(Stack(), 4);
+
+    std::vector<dbg_mi::BacktraceFrameKey> prefix(Stack());
+    prefix.resize(dbg_mi::BacktraceCache::PrefixFrames);
+    prefix[0].address = 0x1014;
+
+    dbg_mi::BacktraceReuse reuse = cache.Plan(prefix, 4);
+    CHECK_EQUAL(3, reuse.oldLevel);
+    CHECK_EQUAL(3, reuse.newLevel);
+    CHECK_EQUAL(1, reuse.count);
+    CHECK_EQUAL(reuse.readTo, reuse.readFrom);
+
+    // Another return address in the caller: it called step from somewhere else
+    prefix[2].address = 0x3034;
+    reuse = cache.Plan(prefix, 4);
+    CHECK_EQUAL(-1, reuse.oldLevel);
+    CHECK_EQUAL(3, reuse.readFrom);
+    CHECK_EQUAL(4, reuse.readTo);
+}
+
+TEST(BacktraceCache_StepIntoAndOut)
+{
+    dbg_mi::BacktraceCache cache;
+    cache.SetThread(1);
+    cache.SetStepped(true);
+    cache.Set(Stack(), 4);
+
+    // Stepped into leaf, the old frames are one level further
+    std::vector<dbg_mi::BacktraceFrameKey> prefix;
+    prefix.push_back(Key(0x5000, "leaf"));
+    prefix.push_back(Key(0x1014, "step"));
+    prefix.push_back(Key(0x2020, "run"));
+    dbg_mi::BacktraceReuse reuse = cache.Plan(prefix, 5);
+    CHECK_EQUAL(2, reuse.oldLevel);
+    CHECK_EQUAL(3, reuse.newLevel);
+    CHECK_EQUAL(2, reuse.count);
+
+    // Returned to loop, only main is left after the prefix
+    prefix.clear();
+    prefix.push_back(Key(0x3034, "loop"));
+    prefix.push_back(Key(0x4040, "main"));
+    reuse = cache.Plan(prefix, 2);
+    CHECK_EQUAL(-1, reuse.oldLevel);
+    CHECK_EQUAL(reuse.readTo, reuse.readFrom);
+}
+
+TEST(BacktraceCache_RecursionAndThreads)
+{
+    // fact calls itself from the same place, only the depth tells the frames apart
+    std::vector<dbg_mi::BacktraceFrameKey> frames;
+    frames.push_back(Key(0x100, "fact"));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        frames.push_back(Key(0x120, "fact"));
+    }
+
+    frames.push_back(Key(0x900, "main"));
+
+    dbg_mi::BacktraceCache cache;
+    cache.SetThread(1);
+    cache.SetStepped(true);
+    cache.Set(frames, 6);
+
+    std::vector<dbg_mi::BacktraceFrameKey> prefix(frames.begin(), frames.begin() + 3);
+    dbg_mi::BacktraceReuse reuse = cache.Plan(prefix, 7);
+    CHECK_EQUAL(2, reuse.oldLevel);
+    CHECK_EQUAL(3, reuse.newLevel);
+    CHECK_EQUAL(4, reuse.count);
+
+    // Unwound past the old frames
+    reuse = cache.Plan(prefix, 2);
+    CHECK_EQUAL(-1, reuse.oldLevel);
+
+    cache.SetThread(2);
+    CHECK(cache.IsEmpty());
+}
+
+TEST(BacktraceCache_ReadsFramesPastTheOldCut)
+{
+    std::vector<dbg_mi::BacktraceFrameKey> frames;
+
+    for (int i = 0; i < dbg_mi::BacktraceCache::MaxFrames; ++i)
+    {
+        frames.push_back(Key(0x1000 + i * 0x10, "f"));
+    }
+
+    dbg_mi::BacktraceCache cache;
+    cache.SetThread(1);
+    cache.SetStepped(true);
+    cache.Set(frames, 40);
+
+    // One frame less: the old frames shift up by one, the last level was never listed
+    std::vector<dbg_mi::BacktraceFrameKey> prefix(frames.begin() + 1, frames.begin() + 4);
+    dbg_mi::BacktraceReuse reuse = cache.Plan(prefix, 39);
+    CHECK_EQUAL(4, reuse.oldLevel);
+    CHECK_EQUAL(3, reuse.newLevel);
+    CHECK_EQUAL(dbg_mi::BacktraceCache::MaxFrames - 4, reuse.count);
+    CHECK_EQUAL(dbg_mi::BacktraceCache::MaxFrames - 1, reuse.readFrom);
+    CHECK_EQUAL(int(dbg_mi::BacktraceCache::MaxFrames), reuse.readTo);
+}
+
+namespace
+{
+    /** main -> outer -> b -> c -> x, stopped in x. */
+    std::vector<dbg_mi::BacktraceFrameKey> Path(std::string const & outer, uint64_t outer_address)
+    {
+        std::vector<dbg_mi::BacktraceFrameKey> frames;
+        frames.push_back(Key(0x1000, "x"));
+        frames.push_back(Key(0x2010, "c"));
+        frames.push_back(Key(0x3010, "b"));
+        frames.push_back(Key(outer_address, outer));
+        frames.push_back(Key(0x5010, "main"));
+        return frames;
+    }
+}
+
+TEST(BacktraceCache_TwoPathsToTheSameFunction)
+{
+    // A breakpoint in x reached from a, then from d: the prefix x, c, b is the same at the same depth
+    dbg_mi::BacktraceCache cache;
+    cache.SetThread(1);
+    cache.SetStepped(false);
+    cache.Set(Path("a", 0x4010), 5);
+
+    std::vector<dbg_mi::BacktraceFrameKey> prefix(Path("d", 0x4810));
+    prefix.resize(dbg_mi::BacktraceCache::PrefixFrames);
+    dbg_mi::BacktraceReuse reuse = cache.Plan(prefix, 5);
+    CHECK_EQUAL(-1, reuse.oldLevel);
+    CHECK_EQUAL(0, reuse.count);
+    CHECK_EQUAL(3, reuse.readFrom);
+    CHECK_EQUAL(5, reuse.readTo);
+
+    // Stepping in x afterwards keeps d and main
+    cache.Set(Path("d", 0x4810), 5);
+    cache.SetStepped(true);
+    prefix[0].address = 0x1004;
+    reuse = cache.Plan(prefix, 5);
+    CHECK_EQUAL(3, reuse.oldLevel);
+    CHECK_EQUAL(2, reuse.count);
+    CHECK_EQUAL(reuse.readTo, reuse.readFrom);
+}
+
+TEST(BacktraceCache_DepthAtTheLimit)
+{
+    std::vector<dbg_mi::BacktraceFrameKey> frames;
+
+    for (int i = 0; i < dbg_mi::BacktraceCache::MaxFrames; ++i)
+    {
+        frames.push_back(Key(0x1000 + i * 0x10, "f"));
+    }
+
+    dbg_mi::BacktraceCache cache;
+    cache.SetThread(1);
+    cache.SetStepped(true);
+    std::vector<dbg_mi::BacktraceFrameKey> prefix(frames.begin(), frames.begin() + dbg_mi::BacktraceCache::PrefixFrames);
+
+    // GDB stopped counting, the old and the new stack could have any depth
+    cache.Set(frames, dbg_mi::BacktraceCache::MaxDepth);
+    dbg_mi::BacktraceReuse reuse = cache.Plan(prefix, dbg_mi::BacktraceCache::MaxDepth);
+    CHECK_EQUAL(-1, reuse.oldLevel);
+    CHECK_EQUAL(int(dbg_mi::BacktraceCache::MaxFrames), reuse.readTo);
+
+    cache.Set(frames, dbg_mi::BacktraceCache::MaxDepth - 1);
+    reuse = cache.Plan(prefix, dbg_mi::BacktraceCache::MaxDepth - 1);
+    CHECK_EQUAL(int(dbg_mi::BacktraceCache::PrefixFrames), reuse.oldLevel);
+    CHECK_EQUAL(reuse.readTo, reuse.readFrom);
+}
@@ -0,0 +1,61 @@
+#include "common.h"
+
+#include "cmd_history.h"
+
+TEST(CommandHistory_KeepsInsertionOrder)
+{
+    dbg_mi::CommandHistory history(4);
+    history.Add(1, 0, "-stack-info-frame");
+    history.Add(1, 1, "-stack-list-frames 0 30");
+
+    CHECK_EQUAL(2u, history.GetCount());
+    CHECK_EQUAL(wxString("-stack-info-frame"), *history.GetEntry(0).command);
+    CHECK_EQUAL(wxString("-stack-list-frames 0 30"), *history.GetEntry(1).command);
+    CHECK_EQUAL(1, history.GetEntry(1).command_in_action);
+}
+
+TEST(CommandHistory_BoundedRing)
+{
+    dbg_mi::CommandHistory history(3);
+
+    for (int ii = 0; ii < 10; ++ii)
+    {
+        history.Add(ii, 0, wxString::Format("-var-update %d", ii));
+    }
+
+    CHECK_EQUAL(3u, history.GetCount());
+    CHECK_EQUAL(10u, history.GetTotalCount());
+    CHECK_EQUAL(wxString("-var-update 7"), *history.GetEntry(0).command);
+    CHECK_EQUAL(wxString("-var-update 9"), *history.GetEntry(2).command);
+    // overwritten commands are released from the intern pool
+    CHECK_EQUAL(3u, history.GetInternedCount());
+}
+
+TEST(CommandHistory_InternsDuplicates)
+{
+    dbg_mi::CommandHistory history(8);
+
+    for (int ii = 0; ii < 8; ++ii)
+    {
+        history.Add(ii, 0, "-var-update 1 *");
+    }
+
+    CHECK_EQUAL(1u, history.GetInternedCount());
+    CHECK(history.GetEntry(0).command == history.GetEntry(7).command);
+}
+
+TEST(CommandHistory_Find)
+{
+    dbg_mi::CommandHistory history(8);
+    history.Add(5, 0, "-data-list-register-names");
+    history.Add(5, 1, "-data-list-register-values x");
+
+    wxString command;
+    CHECK(history.Find(5, 1, command));
+    CHECK_EQUAL(wxString("-data-list-register-values x"), command);
+    CHECK(!history.Find(6, 0, command));
+
+    history.Clear();
+    CHECK_EQUAL(0u, history.GetCount());
+    CHECK(!history.Find(5, 0, command));
+}
@@ -0,0 +1,167 @@
+#include "common.h"
+
+#include <string>
+#include <vector>
+
+#include "disassembly_cache.h"
+
+namespace
+{
+    /** count instructions of 4 bytes at start, in function main starting at function. */
+    dbg_mi::DisassemblyRange Instructions(uint64_t start, int count, uint64_t function)
+    {
+        dbg_mi::DisassemblyRange range;
+
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t const address = start + i * 4;
+            range.AddInstruction(address, static_cast<uint32_t>(address - function), "nop " + std::to_string(address), "main");
+        }
+
+        return range;
+    }
+
+    dbg_mi::DisassemblyWindow Window(uint64_t start, uint64_t end, uint64_t landing)
+    {
+        dbg_mi::DisassemblyWindow window;
+        window.start = start;
+        window.end = end;
+        window.landing = landing;
+        return window;
+    }
+}
+
+TEST(DisassemblyCache_RangeArrays)
+{
+    dbg_mi::DisassemblyRange range;
+    range.AddSourceLine(10, "/src/main.cpp");
+    CHECK(range.AddInstruction(0x1000, 0, "push   %rbp", "main"));
+    CHECK(range.AddInstruction(0x1001, 1, "mov    %rsp,%rbp", "main"));
+    range.AddSourceLine(11, "/src/main.cpp");
+    range.AddSourceLine(3, "/src/inline.h");
+    CHECK(range.AddInstruction(0x1004, 4, "ret", "main"));
+    CHECK(!range.AddInstruction(0x1002, 2, "nop", "main"));
+    range.AddSourceLine(12, "/src/main.cpp");
+
+    CHECK_EQUAL(3, int(range.GetCount()));
+    CHECK_EQUAL("mov    %rsp,%rbp", range.GetText(1));
+    CHECK_EQUAL("ret", range.GetText(2));
+    CHECK_EQUAL(4u, range.GetOffset(2));
+    CHECK_EQUAL(0x1000u, range.GetFunctionStart(2));
+    CHECK_EQUAL("main", range.GetFunction(1));
+    CHECK(range.Contains(0x1001));
+    CHECK(!range.Contains(0x1002));
+    CHECK_EQUAL(2, int(range.LowerBound(0x1002)));
+
+    // The last line has no instruction after it
+    CHECK_EQUAL(3, int(range.GetSourceLineCount()));
+    CHECK_EQUAL(0x1004u, range.GetSourceLineAddress(1));
+    CHECK_EQUAL("/src/inline.h", range.GetSourceFile(2));
+    CHECK_EQUAL(3, range.GetSourceLine(2));
+    CHECK_EQUAL(1, int(range.LowerBoundSourceLine(0x1001)));
+}
+
+TEST(DisassemblyCache_Merge)
+{
+    dbg_mi::DisassemblyRange listing;
+    listing.AddSourceLine(5, "/src/a.cpp");
+    listing.AddInstruction(0x2000, 0, "first", "f");
+    listing.AddInstruction(0x2008, 8, "third", "f");
+
+    dbg_mi::DisassemblyRange other;
+    other.AddSourceLine(99, "/src/other.cpp");
+    other.AddInstruction(0x2000, 0, "replaced", "f");
+    other.AddSourceLine(6, "/src/b.cpp");
+    other.AddInstruction(0x2004, 4, "second", "f");
+    other.AddInstruction(0x3000, 0, "fourth", "g");
+
+    listing.Merge(other);
+    CHECK_EQUAL(4, int(listing.GetCount()));
+    CHECK_EQUAL("first", listing.GetText(0));
+    CHECK_EQUAL("second", listing.GetText(1));
+    CHECK_EQUAL("third", listing.GetText(2));
+    CHECK_EQUAL("fourth", listing.GetText(3));
+    CHECK_EQUAL("g", listing.GetFunction(3));
+    CHECK_EQUAL("f", listing.GetFunction(2));
+
+    // The source line of the instruction that was already there is not added again
+    CHECK_EQUAL(2, int(listing.GetSourceLineCount()));
+    CHECK_EQUAL("/src/a.cpp", listing.GetSourceFile(0));
+    CHECK_EQUAL(0x2004u, listing.GetSourceLineAddress(1));
+    CHECK_EQUAL("/src/b.cpp", listing.GetSourceFile(1));
+}
+
+TEST(DisassemblyCache_FirstStopLandsOnPc)
+{
+    dbg_mi::DisassemblyCache cache;
+    uint64_t const pc = 0x10400;
+    dbg_mi::MemorySpan const view = cache.GetView(pc);
+    CHECK_EQUAL(pc - dbg_mi::DisassemblyCache::WindowSize, view.start);
+    CHECK_EQUAL(pc + dbg_mi::DisassemblyCache::WindowSize, view.end);
+    CHECK(!cache.IsRead(view.start, view.end));
+
+    std::vector<dbg_mi::DisassemblyWindow> windows;
+    cache.PlanWindows(pc, view.start, view.end, windows);
+    CHECK_EQUAL(2, int(windows.size()));
+    CHECK_EQUAL(view.start, windows[0].start);
+    CHECK_EQUAL(pc + 1, windows[0].end);
+    CHECK_EQUAL(pc, windows[0].landing);
+    CHECK_EQUAL(pc, windows[1].start);
+    CHECK_EQUAL(view.end, windows[1].end);
+    CHECK_EQUAL(0u, windows[1].landing);
+
+    // Decoded out of step with the real instructions, nothing is kept but it is not read again
+    CHECK(!cache.Add(windows[0], Instructions(view.start + 2, 64, 0x10000)));
+    CHECK_EQUAL(0, int(cache.GetCount()));
+    CHECK(cache.Add(windows[1], Instructions(pc, 64, 0x10000)));
+    CHECK(cache.IsRead(view.start, view.end));
+    CHECK(cache.GetInstructions().Contains(pc));
+}
+
+TEST(DisassemblyCache_ChainsFromKnownInstructions)
+{
+    dbg_mi::DisassemblyCache cache;
+    uint64_t const function = 0x20000;
+    uint64_t const pc = 0x20040;
+
+    // The function start is known from the offsets, the view does not go before it
+    CHECK(cache.Add(Window(pc, pc + 0x100, 0), Instructions(pc, 64, function)));
+    dbg_mi::MemorySpan const view = cache.GetView(pc);
+    CHECK_EQUAL(function, view.start);
+
+    // The view and one window ahead of it
+    std::vector<dbg_mi::DisassemblyWindow> windows;
+    cache.PlanWindows(pc, view.start, view.end + dbg_mi::DisassemblyCache::WindowSize, windows);
+    CHECK_EQUAL(2, int(windows.size()));
+    CHECK_EQUAL(function, windows[0].start);
+    CHECK_EQUAL(pc, windows[0].end);
+    CHECK_EQUAL(0u, windows[0].landing);
+
+    // The window ahead starts at the last instruction read before
+    CHECK_EQUAL(pc + 0xfc, windows[1].start);
+    CHECK_EQUAL(view.end + dbg_mi::DisassemblyCache::WindowSize, windows[1].end);
+    CHECK_EQUAL(0u, windows[1].landing);
+}
+
+TEST(DisassemblyCache_ShownView)
+{
+    dbg_mi::DisassemblyCache cache;
+    uint64_t const pc = 0x30000;
+    CHECK(cache.Add(Window(pc, pc + 0x200, 0), Instructions(pc, 128, pc)));
+    dbg_mi::MemorySpan const view = cache.GetView(pc);
+    cache.SetShown(view);
+
+    CHECK(cache.IsShown(pc));
+    CHECK(cache.IsShown(pc + 0x40));
+    CHECK(!cache.IsShown(pc + 0x42));
+    CHECK(!cache.IsShown(pc + dbg_mi::DisassemblyCache::WindowSize));
+
+    // Code read after the view was shown does not change it
+    CHECK(cache.Add(Window(pc + 0x200, pc + 0x300, 0), Instructions(pc + 0x200, 64, pc)));
+    CHECK(cache.IsShown(pc));
+
+    // A new flavor drops everything
+    cache.SetKey("0 set disassembly-flavor intel");
+    CHECK(!cache.IsShown(pc));
+    CHECK_EQUAL(0, int(cache.GetCount()));
+}
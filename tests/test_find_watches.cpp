@@ -95,3 +95,116 @@ TEST_FIXTURE(FindWatchFixture, Var1_public_b_private_b)
     cb::shared_ptr<dbg_mi::Watch> w = dbg_mi::FindWatch(wxT("var2.public.b.private.b"), watches);
     CHECK(w && w->GetID() == wxT("var2.public.b.private.b"));
 }
+
+TEST_FIXTURE(FindWatchFixture, IndexedLookupReturnsSameWatch)
+{
+    cb::shared_ptr<dbg_mi::Watch> first = dbg_mi::FindWatch(wxT("var2.public.b.private.b"), watches);
+    cb::shared_ptr<dbg_mi::Watch> second = dbg_mi::FindWatch(wxT("var2.public.b.private.b"), watches);
+    CHECK(first && first == second);
+    CHECK(watches.GetIndexSize() > 0);
+}
+
+TEST_FIXTURE(FindWatchFixture, RemovedChildrenAreNotFound)
+{
+    cb::shared_ptr<dbg_mi::Watch> w = dbg_mi::FindWatch(wxT("var1.public.c"), watches);
+    CHECK(w);
+    watches.RemoveChildren(dbg_mi::FindWatch(wxT("var1"), watches));
+    CHECK(!dbg_mi::FindWatch(wxT("var1.public.c"), watches));
+    CHECK(!dbg_mi::FindWatch(wxT("var1.public.c.private.a"), watches));
+}
+
+TEST_FIXTURE(FindWatchFixture, ChildrenRemovedBehindTheIndexAreNotFound)
+{
+    cb::shared_ptr<dbg_mi::Watch> w = dbg_mi::FindWatch(wxT("var2.public.b.private.a"), watches);
+    CHECK(w);
+    dbg_mi::FindWatch(wxT("var2.public.b"), watches)->RemoveChildren();
+    CHECK(!dbg_mi::FindWatch(wxT("var2.public.b.private.a"), watches));
+}
+
+TEST_FIXTURE(FindWatchFixture, ErasedWatchIsNotFound)
+{
+    CHECK(dbg_mi::FindWatch(wxT("var1.public.c"), watches));
+    watches.erase(watches.begin());
+    CHECK(!dbg_mi::FindWatch(wxT("var1"), watches));
+    CHECK(!dbg_mi::FindWatch(wxT("var1.public.c"), watches));
+}
+
+TEST_FIXTURE(FindWatchFixture, NewChildIsFound)
+{
+    cb::shared_ptr<dbg_mi::Watch> parent = dbg_mi::FindWatch(wxT("var3"), watches);
+    CHECK(!dbg_mi::FindWatch(wxT("var3.x"), watches));
+    cb::shared_ptr<dbg_mi::Watch> child = MakeWatch(wxT("x"), wxT("var3.x"));
+    cbWatch::AddChild(parent, child);
+    watches.IndexChildAdded(parent, child);
+    CHECK(dbg_mi::FindWatch(wxT("var3.x"), watches) == child);
+}
+
+TEST_FIXTURE(FindWatchFixture, ChildInPageIsFound)
+{
+    cb::shared_ptr<dbg_mi::Watch> parent = dbg_mi::FindWatch(wxT("var3"), watches);
+    cb::shared_ptr<dbg_mi::Watch> page = MakeWatch(wxT("[256..511]"), wxEmptyString);
+    page->SetPageIndex(parent->GetChildCount());
+    page->SetRangeArray(256, 512);
+    cbWatch::AddChild(parent, page);
+    cb::shared_ptr<dbg_mi::Watch> child = MakeWatch(wxT("300"), wxT("var3.300"));
+    cbWatch::AddChild(page, child);
+    watches.IndexChildAdded(page, child);
+    CHECK(dbg_mi::FindWatch(wxT("var3.300"), watches) == child);
+    watches.RemoveChildren(page);
+    CHECK(!dbg_mi::FindWatch(wxT("var3.300"), watches));
+}
+
+TEST_FIXTURE(FindWatchFixture, LocalsAreFound)
+{
+    cb::shared_ptr<dbg_mi::Watch> locals = MakeWatch(wxT("Function locals and arguments"), wxEmptyString);
+    cb::shared_ptr<dbg_mi::Watch> local = MakeWatch(wxT("argc"), wxT("var7"));
+    cbWatch::AddChild(locals, local);
+    watches.GetLocals().push_back(local);
+    cb::shared_ptr<dbg_mi::Watch> child = MakeWatch(wxT("x"), wxT("var7.x"));
+    cbWatch::AddChild(local, child);
+
+    CHECK(dbg_mi::FindWatch(wxT("var7"), watches) == local);
+    CHECK(dbg_mi::FindWatch(wxT("var7.x"), watches) == child);
+    CHECK(dbg_mi::FindWatch(wxT("var7"), watches) == local);
+
+    watches.ClearLocals();
+    CHECK(!dbg_mi::FindWatch(wxT("var7"), watches));
+    CHECK(!dbg_mi::FindWatch(wxT("var7.x"), watches));
+}
+
+TEST_FIXTURE(FindWatchFixture, LocalsReplacedThroughTheContainer)
+{
+    cb::shared_ptr<dbg_mi::Watch> locals = MakeWatch(wxT("Function locals and arguments"), wxEmptyString);
+    cb::shared_ptr<dbg_mi::Watch> argc = MakeWatch(wxT("argc"), wxT("var7"));
+    cb::shared_ptr<dbg_mi::Watch> argv = MakeWatch(wxT("argv"), wxT("var8"));
+    std::vector<cb::shared_ptr<dbg_mi::Watch>> current;
+    current.push_back(argc);
+    current.push_back(argv);
+    watches.SetLocals(locals, current);
+    CHECK_EQUAL(2, locals->GetChildCount());
+    CHECK(dbg_mi::FindWatch(wxT("var8"), watches) == argv);
+
+    // argc went out of scope, argv moves to the first position
+    current.erase(current.begin());
+    watches.SetLocals(locals, current);
+    CHECK_EQUAL(1, locals->GetChildCount());
+    CHECK(locals->GetChild(0) == argv);
+    CHECK_EQUAL(1u, watches.GetLocals().size());
+    CHECK(!dbg_mi::FindWatch(wxT("var7"), watches));
+    CHECK(dbg_mi::FindWatch(wxT("var8"), watches) == argv);
+}
+
+TEST_FIXTURE(FindWatchFixture, ChildReplacedBehindTheIndexIsFound)
+{
+    CHECK(dbg_mi::FindWatch(wxT("var2.public.b.private.b"), watches));
+
+    // Same number of children, replaced without the container: the index still has the old ones
+    cb::shared_ptr<dbg_mi::Watch> parent = dbg_mi::FindWatch(wxT("var2.public.b"), watches);
+    parent->RemoveChildren();
+    cbWatch::AddChild(parent, MakeWatch(wxT("x"), wxT("var2.public.b.private.x")));
+    cb::shared_ptr<dbg_mi::Watch> child = MakeWatch(wxT("y"), wxT("var2.public.b.private.y"));
+    cbWatch::AddChild(parent, child);
+
+    CHECK(dbg_mi::FindWatch(wxT("var2.public.b.private.y"), watches) == child);
+    CHECK(!dbg_mi::FindWatch(wxT("var2.public.b.private.b"), watches));
+}
@@ -108,6 +108,16 @@ TEST(StoppedReasonParse_SignalReceived)
     CHECK(TestReason(wxT("reason=\"signal-received\"")) == dbg_mi::StoppedReason::SignalReceived);
 }
 
+TEST(StoppedReasonParse_FunctionFinished)
+{
+    CHECK(TestReason(wxT("reason=\"function-finished\"")) == dbg_mi::StoppedReason::FunctionFinished);
+}
+
+TEST(StoppedReasonParse_EndSteppingRange)
+{
+    CHECK(TestReason(wxT("reason=\"end-stepping-range\"")) == dbg_mi::StoppedReason::EndSteppingRange);
+}
+
 
 
 wxString const c_stack_args_output(
@@ -0,0 +1,172 @@
+#include "common.h"
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "hex_codec.h"
+
+TEST(HexCodec_Decode)
+{
+    std::string const hex = "000154657374ff7F";
+    std::vector<uint8_t> bytes;
+    CHECK(dbg_mi::hex_codec::Decode(hex.data(), hex.length(), bytes));
+    CHECK_EQUAL(8u, bytes.size());
+    CHECK_EQUAL(0x00, bytes[0]);
+    CHECK_EQUAL(0x01, bytes[1]);
+    CHECK_EQUAL('T', bytes[2]);
+    CHECK_EQUAL(0xFF, bytes[6]);
+    CHECK_EQUAL(0x7F, bytes[7]);
+}
+
+TEST(HexCodec_DecodeAppends)
+{
+    std::vector<uint8_t> bytes(1, 0xAA);
+    CHECK(dbg_mi::hex_codec::Decode("0b", 2, bytes));
+    CHECK_EQUAL(2u, bytes.size());
+    CHECK_EQUAL(0xAA, bytes[0]);
+    CHECK_EQUAL(0x0B, bytes[1]);
+}
+
+TEST(HexCodec_DecodeInvalid)
+{
+    std::vector<uint8_t> bytes;
+    CHECK(!dbg_mi::hex_codec::Decode("abc", 3, bytes));
+    CHECK(!dbg_mi::hex_codec::Decode("0g", 2, bytes));
+    CHECK(!dbg_mi::hex_codec::Decode("00 1", 4, bytes));
+    CHECK(bytes.empty());
+}
+
+TEST(HexCodec_DecodeToBuffer)
+{
+    // Long enough for the wide blocks, the bytes around the target stay untouched
+    std::string hex;
+    std::vector<uint8_t> expected;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        hex.append(dbg_mi::hex_codec::ByteToHex(static_cast<uint8_t>(i * 3)), 2);
+        expected.push_back(static_cast<uint8_t>(i * 3));
+    }
+
+    std::vector<uint8_t> buffer(102, 0xEE);
+    CHECK(dbg_mi::hex_codec::Decode(hex.data(), hex.length(), buffer.data() + 1));
+    CHECK_EQUAL(0xEE, buffer[0]);
+    CHECK_EQUAL(0xEE, buffer[101]);
+    CHECK(std::vector<uint8_t>(buffer.begin() + 1, buffer.end() - 1) == expected);
+    CHECK(!dbg_mi::hex_codec::Decode("0g", 2, buffer.data()));
+}
+
+TEST(HexCodec_ByteToHex)
+{
+    CHECK_EQUAL("00", std::string(dbg_mi::hex_codec::ByteToHex(0x00), 2));
+    CHECK_EQUAL("5a", std::string(dbg_mi::hex_codec::ByteToHex(0x5A), 2));
+    CHECK_EQUAL("ff", std::string(dbg_mi::hex_codec::ByteToHex(0xFF), 2));
+}
+
+namespace
+{
+    std::vector<uint8_t> MakeBytes(size_t count)
+    {
+        std::vector<uint8_t> bytes(count);
+        uint32_t seed = 12345;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            bytes[i] = static_cast<uint8_t>(seed >> 16);
+        }
+
+        return bytes;
+    }
+}
+
+TEST(HexCodec_AllImplementationsRoundTrip)
+{
+    // Sizes around the 16/32 byte blocks of the vector paths
+    size_t const sizes[] = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        std::vector<uint8_t> const bytes = MakeBytes(sizes[s]);
+
+        for (int impl = dbg_mi::hex_codec::Scalar; impl <= dbg_mi::hex_codec::AVX2; ++impl)
+        {
+            std::string hex;
+            dbg_mi::hex_codec::Encode(bytes.data(), bytes.size(), hex, dbg_mi::hex_codec::Implementation(impl));
+            CHECK_EQUAL(bytes.size() * 2, hex.size());
+
+            std::string scalarHex;
+            dbg_mi::hex_codec::Encode(bytes.data(), bytes.size(), scalarHex, dbg_mi::hex_codec::Scalar);
+            CHECK(hex == scalarHex);
+
+            std::vector<uint8_t> decoded;
+            CHECK(dbg_mi::hex_codec::Decode(hex.data(), hex.size(), decoded, dbg_mi::hex_codec::Implementation(impl)));
+            CHECK(decoded == bytes);
+        }
+    }
+}
+
+TEST(HexCodec_AllImplementationsRejectInvalid)
+{
+    std::vector<uint8_t> const bytes = MakeBytes(100);
+    std::string hex;
+    dbg_mi::hex_codec::Encode(bytes.data(), bytes.size(), hex);
+
+    // Upper case digits are accepted, anything else is rejected wherever it is
+    std::string upper = hex;
+
+    for (size_t i = 0; i < upper.size(); ++i)
+    {
+        upper[i] = static_cast<char>(toupper(upper[i]));
+    }
+
+    char const bad[] = {'g', 'G', ' ', '/', ':', '@', '`', '\x80', '\xff'};
+    size_t const positions[] = {0, 5, 31, 40, 63, 64, 127, 199};
+
+    for (int impl = dbg_mi::hex_codec::Scalar; impl <= dbg_mi::hex_codec::AVX2; ++impl)
+    {
+        std::vector<uint8_t> decoded;
+        CHECK(dbg_mi::hex_codec::Decode(upper.data(), upper.size(), decoded, dbg_mi::hex_codec::Implementation(impl)));
+        CHECK(decoded == bytes);
+
+        for (size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); ++p)
+        {
+            for (size_t b = 0; b < sizeof(bad); ++b)
+            {
+                std::string broken = hex;
+                broken[positions[p]] = bad[b];
+                std::vector<uint8_t> out(3, 0);
+                CHECK(!dbg_mi::hex_codec::Decode(broken.data(), broken.size(), out, dbg_mi::hex_codec::Implementation(impl)));
+                CHECK_EQUAL(3u, out.size());
+            }
+        }
+    }
+}
+
+TEST(HexCodec_DecodeInput)
+{
+    std::vector<uint8_t> bytes;
+    CHECK_EQUAL(dbg_mi::hex_codec::InputOk, dbg_mi::hex_codec::DecodeInput("01 ff 7a", 4, bytes));
+    CHECK_EQUAL(3u, bytes.size());
+    CHECK_EQUAL(0x7A, bytes[2]);
+
+    // Exactly the size of the range
+    CHECK_EQUAL(dbg_mi::hex_codec::InputOk, dbg_mi::hex_codec::DecodeInput("0102", 2, bytes));
+    CHECK_EQUAL(2u, bytes.size());
+
+    CHECK_EQUAL(dbg_mi::hex_codec::InputInvalid, dbg_mi::hex_codec::DecodeInput("  ", 4, bytes));
+    CHECK_EQUAL(dbg_mi::hex_codec::InputInvalid, dbg_mi::hex_codec::DecodeInput("0x01", 4, bytes));
+    CHECK_EQUAL(2u, bytes.size());
+}
+
+TEST(HexCodec_DecodeInputLongerThanRange)
+{
+    std::vector<uint8_t> bytes(1, 0xAA);
+    CHECK_EQUAL(dbg_mi::hex_codec::InputTooLong, dbg_mi::hex_codec::DecodeInput("01 02 03 04 05", 4, bytes));
+    CHECK_EQUAL(dbg_mi::hex_codec::InputTooLong, dbg_mi::hex_codec::DecodeInput("00", 0, bytes));
+
+    // Nothing to write, the previous contents are left alone
+    CHECK_EQUAL(1u, bytes.size());
+    CHECK_EQUAL(0xAA, bytes[0]);
+}
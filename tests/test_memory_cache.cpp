@@ -0,0 +1,164 @@
+#include "common.h"
+
+#include <vector>
+
+#include "memory_cache.h"
+
+namespace
+{
+    std::vector<uint8_t> Pattern(uint64_t address, size_t size)
+    {
+        std::vector<uint8_t> bytes(size);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>((address + i) * 7);
+        }
+
+        return bytes;
+    }
+}
+
+TEST(MemoryCache_ReadAcrossPages)
+{
+    dbg_mi::MemoryPageCache cache;
+    std::vector<uint8_t> const memory = Pattern(0x10000, 3 * 4096);
+    cache.Store(0x10000, memory.data(), memory.size());
+    CHECK_EQUAL(3, int(cache.GetPageCount()));
+    CHECK(cache.GetMemoryBytes() >= 3 * 4096);
+
+    std::vector<uint8_t> bytes;
+    CHECK(cache.Read(0x10ff0, 0x20, bytes));
+    CHECK(bytes == Pattern(0x10ff0, 0x20));
+    CHECK(cache.Read(0x10000, 3 * 4096, bytes));
+    CHECK(bytes == memory);
+    CHECK(!cache.Read(0x12ff0, 0x20, bytes));
+    CHECK(!cache.Read(0x10000, 0, bytes));
+    CHECK_EQUAL(2, int(cache.GetHits()));
+    CHECK_EQUAL(2, int(cache.GetMisses()));
+}
+
+TEST(MemoryCache_PartialPagesNotStored)
+{
+    dbg_mi::MemoryPageCache cache;
+    std::vector<uint8_t> const memory = Pattern(0x10010, 2 * 4096);
+    cache.Store(0x10010, memory.data(), memory.size());
+
+    // Only 0x11000..0x12000 is covered completely
+    CHECK_EQUAL(1, int(cache.GetPageCount()));
+    std::vector<uint8_t> bytes;
+    CHECK(cache.Copy(0x11000, 4096, bytes));
+    CHECK(bytes == Pattern(0x11000, 4096));
+    CHECK(!cache.Copy(0x10ff0, 0x20, bytes));
+    CHECK_EQUAL(0, int(cache.GetHits()));
+    CHECK_EQUAL(0, int(cache.GetMisses()));
+}
+
+TEST(MemoryCache_MissingSpan)
+{
+    dbg_mi::MemoryPageCache cache;
+    std::vector<uint8_t> const memory = Pattern(0x11000, 4096);
+    cache.Store(0x11000, memory.data(), memory.size());
+
+    uint64_t start = 0, end = 0;
+    CHECK(!cache.GetMissingSpan(0x11000, 4096, start, end));
+    CHECK(cache.GetMissingSpan(0x10800, 0x1000, start, end));
+    CHECK_EQUAL(0x10000ULL, start);
+    CHECK_EQUAL(0x11000ULL, end);
+    CHECK(cache.GetMissingSpan(0x10800, 0x2000, start, end));
+    CHECK_EQUAL(0x10000ULL, start);
+    CHECK_EQUAL(0x13000ULL, end);
+    CHECK(cache.GetMissingSpan(0xfffffffffffff800ULL, 0x800, start, end));
+    CHECK_EQUAL(0xfffffffffffff000ULL, start);
+}
+
+TEST(MemoryCache_Invalidate)
+{
+    dbg_mi::MemoryPageCache cache;
+    std::vector<uint8_t> const memory = Pattern(0x10000, 3 * 4096);
+    cache.Store(0x10000, memory.data(), memory.size());
+
+    cache.Invalidate(0x10ffe, 4);
+    CHECK_EQUAL(1, int(cache.GetPageCount()));
+    std::vector<uint8_t> bytes;
+    CHECK(cache.Copy(0x12000, 16, bytes));
+    cache.Invalidate();
+    CHECK_EQUAL(0, int(cache.GetPageCount()));
+    CHECK(!cache.Copy(0x12000, 16, bytes));
+}
+
+TEST(MemoryCache_CoalesceSpans)
+{
+    std::vector<dbg_mi::MemorySpan> spans;
+    spans.push_back({0x3000, 0x3010});
+    spans.push_back({0x1000, 0x1008});
+    spans.push_back({0x1004, 0x1010});
+    spans.push_back({0x1020, 0x1030});
+    spans.push_back({0x2000, 0x2004});
+
+    std::vector<dbg_mi::MemorySpan> merged = dbg_mi::CoalesceSpans(spans, 0);
+    CHECK_EQUAL(4, int(merged.size()));
+    CHECK_EQUAL(0x1000ULL, merged[0].start);
+    CHECK_EQUAL(0x1010ULL, merged[0].end);
+
+    merged = dbg_mi::CoalesceSpans(spans, 0x10);
+    CHECK_EQUAL(3, int(merged.size()));
+    CHECK_EQUAL(0x1030ULL, merged[0].end);
+
+    merged = dbg_mi::CoalesceSpans(spans, 0x1000);
+    CHECK_EQUAL(1, int(merged.size()));
+    CHECK_EQUAL(0x1000ULL, merged[0].start);
+    CHECK_EQUAL(0x3010ULL, merged[0].end);
+
+    CHECK(dbg_mi::CoalesceSpans(std::vector<dbg_mi::MemorySpan>(), 0x10).empty());
+}
+
+TEST(MemoryCache_FindUncovered)
+{
+    std::vector<dbg_mi::MemorySpan> spans;
+    spans.push_back({0x1800, 0x1900});
+    spans.push_back({0x0f00, 0x1100});
+    spans.push_back({0x1880, 0x1a00});
+
+    std::vector<dbg_mi::MemorySpan> holes = dbg_mi::FindUncovered(spans, 0x1000, 0x2000);
+    CHECK_EQUAL(2, int(holes.size()));
+    CHECK_EQUAL(0x1100ULL, holes[0].start);
+    CHECK_EQUAL(0x1800ULL, holes[0].end);
+    CHECK_EQUAL(0x1a00ULL, holes[1].start);
+    CHECK_EQUAL(0x2000ULL, holes[1].end);
+
+    CHECK(dbg_mi::FindUncovered(spans, 0x1800, 0x1a00).empty());
+
+    holes = dbg_mi::FindUncovered(std::vector<dbg_mi::MemorySpan>(), 0x1000, 0x1010);
+    CHECK_EQUAL(1, int(holes.size()));
+    CHECK_EQUAL(0x1000ULL, holes[0].start);
+    CHECK_EQUAL(0x1010ULL, holes[0].end);
+}
+
+TEST(MemoryCache_Epoch)
+{
+    dbg_mi::MemoryPageCache cache;
+    unsigned long const epoch = cache.GetEpoch();
+    cache.Invalidate(0x1000, 1);
+    CHECK(cache.GetEpoch() != epoch);
+    unsigned long const next = cache.GetEpoch();
+    cache.Invalidate();
+    CHECK(cache.GetEpoch() != next);
+}
+
+TEST(MemoryCache_FirstReaderDoesNotWait)
+{
+    // The plugin asks HasReaders() before making a read action, which registers itself
+    dbg_mi::MemoryPageCache cache;
+    bool const first_waits = cache.HasReaders();
+    cache.AddReader();
+    CHECK(!first_waits);
+
+    bool const second_waits = cache.HasReaders();
+    cache.AddReader();
+    CHECK(second_waits);
+
+    cache.RemoveReader();
+    cache.RemoveReader();
+    CHECK(!cache.HasReaders());
+}
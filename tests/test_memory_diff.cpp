@@ -0,0 +1,73 @@
+#include "common.h"
+
+#include <vector>
+
+#include "memory_diff.h"
+
+namespace
+{
+    std::vector<dbg_mi::MemorySpan> Diff(std::vector<uint8_t> const & before, std::vector<uint8_t> const & after)
+    {
+        std::vector<dbg_mi::MemorySpan> spans;
+        dbg_mi::FindChangedSpans(before.data(), after.data(), before.size(), spans);
+        return spans;
+    }
+}
+
+TEST(MemoryDiff_NoChange)
+{
+    std::vector<uint8_t> const memory(100, 0x5a);
+    CHECK(Diff(memory, memory).empty());
+    CHECK(Diff(std::vector<uint8_t>(), std::vector<uint8_t>()).empty());
+}
+
+TEST(MemoryDiff_Spans)
+{
+    std::vector<uint8_t> before(100);
+
+    for (size_t i = 0; i < before.size(); ++i)
+    {
+        before[i] = static_cast<uint8_t>(i);
+    }
+
+    // Changes in the middle of a block, across a block border and in the scalar tail
+    std::vector<uint8_t> after(before);
+    after[3] = 0xff;
+    after[15] = 0xff;
+    after[16] = 0xff;
+    after[17] = 0xff;
+    after[99] = 0xff;
+
+    std::vector<dbg_mi::MemorySpan> const spans = Diff(before, after);
+    CHECK_EQUAL(3, int(spans.size()));
+    CHECK_EQUAL(3ULL, spans[0].start);
+    CHECK_EQUAL(4ULL, spans[0].end);
+    CHECK_EQUAL(15ULL, spans[1].start);
+    CHECK_EQUAL(18ULL, spans[1].end);
+    CHECK_EQUAL(99ULL, spans[2].start);
+    CHECK_EQUAL(100ULL, spans[2].end);
+}
+
+TEST(MemoryDiff_Snapshot)
+{
+    dbg_mi::MemorySnapshot snapshot;
+    std::vector<dbg_mi::MemorySpan> changed;
+    std::vector<uint8_t> memory(64, 1);
+
+    CHECK(!snapshot.Update(0x1000, memory, changed));
+    CHECK(snapshot.Update(0x1000, memory, changed));
+    CHECK(changed.empty());
+
+    memory[40] = 2;
+    CHECK(snapshot.Update(0x1000, memory, changed));
+    CHECK_EQUAL(1, int(changed.size()));
+    CHECK_EQUAL(40ULL, changed[0].start);
+
+    // Another range is new memory, not a change
+    changed.clear();
+    CHECK(!snapshot.Update(0x2000, memory, changed));
+    CHECK(changed.empty());
+
+    snapshot.Clear();
+    CHECK(!snapshot.Update(0x2000, memory, changed));
+}
@@ -0,0 +1,87 @@
+#include "common.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "memory_dump.h"
+
+namespace
+{
+    std::string DumpPath()
+    {
+        return "test_memory_dump.bin";
+    }
+
+    dbg_mi::MemoryDump MakeDump(std::string const & path, uint64_t address, uint64_t size, unsigned long epoch)
+    {
+        dbg_mi::MemoryDump dump;
+        dump.path = path;
+        dump.address = address;
+        dump.size = size;
+        dump.epoch = epoch;
+        return dump;
+    }
+}
+
+TEST(MemoryDump_Find)
+{
+    dbg_mi::MemoryDumpRegistry registry;
+    registry.Add(MakeDump("a.bin", 0x1000, 0x1000, 1));
+    registry.Add(MakeDump("b.bin", 0x1800, 0x100, 2));
+
+    CHECK(registry.Find(0x1000, 0x1000, 1) != nullptr);
+    CHECK(registry.Find(0x1ff0, 0x10, 1) != nullptr);
+    CHECK(registry.Find(0x1ff0, 0x11, 1) == nullptr);
+    CHECK(registry.Find(0x0ff0, 0x10, 1) == nullptr);
+    CHECK(registry.Find(0x1800, 0x10, 3) == nullptr);
+    CHECK_EQUAL("b.bin", registry.Find(0x1800, 0x10, 2)->path);
+
+    // A new dump to the same file replaces the old one
+    registry.Add(MakeDump("a.bin", 0x8000, 0x10, 2));
+    CHECK_EQUAL(2u, registry.GetDumps().size());
+    CHECK(registry.Find(0x1000, 0x10, 1) == nullptr);
+    CHECK(registry.Find(0x8000, 0x10, 2) != nullptr);
+}
+
+TEST(MemoryDump_UnreadableNotServed)
+{
+    dbg_mi::MemoryDump dump = MakeDump("holes.bin", 0x1000, 0x1000, 1);
+    dump.unreadable.push_back({0x1400, 0x1500});
+
+    dbg_mi::MemoryDumpRegistry registry;
+    registry.Add(dump);
+    CHECK_EQUAL(0x100ULL, dbg_mi::MemoryDumpRegistry::GetUnreadableBytes(registry.GetDumps()[0]));
+
+    CHECK(registry.Find(0x1000, 0x400, 1) != nullptr);
+    CHECK(registry.Find(0x1500, 0x100, 1) != nullptr);
+    CHECK(registry.Find(0x1000, 0x401, 1) == nullptr);
+    CHECK(registry.Find(0x14ff, 0x10, 1) == nullptr);
+    CHECK(registry.Find(0x1420, 0x10, 1) == nullptr);
+    CHECK(registry.Find(0x1000, 0x1000, 1) == nullptr);
+}
+
+TEST(MemoryDump_Read)
+{
+    std::string error;
+    {
+        dbg_mi::MappedFile file;
+        CHECK(file.Open(DumpPath(), dbg_mi::MappedFile::CreateReadWrite, 256, error));
+
+        for (int i = 0; i < 256; ++i)
+        {
+            file.GetData()[i] = static_cast<uint8_t>(255 - i);
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+    dbg_mi::MemoryDump const dump = MakeDump(DumpPath(), 0x4000, 256, 1);
+    CHECK(dbg_mi::MemoryDumpRegistry::Read(dump, 0x4010, 4, bytes, error));
+    CHECK_EQUAL(4u, bytes.size());
+    CHECK_EQUAL(255 - 0x10, bytes[0]);
+    CHECK_EQUAL(255 - 0x13, bytes[3]);
+    CHECK(!dbg_mi::MemoryDumpRegistry::Read(dump, 0x40ff, 2, bytes, error));
+    CHECK(!dbg_mi::MemoryDumpRegistry::Read(MakeDump(DumpPath(), 0x4000, 512, 1), 0x4000, 2, bytes, error));
+    std::remove(DumpPath().c_str());
+}
@@ -0,0 +1,90 @@
+#include "common.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "mi_recorder.h"
+
+namespace
+{
+    std::string RecordingPath()
+    {
+        return "test_mi_recorder.bin";
+    }
+
+    void RecordString(dbg_mi::MIRecorder & recorder, dbg_mi::MIRecorder::RecordKind kind, int action, int command, std::string const & text)
+    {
+        recorder.Record(kind, action, command, text.data(), text.size());
+    }
+}
+
+TEST(MIRecorder_RoundTripText)
+{
+    std::string error;
+    dbg_mi::MIRecorder recorder;
+    CHECK(recorder.Open(RecordingPath(), 0, error));
+    RecordString(recorder, dbg_mi::MIRecorder::KindSend, 3, 1, "-stack-info-frame");
+    RecordString(recorder, dbg_mi::MIRecorder::KindReceive, 3, 1, "30000000001^done,frame={level=\"0\"}");
+    CHECK_EQUAL(2u, recorder.GetRecordCount());
+    recorder.Close();
+
+    std::ostringstream out;
+    CHECK(dbg_mi::MIRecorder::Dump(RecordingPath(), dbg_mi::MIRecorder::DumpText, out, error));
+    std::string const text = out.str();
+    CHECK(text.find(">>      3:1      -stack-info-frame\n") != std::string::npos);
+    CHECK(text.find("<<      3:1      30000000001^done,frame={level=\"0\"}\n") != std::string::npos);
+}
+
+TEST(MIRecorder_JSONEscaping)
+{
+    std::string error;
+    dbg_mi::MIRecorder recorder;
+    CHECK(recorder.Open(RecordingPath(), 0, error));
+    RecordString(recorder, dbg_mi::MIRecorder::KindReceive, -1, -1, "~\"a\\tb\"\n");
+    recorder.Close();
+
+    std::ostringstream out;
+    CHECK(dbg_mi::MIRecorder::Dump(RecordingPath(), dbg_mi::MIRecorder::DumpJSON, out, error));
+    CHECK(out.str().find("\"data\":\"~\\\"a\\\\tb\\\"\\n\"") != std::string::npos);
+}
+
+TEST(MIRecorder_WrapKeepsNewestRecords)
+{
+    std::string error;
+    dbg_mi::MIRecorder recorder;
+    CHECK(recorder.Open(RecordingPath(), 64 * 1024, error));
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        RecordString(recorder, dbg_mi::MIRecorder::KindSend, i, 0, "-var-update 1 * " + std::to_string(i));
+    }
+
+    CHECK(recorder.GetBytesWritten() > 64 * 1024);
+    recorder.Close();
+
+    std::ostringstream out;
+    CHECK(dbg_mi::MIRecorder::Dump(RecordingPath(), dbg_mi::MIRecorder::DumpText, out, error));
+    std::string const text = out.str();
+    CHECK(text.find("-var-update 1 * 9999\n") != std::string::npos);
+    CHECK(text.find("-var-update 1 * 10\n") == std::string::npos);
+}
+
+TEST(MIRecorder_DestructorDeletesTheRecording)
+{
+    std::string error;
+    {
+        dbg_mi::MIRecorder recorder;
+        CHECK(recorder.Open(RecordingPath(), 0, error));
+        recorder.Close();
+        std::FILE * file = std::fopen(RecordingPath().c_str(), "rb");
+        CHECK(file != nullptr);
+
+        if (file)
+        {
+            std::fclose(file);
+        }
+    }
+
+    CHECK(std::fopen(RecordingPath().c_str(), "rb") == nullptr);
+}
@@ -0,0 +1,83 @@
+#include "common.h"
+
+#include <string>
+#include <vector>
+
+#include "register_cache.h"
+
+namespace
+{
+    std::vector<std::string> Names()
+    {
+        std::vector<std::string> names;
+        names.push_back("rax");
+        names.push_back("rbx");
+        names.push_back("");
+        names.push_back("xmm0");
+        names.push_back("v0");
+        return names;
+    }
+}
+
+TEST(RegisterCache_VectorNames)
+{
+    CHECK(dbg_mi::IsVectorRegisterName("xmm15"));
+    CHECK(dbg_mi::IsVectorRegisterName("ymm0"));
+    CHECK(dbg_mi::IsVectorRegisterName("zmm31"));
+    CHECK(!dbg_mi::IsVectorRegisterName("xmm"));
+    CHECK(!dbg_mi::IsVectorRegisterName("rax"));
+    CHECK(!dbg_mi::IsVectorRegisterName("v0"));
+    CHECK(!dbg_mi::IsVectorRegisterName("mxcsr"));
+}
+
+TEST(RegisterCache_StaleRegisters)
+{
+    dbg_mi::RegisterCache cache;
+    CHECK(!cache.HasNames());
+    cache.SetNames(Names());
+    CHECK(cache.HasNames());
+    CHECK_EQUAL(5, int(cache.GetCount()));
+    CHECK(cache.IsVector(3));
+
+    // Numbers without a name are never read, vector registers only on demand
+    std::vector<size_t> stale;
+    cache.GetStale(false, stale);
+    CHECK_EQUAL(3, int(stale.size()));
+    CHECK_EQUAL(0, int(stale[0]));
+    CHECK_EQUAL(1, int(stale[1]));
+    CHECK_EQUAL(4, int(stale[2]));
+
+    cache.GetStale(true, stale);
+    CHECK_EQUAL(4, int(stale.size()));
+
+    CHECK(!cache.SetValue(2, "0x0"));
+    CHECK(!cache.SetValue(7, "0x0"));
+    CHECK(cache.SetValue(0, "0x1"));
+    CHECK(cache.SetValue(1, "0x2"));
+    CHECK(cache.SetValue(4, "{u = {0x0, 0x0}}"));
+    CHECK(cache.IsVector(4));
+    CHECK_EQUAL(3ul, cache.GetReads());
+
+    cache.GetStale(false, stale);
+    CHECK(stale.empty());
+
+    std::vector<size_t> changed;
+    changed.push_back(1);
+    changed.push_back(4);
+    changed.push_back(99);
+    cache.Invalidate(changed);
+    CHECK(cache.HasValue(0));
+    CHECK(!cache.HasValue(1));
+    CHECK_EQUAL("0x1", cache.GetValue(0));
+
+    cache.GetStale(false, stale);
+    CHECK_EQUAL(1, int(stale.size()));
+    CHECK_EQUAL(1, int(stale[0]));
+
+    cache.Invalidate();
+    cache.GetStale(false, stale);
+    CHECK_EQUAL(2, int(stale.size()));
+
+    cache.Clear();
+    CHECK(!cache.HasNames());
+}
@@ -0,0 +1,45 @@
+#include "common.h"
+
+#include <sstream>
+#include <string>
+#include <typeinfo>
+
+#include "span_tracer.h"
+
+namespace
+{
+    struct TracedAction {};
+}
+
+TEST(SpanTracer_ExportsCompleteEvents)
+{
+    dbg_mi::SpanTracer::Clear();
+    {
+        dbg_mi::TraceSpan outer("DispatchResults");
+        {
+            dbg_mi::TraceSpan inner("OnCommandOutput", 4, 2, typeid(TracedAction).name());
+        }
+    }
+
+    CHECK_EQUAL(2u, dbg_mi::SpanTracer::GetCount());
+
+    std::ostringstream out;
+    dbg_mi::SpanTracer::ExportChromeTrace(out);
+    std::string const json = out.str();
+    CHECK(json.find("\"traceEvents\":[") != std::string::npos);
+    CHECK(json.find("{\"name\":\"DispatchResults\",\"cat\":\"gdbmi\",\"ph\":\"X\"") != std::string::npos);
+    CHECK(json.find("TracedAction::OnCommandOutput") != std::string::npos);
+    CHECK(json.find("\"args\":{\"action\":4,\"command\":2}") != std::string::npos);
+    dbg_mi::SpanTracer::Clear();
+}
+
+TEST(SpanTracer_Disabled)
+{
+    dbg_mi::SpanTracer::Clear();
+    dbg_mi::SpanTracer::SetEnabled(false);
+    {
+        dbg_mi::TraceSpan span("ParseOutput");
+    }
+    dbg_mi::SpanTracer::SetEnabled(true);
+    CHECK_EQUAL(0u, dbg_mi::SpanTracer::GetCount());
+}
@@ -0,0 +1,87 @@
+#include "common.h"
+
+#include <typeinfo>
+
+#include "stall_watchdog.h"
+
+namespace
+{
+    struct SlowAction {};
+
+    dbg_mi::StallWatchdog::Attribution Output(int32_t action, uint64_t elapsed_ms)
+    {
+        dbg_mi::StallWatchdog::Attribution attribution;
+        attribution.type_name = typeid(SlowAction).name();
+        attribution.action = action;
+        attribution.command = 1;
+        attribution.reply_size = 100;
+        attribution.elapsed_ns = elapsed_ms * 1000000ULL;
+        return attribution;
+    }
+}
+
+TEST(StallWatchdog_Threshold)
+{
+    dbg_mi::StallWatchdog::SetThresholdMs(20);
+    CHECK_EQUAL(20, dbg_mi::StallWatchdog::GetThresholdMs());
+
+    // Nonsense values fall back to the default
+    dbg_mi::StallWatchdog::SetThresholdMs(0);
+    CHECK_EQUAL(long(dbg_mi::StallWatchdog::DefaultThresholdMs), dbg_mi::StallWatchdog::GetThresholdMs());
+    dbg_mi::StallWatchdog::SetThresholdMs(-5);
+    CHECK_EQUAL(long(dbg_mi::StallWatchdog::DefaultThresholdMs), dbg_mi::StallWatchdog::GetThresholdMs());
+}
+
+TEST(StallWatchdog_CountsStalls)
+{
+    dbg_mi::StallWatchdog::Reset();
+    dbg_mi::StallWatchdog::SetThresholdMs(10);
+
+    dbg_mi::StallWatchdog::Attribution none;
+    dbg_mi::StallWatchdog::Report(dbg_mi::StallWatchdog::EntryOnIdle, 5 * 1000000ULL, none, nullptr);
+    CHECK_EQUAL(1u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnIdle));
+    CHECK_EQUAL(0u, dbg_mi::StallWatchdog::GetStalls(dbg_mi::StallWatchdog::EntryOnIdle));
+
+    dbg_mi::StallWatchdog::Report(dbg_mi::StallWatchdog::EntryOnIdle, 15 * 1000000ULL, none, nullptr);
+    CHECK_EQUAL(2u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnIdle));
+    CHECK_EQUAL(1u, dbg_mi::StallWatchdog::GetStalls(dbg_mi::StallWatchdog::EntryOnIdle));
+    CHECK_EQUAL(0u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnTimer));
+
+    dbg_mi::StallWatchdog::Reset();
+    CHECK_EQUAL(0u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnIdle));
+    dbg_mi::StallWatchdog::SetThresholdMs(dbg_mi::StallWatchdog::DefaultThresholdMs);
+}
+
+TEST(StallWatchdog_AttributesSlowestOutput)
+{
+    dbg_mi::StallWatchdog::Reset();
+    {
+        dbg_mi::StallScope outer(dbg_mi::StallWatchdog::EntryOnTimer, nullptr);
+        CHECK_EQUAL(-1, dbg_mi::StallWatchdog::GetSlowest().action);
+
+        dbg_mi::StallWatchdog::NoteCommandOutput(Output(3, 2));
+        dbg_mi::StallWatchdog::NoteCommandOutput(Output(4, 30));
+        dbg_mi::StallWatchdog::NoteCommandOutput(Output(5, 1));
+        CHECK_EQUAL(4, dbg_mi::StallWatchdog::GetSlowest().action);
+        CHECK_EQUAL(100u, dbg_mi::StallWatchdog::GetSlowest().reply_size);
+
+        {
+            // A command output measured by its own scope counts for its own entry point
+            dbg_mi::StallScope inner(dbg_mi::StallWatchdog::EntryOnCommandOutput, nullptr);
+            inner.Attribute(typeid(SlowAction).name(), 6, 2, 10);
+        }
+
+        CHECK_EQUAL(1u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnCommandOutput));
+        CHECK_EQUAL(0u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnTimer));
+    }
+
+    CHECK_EQUAL(1u, dbg_mi::StallWatchdog::GetCalls(dbg_mi::StallWatchdog::EntryOnTimer));
+
+    // The next outermost entry point starts without attribution
+    {
+        dbg_mi::StallScope next(dbg_mi::StallWatchdog::EntryOnIdle, nullptr);
+        CHECK_EQUAL(-1, dbg_mi::StallWatchdog::GetSlowest().action);
+    }
+
+    dbg_mi::StallWatchdog::Reset();
+}
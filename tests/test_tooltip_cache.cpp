@@ -0,0 +1,62 @@
+#include "common.h"
+
+#include "tooltip_cache.h"
+
+namespace
+{
+    cb::shared_ptr<dbg_mi::GDBWatch> MakeTooltipWatch(wxString const & symbol, wxString const & id)
+    {
+        cb::shared_ptr<dbg_mi::GDBWatch> w(new dbg_mi::GDBWatch(nullptr, nullptr, symbol, true));
+        w->SetID(id);
+        return w;
+    }
+}
+
+TEST(TooltipCache_HitSameFrameAndEpoch)
+{
+    dbg_mi::TooltipCache cache;
+    cb::shared_ptr<dbg_mi::GDBWatch> w = MakeTooltipWatch("argc", "var1");
+    cache.Add("argc", 1, 0, cache.GetEpoch(), w);
+
+    CHECK(cache.Find("argc", 1, 0) == w);
+    CHECK(!cache.Find("argc", 1, 1));
+    CHECK(!cache.Find("argc", 2, 0));
+    CHECK(!cache.Find("argv", 1, 0));
+    CHECK_EQUAL(1u, cache.GetHits());
+    CHECK_EQUAL(3u, cache.GetMisses());
+}
+
+TEST(TooltipCache_NewEpochReturnsStale)
+{
+    dbg_mi::TooltipCache cache;
+    unsigned const epoch = cache.GetEpoch();
+    cb::shared_ptr<dbg_mi::GDBWatch> w1 = MakeTooltipWatch("argc", "var1");
+    cache.Add("argc", 1, 0, epoch, w1);
+
+    std::vector<cb::shared_ptr<dbg_mi::GDBWatch>> stale;
+    cache.NewEpoch(stale);
+
+    CHECK_EQUAL(1u, stale.size());
+    CHECK(!cache.Find("argc", 1, 0));
+    CHECK(!cache.Contains(w1));
+
+    // evaluated for the previous stop, not cached but still needs its var-object deleted
+    cb::shared_ptr<dbg_mi::GDBWatch> w2 = MakeTooltipWatch("argv", "var2");
+    cache.Add("argv", 1, 0, epoch, w2);
+    CHECK(!cache.Find("argv", 1, 0));
+
+    stale.clear();
+    cache.NewEpoch(stale);
+    CHECK_EQUAL(1u, stale.size());
+    CHECK(stale[0] == w2);
+}
+
+TEST(TooltipCache_LatestRequestOnly)
+{
+    dbg_mi::TooltipCache cache;
+    int const first = cache.NextRequest();
+    int const second = cache.NextRequest();
+
+    CHECK(!cache.IsLatestRequest(first));
+    CHECK(cache.IsLatestRequest(second));
+}
@@ -0,0 +1,105 @@
+#include "common.h"
+
+#include <string>
+
+#include "definitions.h"
+#include "value_format.h"
+
+namespace
+{
+    std::string Format(std::string const & raw, std::string const & type, dbg_mi::value_format::Format format)
+    {
+        dbg_mi::value_format::TypeInfo info;
+
+        if (!dbg_mi::value_format::ClassifyType(type, info))
+        {
+            return "<unknown type>";
+        }
+
+        std::string out;
+        return dbg_mi::value_format::FormatValue(raw, info, format, out) ? out : raw;
+    }
+}
+
+TEST(ValueFormat_ClassifyType)
+{
+    dbg_mi::value_format::TypeInfo info;
+    CHECK(dbg_mi::value_format::ClassifyType("unsigned char", info));
+    CHECK_EQUAL(1, info.size);
+    CHECK(!info.is_signed);
+    CHECK(dbg_mi::value_format::ClassifyType("const short int", info));
+    CHECK_EQUAL(2, info.size);
+    CHECK(info.is_signed);
+    CHECK(dbg_mi::value_format::ClassifyType("long long unsigned int", info));
+    CHECK_EQUAL(8, info.size);
+    CHECK(!info.is_signed);
+    CHECK(dbg_mi::value_format::ClassifyType("uint16_t", info));
+    CHECK_EQUAL(2, info.size);
+    CHECK(dbg_mi::value_format::ClassifyType("float", info));
+    CHECK(info.is_float);
+    CHECK_EQUAL(4, info.size);
+
+    CHECK(!dbg_mi::value_format::ClassifyType("int *", info));
+    CHECK(!dbg_mi::value_format::ClassifyType("std::string", info));
+    CHECK(!dbg_mi::value_format::ClassifyType("struct point", info));
+}
+
+TEST(ValueFormat_Integers)
+{
+    CHECK_EQUAL("0xffffffff", Format("-1", "int", dbg_mi::value_format::Hex));
+    CHECK_EQUAL("4294967295", Format("-1", "int", dbg_mi::value_format::Unsigned));
+    CHECK_EQUAL("-1", Format("255", "unsigned char", dbg_mi::value_format::Decimal));
+    CHECK_EQUAL("101", Format("5", "unsigned int", dbg_mi::value_format::Binary));
+    CHECK_EQUAL("0", Format("0", "int", dbg_mi::value_format::Binary));
+    CHECK_EQUAL("0x1", Format("true", "bool", dbg_mi::value_format::Hex));
+    CHECK_EQUAL("-12", Format("-12", "long long", dbg_mi::value_format::Decimal));
+    CHECK_EQUAL("42", Format("42", "int", dbg_mi::value_format::Natural));
+}
+
+TEST(ValueFormat_Chars)
+{
+    CHECK_EQUAL("0x61", Format("97 'a'", "char", dbg_mi::value_format::Hex));
+    CHECK_EQUAL("97 'a'", Format("97", "int", dbg_mi::value_format::Char));
+    CHECK_EQUAL("10 '\\n'", Format("10", "int", dbg_mi::value_format::Char));
+    CHECK_EQUAL("0 '\\000'", Format("0", "int", dbg_mi::value_format::Char));
+    CHECK_EQUAL("-1 '\\377'", Format("255", "unsigned char", dbg_mi::value_format::Char));
+}
+
+TEST(ValueFormat_Floats)
+{
+    CHECK_EQUAL("0x3f800000", Format("1", "float", dbg_mi::value_format::Hex));
+    CHECK_EQUAL("1", Format("1065353216", "int", dbg_mi::value_format::Float));
+    CHECK_EQUAL("1.5", Format("1.5", "double", dbg_mi::value_format::Float));
+    CHECK_EQUAL("0x3ff8000000000000", Format("1.5", "double", dbg_mi::value_format::Hex));
+}
+
+TEST(ValueFormat_NotScalar)
+{
+    CHECK_EQUAL("{x = 1, y = 2}", Format("{x = 1, y = 2}", "int", dbg_mi::value_format::Hex));
+    CHECK_EQUAL("<optimized out>", Format("<optimized out>", "int", dbg_mi::value_format::Hex));
+    CHECK_EQUAL("12abc", Format("12abc", "int", dbg_mi::value_format::Hex));
+}
+
+TEST(ValueFormat_WatchKeepsTheClassifiedType)
+{
+    dbg_mi::GDBWatch watch(nullptr, nullptr, wxT("i"), false);
+    watch.SetValue(wxT("-1"));
+    watch.SetFormat(dbg_mi::GDBWatch::WatchFormat::Hex);
+    wxString value;
+
+    // No type yet, shown as GDB reported it
+    watch.GetValue(value);
+    CHECK_EQUAL(wxString(wxT("-1")), value);
+
+    watch.SetType(wxT("int"));
+    watch.GetValue(value);
+    CHECK_EQUAL(wxString(wxT("0xffffffff")), value);
+
+    watch.SetType(wxT("short"));
+    watch.GetValue(value);
+    CHECK_EQUAL(wxString(wxT("0xffff")), value);
+
+    watch.SetType(wxT("struct point"));
+    watch.GetValue(value);
+    CHECK_EQUAL(wxString(wxT("-1")), value);
+}
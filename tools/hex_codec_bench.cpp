@@ -0,0 +1,115 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// Measures the hex codec used for the GDB memory commands against the old per byte handling.
+//
+// usage: hex_codec_bench [megabytes]
+
+// System and library includes
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// GDB includes
+#include "hex_codec.h"
+
+namespace
+{
+    const int Repeats = 5;
+
+    /** The previous decoding: one substring and one number conversion per byte, like Mid() + ToULong(). */
+    bool DecodePerByte(std::string const & hex, std::vector<uint8_t> & bytes)
+    {
+        for (size_t i = 0; i + 1 < hex.length(); i += 2)
+        {
+            std::string const byte = hex.substr(i, 2);
+            char * end = nullptr;
+            unsigned long value = std::strtoul(byte.c_str(), &end, 16);
+
+            if (*end != '\0')
+            {
+                return false;
+            }
+
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+
+        return true;
+    }
+
+    template <typename Function>
+    double BestSeconds(Function function)
+    {
+        double best = 1e30;
+
+        for (int repeat = 0; repeat < Repeats; ++repeat)
+        {
+            std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+            function();
+            double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = (seconds < best) ? seconds : best;
+        }
+
+        return best;
+    }
+
+    void Report(char const * name, size_t bytes, double seconds)
+    {
+        std::printf("%-24s %10.3f ms %10.1f MB/s\n", name, seconds * 1e3, static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    size_t const megabytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 16;
+    size_t const size = megabytes * 1024 * 1024;
+    std::vector<uint8_t> data(size);
+    uint32_t seed = 1;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    std::string hex;
+    dbg_mi::hex_codec::Encode(data.data(), data.size(), hex);
+    std::printf("%zu MB of memory, %zu hex characters, best of %d runs, CPU supports %s\n\n",
+                megabytes, hex.size(), Repeats, dbg_mi::hex_codec::GetImplementationName(dbg_mi::hex_codec::GetBestImplementation()));
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve(size);
+    Report("decode per byte", size, BestSeconds([&]() { bytes.clear(); DecodePerByte(hex, bytes); }));
+
+    for (int impl = dbg_mi::hex_codec::Scalar; impl <= dbg_mi::hex_codec::GetBestImplementation(); ++impl)
+    {
+        std::string const name = std::string("decode ") + dbg_mi::hex_codec::GetImplementationName(dbg_mi::hex_codec::Implementation(impl));
+        Report(name.c_str(), size, BestSeconds([&]() { bytes.clear(); dbg_mi::hex_codec::Decode(hex.data(), hex.size(), bytes, dbg_mi::hex_codec::Implementation(impl)); }));
+
+        if (bytes != data)
+        {
+            std::printf("%s produced wrong bytes\n", name.c_str());
+            return 1;
+        }
+    }
+
+    std::string encoded;
+    encoded.reserve(hex.size());
+
+    // Encoding has no AVX2 path, it is bound by the stores already with SSE2
+    int const bestEncode = (dbg_mi::hex_codec::GetBestImplementation() < dbg_mi::hex_codec::SSE2) ? dbg_mi::hex_codec::GetBestImplementation() : dbg_mi::hex_codec::SSE2;
+
+    for (int impl = dbg_mi::hex_codec::Scalar; impl <= bestEncode; ++impl)
+    {
+        std::string const name = std::string("encode ") + dbg_mi::hex_codec::GetImplementationName(dbg_mi::hex_codec::Implementation(impl));
+        Report(name.c_str(), size, BestSeconds([&]() { encoded.clear(); dbg_mi::hex_codec::Encode(data.data(), data.size(), encoded, dbg_mi::hex_codec::Implementation(impl)); }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU General Public License, version 3
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ *
+*/
+
+// Converts a binary MI traffic recording written by the GDB/MI plugin into text or JSON.
+//
+// usage: mi_recorder_dump [--json] <recording> [output]
+
+// System and library includes
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// GDB includes
+#include "mi_recorder.h"
+
+int main(int argc, char * argv[])
+{
+    dbg_mi::MIRecorder::DumpFormat format = dbg_mi::MIRecorder::DumpText;
+    int arg = 1;
+
+    if (arg < argc && std::strcmp(argv[arg], "--json") == 0)
+    {
+        format = dbg_mi::MIRecorder::DumpJSON;
+        ++arg;
+    }
+
+    if (arg >= argc || argc - arg > 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [--json] <recording> [output]\n";
+        return 1;
+    }
+
+    std::string error;
+    bool ok;
+
+    if (argc - arg == 2)
+    {
+        std::ofstream out(argv[arg + 1], std::ios::out | std::ios::binary);
+
+        if (!out)
+        {
+            std::cerr << "cannot create " << argv[arg + 1] << "\n";
+            return 1;
+        }
+
+        ok = dbg_mi::MIRecorder::Dump(argv[arg], format, out, error);
+    }
+    else
+    {
+        ok = dbg_mi::MIRecorder::Dump(argv[arg], format, std::cout, error);
+    }
+
+    if (!ok)
+    {
+        std::cerr << argv[arg] << ": " << error << "\n";
+        return 2;
+    }
+
+    return 0;
+}